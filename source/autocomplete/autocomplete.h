@@ -29,6 +29,8 @@ www.navitia.io
 */
 
 #pragma once
+#include "autocomplete/intersection.h"
+#include "autocomplete/token_index.h"
 #include "type/type_interfaces.h"
 #include "type/geographical_coord.h"
 #include "type/fwd_type.h"
@@ -40,6 +42,7 @@ www.navitia.io
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/utility.hpp>
 #include <boost/serialization/map.hpp>
+#include <boost/serialization/set.hpp>
 
 #include <algorithm>
 #include <boost/regex.hpp>
@@ -103,19 +106,16 @@ struct Autocomplete {
     /// Type of object
     navitia::type::Type_e object_type;
 
-    /// Structure temporaire pour construire l'indexe
-    std::map<std::string, std::set<T>> temp_word_map;
+    /// Structure temporaire pour construire l'indexe, les éléments de chaque mot sont triés au build
+    std::unordered_map<std::string, std::vector<T>> temp_word_map;
 
-    /// À chaque mot (par exemple "rue" ou "jaures") on associe un tableau de T qui contient la liste des éléments
-    /// contenant ce mot
-    using vec_elt = std::pair<std::string, std::vector<T>>;
-
-    /// Structure principale de notre indexe
-    std::vector<vec_elt> word_dictionnary;
+    /// Structure principale de notre indexe : à chaque mot (par exemple "rue" ou "jaures") on associe la liste des
+    /// éléments contenant ce mot
+    TokenIndex<T> word_dictionnary;
 
     /// Structure temporaire pour garder les patterns et leurs indexs
-    std::map<std::string, std::set<T>> temp_pattern_map;
-    std::vector<vec_elt> pattern_dictionnary;
+    std::unordered_map<std::string, std::vector<T>> temp_pattern_map;
+    TokenIndex<T> pattern_dictionnary;
 
     /// Structure pour garder les informations comme nombre des mots, la distance des mots...dans chaque Autocomplete
     /// (Position)
@@ -124,9 +124,15 @@ struct Autocomplete {
     // for each T, we store the originaly indexed string (for better score handling)
     std::map<T, std::string> indexed_string;
 
+    // when the index has been built by update(), the ghostwords and synonyms its strings have been tokenized with
+    bool updatable = false;
+    std::set<std::string> indexed_ghostwords;
+    autocomplete_map indexed_synonyms;
+
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
-        ar& word_dictionnary& word_quality_list& pattern_dictionnary& object_type& indexed_string;
+        ar& word_dictionnary& word_quality_list& pattern_dictionnary& object_type& indexed_string& updatable&
+            indexed_ghostwords& indexed_synonyms;
     }
 
     /// Efface les structures de données sérialisées
@@ -137,6 +143,9 @@ struct Autocomplete {
         pattern_dictionnary.clear();
         word_quality_list.clear();
         indexed_string.clear();
+        updatable = false;
+        indexed_ghostwords.clear();
+        indexed_synonyms.clear();
     }
 
     // Méthodes permettant de construire l'indexe
@@ -160,7 +169,7 @@ struct Autocomplete {
         int count = vec_word.size();
         auto vec = vec_word.begin();
         while (vec != vec_word.end()) {
-            temp_word_map[*vec].insert(position);
+            temp_word_map[*vec].push_back(position);
             distance += (*vec).size();
             ++vec;
         }
@@ -176,7 +185,7 @@ struct Autocomplete {
         std::vector<std::string> vec_patt = make_vec_pattern(vec_words, 2);
         auto v_patt = vec_patt.begin();
         while (v_patt != vec_patt.end()) {
-            temp_pattern_map[*v_patt].insert(position);
+            temp_pattern_map[*v_patt].push_back(position);
             ++v_patt;
         }
     }
@@ -203,90 +212,153 @@ struct Autocomplete {
     /** Construit la structure finale
      *
      * Les map et les set sont bien pratiques, mais leurs performances sont mauvaises avec des petites données (comme
-     * des ints)
+     * des ints). Les structures temporaires sont vidées une fois l'indexe construit.
      */
     void build() {
-        word_dictionnary.reserve(temp_word_map.size());
-        for (auto key_val : temp_word_map) {
-            word_dictionnary.push_back(
-                std::make_pair(key_val.first, std::vector<T>(key_val.second.begin(), key_val.second.end())));
-        }
+        word_dictionnary.build(sorted_tokens(temp_word_map));
 
         // Dictionnaire des patterns:
-        pattern_dictionnary.reserve((temp_pattern_map.size()));
-        for (auto key_val : temp_pattern_map) {
-            pattern_dictionnary.push_back(
-                std::make_pair(key_val.first, std::vector<T>(key_val.second.begin(), key_val.second.end())));
+        pattern_dictionnary.build(sorted_tokens(temp_pattern_map));
+    }
+
+    /** Index the string of each element, like clear(), add_string() for each one and build()
+     *
+     * When the index has been built by update() with the same ghostwords and synonyms, only the elements
+     * whose string is new or has changed are tokenized and merged into the index, the elements indexed but
+     * not given anymore being removed from it. Otherwise the tokens of any element may change: it is rebuilt.
+     */
+    void update(const std::vector<std::pair<T, std::string>>& strings,
+                const std::set<std::string>& ghostwords,
+                const autocomplete_map& synonyms) {
+        if (!updatable || ghostwords != indexed_ghostwords || synonyms != indexed_synonyms) {
+            clear();
+            for (const auto& position_string : strings) {
+                add_string(position_string.second, position_string.first, ghostwords, synonyms);
+            }
+            build();
+            updatable = true;
+            indexed_ghostwords = ghostwords;
+            indexed_synonyms = synonyms;
+            return;
+        }
+
+        std::vector<T> positions;
+        std::vector<T> removed;
+        std::vector<const std::pair<T, std::string>*> added;
+        for (const auto& position_string : strings) {
+            positions.push_back(position_string.first);
+            const auto it = indexed_string.find(position_string.first);
+            if (it != indexed_string.end() && it->second == strip_accents_and_lower(position_string.second)) {
+                continue;
+            }
+            if (it != indexed_string.end()) {
+                removed.push_back(position_string.first);
+            }
+            added.push_back(&position_string);
+        }
+        std::sort(positions.begin(), positions.end());
+        for (const auto& position_string : indexed_string) {
+            if (!std::binary_search(positions.begin(), positions.end(), position_string.first)) {
+                removed.push_back(position_string.first);
+            }
+        }
+        if (removed.empty() && added.empty()) {
+            return;
+        }
+        std::sort(removed.begin(), removed.end());
+        for (const auto position : removed) {
+            word_quality_list.erase(position);
+            indexed_string.erase(position);
+        }
+
+        temp_word_map.clear();
+        temp_pattern_map.clear();
+        for (const auto* position_string : added) {
+            add_string(position_string->second, position_string->first, ghostwords, synonyms);
+        }
+        word_dictionnary = word_dictionnary.merge(sorted_tokens(temp_word_map), removed);
+        pattern_dictionnary = pattern_dictionnary.merge(sorted_tokens(temp_pattern_map), removed);
+    }
+
+    /// The tokens of a temporary map sorted, with their elements sorted without duplicates. The map is emptied.
+    static std::vector<std::pair<std::string, std::vector<T>>> sorted_tokens(
+        std::unordered_map<std::string, std::vector<T>>& temp_map) {
+        std::vector<std::pair<std::string, std::vector<T>>> tokens;
+        tokens.reserve(temp_map.size());
+        for (auto& token_elements : temp_map) {
+            auto& elements = token_elements.second;
+            std::sort(elements.begin(), elements.end());
+            elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+            tokens.emplace_back(token_elements.first, std::move(elements));
         }
+        temp_map.clear();
+        std::sort(tokens.begin(), tokens.end(),
+                  [](const std::pair<std::string, std::vector<T>>& a, const std::pair<std::string, std::vector<T>>& b) {
+                      return a.first < b.first;
+                  });
+        return tokens;
     }
 
     // Méthode pour calculer le score de chaque élément par son admin.
     void compute_score(type::PT_Data& pt_data, georef::GeoRef& georef, const type::Type_e type);
     // Méthodes premettant de retrouver nos éléments
-    /** Définit un fonctor permettant de parcourir notre structure un peu particulière */
-    struct comp {
-        /** Utilisé pour trouver la borne inf. Quand on cherche av, on veux que avenue soit également trouvé
-         * Il faut donc que "av" < "avenue" soit false
-         */
-        bool operator()(const std::string& a, const std::pair<std::string, std::vector<T>>& b) {
-            if (b.first.find(a) == 0)
-                return false;
-            return (a < b.first);
-        }
-
-        /** Utilisé pour la borne sup. Ici rien d'extraordinaire */
-        bool operator()(const std::pair<std::string, std::vector<T>>& b, const std::string& a) { return (b.first < a); }
-    };
-
     /** Retrouve toutes les positions des élements contenant le mot des mots qui commencent par token */
-    std::vector<T> match(const std::string& token, const std::vector<vec_elt>& vec_source) const {
-        // Les éléments dans vec_map sont triés par ordre alphabétiques, il suffit donc de trouver la borne inf et sup
-        auto lower = std::lower_bound(vec_source.begin(), vec_source.end(), token, comp());
-        auto upper = std::upper_bound(vec_source.begin(), vec_source.end(), token, comp());
+    std::vector<T> match(const std::string& token, const TokenIndex<T>& index) const {
+        // Les mots sont triés par ordre alphabétiques, ceux qui commencent par token se suivent
+        const auto range = index.prefix_range(token);
 
         std::vector<T> result;
 
         // On concatène tous les indexes
         // Pour les raisons de perfs mesurées expérimentalement, on accepte des doublons
-        for (; lower != upper; ++lower) {
-            std::vector<T> other = lower->second;
-            result.insert(result.end(), other.begin(), other.end());
+        for (auto rank = range.first; rank != range.second; ++rank) {
+            index.append_elements(rank, result);
         }
         return result;
     }
 
     /** On passe une chaîne de charactère contenant des mots et on trouve toutes les positions contenant tous ces mots*/
     std::vector<T> find(const std::set<std::string>& vecStr) const {
-        std::vector<T> result;
-        auto vec = vecStr.begin();
-        if (vec != vecStr.end()) {
-            // Premier résultat. Il y aura au plus ces indexes
-            result = match(*vec, word_dictionnary);
-
-            // If there is only one word to search we have to sort and delete duplicate results
-            if (vecStr.size() == 1) {
-                std::sort(result.begin(), result.end());
-                result.erase(unique(result.begin(), result.end()), result.end());
+        // The tokens starting with each word, the word with the fewest elements being intersected first
+        std::vector<std::pair<size_t, std::pair<size_t, size_t>>> words;
+        for (const auto& str : vecStr) {
+            const auto range = word_dictionnary.prefix_range(str);
+            size_t nb_elements = 0;
+            for (auto rank = range.first; rank != range.second; ++rank) {
+                nb_elements += word_dictionnary.nb_elements(rank);
             }
+            words.push_back({nb_elements, range});
+        }
+        std::sort(words.begin(), words.end());
 
-            for (++vec; vec != vecStr.end(); ++vec) {
-                std::vector<T> new_result;
-                std::sort(result.begin(), result.end());
-                for (auto i : match(*vec, word_dictionnary)) {
-                    // Binary search fait une recherche dichotomique pour savoir si l'élément i existe
-                    // S'il existe dans les deux cas, on le garde
-                    if (binary_search(result.begin(), result.end(), i)) {
-                        new_result.push_back(i);
-                    }
-                }
-                // The function "unique" works only if the vector new_result is sorted.
+        std::vector<T> result;
+        auto word = words.begin();
+        if (word == words.end()) {
+            return result;
+        }
+        // Premier résultat. Il y aura au plus ces indexes
+        for (auto rank = word->second.first; rank != word->second.second; ++rank) {
+            word_dictionnary.append_elements(rank, result);
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+
+        // The elements of each token are intersected with the result, as long as there is something left
+        std::vector<T> elements;
+        std::vector<T> new_result;
+        for (++word; word != words.end() && !result.empty(); ++word) {
+            new_result.clear();
+            for (auto rank = word->second.first; rank != word->second.second; ++rank) {
+                elements.clear();
+                word_dictionnary.append_elements(rank, elements);
+                intersect_sorted(result.data(), result.size(), elements.data(), elements.size(), new_result);
+            }
+            // an element can contain several tokens starting with the word
+            if (word->second.second - word->second.first > 1) {
                 std::sort(new_result.begin(), new_result.end());
-
-                // std::unique retrie les donnée et fout les doublons à la fin
-                // La fonction retourne un itérateur vers le premier doublon
-                // Expérimentalement le gain est très faible
-                result.assign(new_result.begin(), std::unique(new_result.begin(), new_result.end()));
+                new_result.erase(std::unique(new_result.begin(), new_result.end()), new_result.end());
             }
+            result.swap(new_result);
         }
         return result;
     }
@@ -333,10 +405,15 @@ struct Autocomplete {
      * @param position: element to score
      */
     std::tuple<int, size_t, int> compute_result_scores(const std::string& str, T position) const {
+        return compute_stripped_result_scores(strip_accents_and_lower(str), position);
+    }
+
+    /// compute_result_scores, the string to search being already stripped of its accents and lowered
+    std::tuple<int, size_t, int> compute_stripped_result_scores(const std::string& stripped_str, T position) const {
         auto global_score = word_quality_list.at(position).score;
 
         const auto& indexed_str = indexed_string.at(position);
-        auto lcs_and_pos = longest_common_substring(strip_accents_and_lower(str), indexed_str);
+        auto lcs_and_pos = longest_common_substring(stripped_str, indexed_str);
 
         return std::make_tuple(global_score, lcs_and_pos.first,
                                -1 * lcs_and_pos.second  // we want to minimize the position
@@ -359,21 +436,47 @@ struct Autocomplete {
 
         // Créer un vector de réponse:
         std::vector<fl_quality> vec_quality;
+        if (nbmax == 0) {
+            return vec_quality;
+        }
 
+        // The nbmax best results are kept in a heap, the worst on top. The common substring of the scores is
+        // at most the shortest of the string to search and the indexed string, at the first position: when
+        // this best case is not better than the worst result kept, the substring is not searched.
+        const auto stripped_str = strip_accents_and_lower(str);
+        const auto better = [](const fl_quality& a, const fl_quality& b) { return a.scores > b.scores; };
         for (auto i : index_result) {
-            if (keep_element(i)) {
-                quality.idx = i;
-                quality.nb_found = word_quality_list.at(quality.idx).word_count;
-                quality.word_len = wordLength;
-                quality.scores = this->compute_result_scores(str, quality.idx);
+            if (!keep_element(i)) {
+                continue;
+            }
+            if (vec_quality.size() == nbmax) {
+                const auto max_lcs = std::min(stripped_str.size(), indexed_string.at(i).size());
+                if (std::make_tuple(word_quality_list.at(i).score, max_lcs, 0) <= vec_quality.front().scores) {
+                    continue;
+                }
+            }
+            quality.idx = i;
+            quality.nb_found = word_quality_list.at(quality.idx).word_count;
+            quality.word_len = wordLength;
+            quality.scores = this->compute_stripped_result_scores(stripped_str, quality.idx);
+            quality.quality = 100;
 
-                quality.quality = 100;
+            if (vec_quality.size() < nbmax) {
                 vec_quality.push_back(quality);
+                if (vec_quality.size() == nbmax) {
+                    std::make_heap(vec_quality.begin(), vec_quality.end(), better);
+                }
+            } else if (better(quality, vec_quality.front())) {
+                std::pop_heap(vec_quality.begin(), vec_quality.end(), better);
+                vec_quality.back() = quality;
+                std::push_heap(vec_quality.begin(), vec_quality.end(), better);
             }
         }
 
-        sort_and_truncate(vec_quality, nbmax,
-                          [](const fl_quality& a, const fl_quality& b) { return a.scores > b.scores; });
+        if (vec_quality.size() < nbmax) {
+            std::make_heap(vec_quality.begin(), vec_quality.end(), better);
+        }
+        std::sort_heap(vec_quality.begin(), vec_quality.end(), better);
         return vec_quality;
     }
 
@@ -436,13 +539,19 @@ struct Autocomplete {
                     quality.idx = pair.first;
                     quality.nb_found = pair.second.nb_found;
                     quality.word_len = wordLength;
-                    quality.scores = this->compute_result_scores(str, quality.idx);
                     quality.quality = calc_quality_pattern(quality, word_weight, max_score, pattern_count);
                     vec_quality.push_back(quality);
                 }
             }
         }
-        return sort_and_truncate_by_quality(vec_quality, nbmax);
+        vec_quality = sort_and_truncate_by_quality(std::move(vec_quality), nbmax);
+
+        // The results are sorted by quality only, the scores are only computed for the ones kept
+        const auto stripped_str = strip_accents_and_lower(str);
+        for (auto& result : vec_quality) {
+            result.scores = this->compute_stripped_result_scores(stripped_str, result.idx);
+        }
+        return vec_quality;
     }
 
     /** pour chaque mot trouvé dans la liste des mots il faut incrémenter la propriété : nb_found*/
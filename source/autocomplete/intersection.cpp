@@ -0,0 +1,122 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "autocomplete/intersection.h"
+
+#include <algorithm>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace navitia {
+namespace autocomplete {
+
+// beyond this ratio of sizes, galloping in the long list is cheaper than merging
+static const size_t GALLOPING_RATIO = 32;
+
+void intersect_galloping(const uint32_t* small,
+                         size_t small_size,
+                         const uint32_t* large,
+                         size_t large_size,
+                         std::vector<uint32_t>& out) {
+    size_t pos = 0;
+    for (size_t i = 0; i < small_size && pos < large_size; ++i) {
+        const auto elt = small[i];
+        // large[pos + bound / 2] < elt <= large[pos + bound], then a binary search in between
+        size_t bound = 1;
+        while (pos + bound < large_size && large[pos + bound] < elt) {
+            bound *= 2;
+        }
+        const auto last = std::min(large_size, pos + bound + 1);
+        pos = std::lower_bound(large + pos + bound / 2, large + last, elt) - large;
+        if (pos < large_size && large[pos] == elt) {
+            out.push_back(elt);
+            ++pos;
+        }
+    }
+}
+
+void intersect_merge(const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size, std::vector<uint32_t>& out) {
+    size_t i = 0, j = 0;
+#ifdef __SSE2__
+    // each block of a is compared to the 4 rotations of the block of b, then the block with the
+    // lowest maximum is passed
+    const size_t a_blocks_end = a_size & ~size_t(3);
+    const size_t b_blocks_end = b_size & ~size_t(3);
+    while (i < a_blocks_end && j < b_blocks_end) {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        const __m128i eq0 = _mm_cmpeq_epi32(va, vb);
+        const __m128i eq1 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)));
+        const __m128i eq2 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2)));
+        const __m128i eq3 = _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)));
+        const int mask =
+            _mm_movemask_ps(_mm_castsi128_ps(_mm_or_si128(_mm_or_si128(eq0, eq1), _mm_or_si128(eq2, eq3))));
+        for (int k = 0; k < 4; ++k) {
+            if (mask & (1 << k)) {
+                out.push_back(a[i + k]);
+            }
+        }
+        const auto a_max = a[i + 3];
+        const auto b_max = b[j + 3];
+        if (a_max <= b_max) {
+            i += 4;
+        }
+        if (b_max <= a_max) {
+            j += 4;
+        }
+    }
+#endif
+    while (i < a_size && j < b_size) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            out.push_back(a[i]);
+            ++i;
+            ++j;
+        }
+    }
+}
+
+void intersect_sorted(const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size, std::vector<uint32_t>& out) {
+    if (a_size * GALLOPING_RATIO < b_size) {
+        intersect_galloping(a, a_size, b, b_size, out);
+    } else if (b_size * GALLOPING_RATIO < a_size) {
+        intersect_galloping(b, b_size, a, a_size, out);
+    } else {
+        intersect_merge(a, a_size, b, b_size, out);
+    }
+}
+
+}  // namespace autocomplete
+}  // namespace navitia
@@ -0,0 +1,56 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace navitia {
+namespace autocomplete {
+
+/** Append to out the elements of a also in b, a and b being sorted without duplicates
+ *
+ * When one list is much shorter than the other, its elements are searched in the long one by
+ * galloping, otherwise both are merged by blocks of 4 elements with SSE2 comparisons.
+ */
+void intersect_sorted(const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size, std::vector<uint32_t>& out);
+
+// the kernels, exposed for the tests and the benchmarks
+void intersect_galloping(const uint32_t* small,
+                         size_t small_size,
+                         const uint32_t* large,
+                         size_t large_size,
+                         std::vector<uint32_t>& out);
+void intersect_merge(const uint32_t* a, size_t a_size, const uint32_t* b, size_t b_size, std::vector<uint32_t>& out);
+
+}  // namespace autocomplete
+}  // namespace navitia
@@ -2180,3 +2180,144 @@ BOOST_AUTO_TEST_CASE(autocomplete_test_stop_area_longest_substring) {
         BOOST_REQUIRE_EQUAL(resp.places(0).scores(2), (sp_search_low.size() - 1) * -1);
     }
 }
+
+BOOST_AUTO_TEST_CASE(token_index_test) {
+    // enough tokens for several blocks
+    std::map<std::string, std::set<navitia::type::idx_t>> tokens_elements;
+    for (navitia::type::idx_t i = 0; i < 100; ++i) {
+        tokens_elements["rue" + std::to_string(i)].insert({i, i + 300, i * 1000});
+        tokens_elements["ru" + std::to_string(i)].insert(i);
+    }
+    tokens_elements["gare"].insert(7);
+    tokens_elements["ga"].insert({1, 2});
+
+    TokenIndex<navitia::type::idx_t> index;
+    BOOST_CHECK(index.prefix_range("rue") == std::make_pair(size_t(0), size_t(0)));
+    index.build(tokens_elements);
+    BOOST_REQUIRE_EQUAL(index.size(), tokens_elements.size());
+
+    size_t rank = 0;
+    for (const auto& token_elements : tokens_elements) {
+        BOOST_CHECK_EQUAL(index.token(rank), token_elements.first);
+        std::vector<navitia::type::idx_t> elements;
+        index.append_elements(rank, elements);
+        BOOST_CHECK_EQUAL_COLLECTIONS(elements.begin(), elements.end(), token_elements.second.begin(),
+                                      token_elements.second.end());
+        ++rank;
+    }
+
+    auto check_prefix = [&](const std::string& prefix, size_t expected_nb) {
+        const auto range = index.prefix_range(prefix);
+        BOOST_CHECK_EQUAL(range.second - range.first, expected_nb);
+        for (auto r = range.first; r < range.second; ++r) {
+            BOOST_CHECK_EQUAL(index.token(r).compare(0, prefix.size(), prefix), 0);
+        }
+    };
+    check_prefix("ga", 2);
+    check_prefix("gare", 1);
+    check_prefix("garage", 0);
+    check_prefix("ru", 200);
+    check_prefix("rue", 100);
+    check_prefix("rue1", 11);
+    check_prefix("ru99", 1);
+    check_prefix("s", 0);
+    check_prefix("a", 0);
+}
+
+BOOST_AUTO_TEST_CASE(autocomplete_find_complete_top_k_test) {
+    autocomplete_map synonyms;
+    std::set<std::string> ghostwords;
+
+    Autocomplete<unsigned int> ac;
+    for (unsigned int i = 0; i < 50; ++i) {
+        ac.add_string("rue " + std::to_string(i) + " jean", i, ghostwords, synonyms);
+        ac.word_quality_list.at(i).score = (i * 7) % 13;
+    }
+    ac.add_string("rue jean", 50, ghostwords, synonyms);
+    ac.build();
+
+    const auto all = ac.find_complete(
+        "rue jean", 100, [](int) { return true; }, ghostwords);
+    BOOST_REQUIRE_EQUAL(all.size(), 51);
+    for (size_t nbmax : {1, 3, 10}) {
+        const auto res = ac.find_complete(
+            "rue jean", nbmax, [](int) { return true; }, ghostwords);
+        BOOST_REQUIRE_EQUAL(res.size(), nbmax);
+        for (size_t i = 0; i < nbmax; ++i) {
+            BOOST_CHECK(res.at(i).scores == all.at(i).scores);
+        }
+    }
+    BOOST_CHECK_EQUAL(std::get<0>(all.at(0).scores), 12);
+    // among the lowest global scores, the full string comes first
+    BOOST_CHECK_EQUAL(all.at(46).idx, 50);
+}
+
+BOOST_AUTO_TEST_CASE(autocomplete_update_test) {
+    autocomplete_map synonyms;
+    std::set<std::string> ghostwords;
+    std::vector<std::pair<unsigned int, std::string>> strings = {
+        {0, "rue jeanne d'arc"}, {1, "place jean jaures"}, {2, "rue jean zay"}, {3, "avenue jean jaures"}};
+
+    Autocomplete<unsigned int> ac;
+    ac.update(strings, ghostwords, synonyms);
+
+    // one string changed, one removed and one added
+    strings[1].second = "place jean moulin";
+    strings.erase(strings.begin() + 2);
+    strings.push_back({4, "rue jean moulin"});
+    ac.update(strings, ghostwords, synonyms);
+
+    Autocomplete<unsigned int> expected;
+    for (const auto& position_string : strings) {
+        expected.add_string(position_string.second, position_string.first, ghostwords, synonyms);
+    }
+    expected.build();
+
+    for (const std::string& search : {"jean", "rue jean", "moulin", "zay", "jau", "pla"}) {
+        const auto words = ac.tokenize(search, ghostwords);
+        const auto found = ac.find(words);
+        const auto expected_found = expected.find(words);
+        BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), expected_found.begin(), expected_found.end());
+    }
+    BOOST_CHECK(ac.find(ac.tokenize("zay", ghostwords)).empty());
+    BOOST_CHECK_EQUAL(ac.find(ac.tokenize("moulin", ghostwords)).size(), 2);
+    BOOST_CHECK_EQUAL(ac.word_quality_list.size(), 4);
+    BOOST_CHECK_EQUAL(ac.indexed_string.at(1), "place jean moulin");
+
+    // the typos search on the patterns too
+    const auto res = ac.find_partial_with_pattern(
+        "jean moulen", 10, 10, [](int) { return true; }, ghostwords);
+    const auto expected_res = expected.find_partial_with_pattern(
+        "jean moulen", 10, 10, [](int) { return true; }, ghostwords);
+    std::set<std::pair<unsigned int, int>> found, expected_found;
+    for (const auto& r : res) {
+        found.insert({r.idx, r.quality});
+    }
+    for (const auto& r : expected_res) {
+        expected_found.insert({r.idx, r.quality});
+    }
+    BOOST_CHECK(found == expected_found);
+    BOOST_CHECK(!found.empty());
+}
+
+BOOST_AUTO_TEST_CASE(autocomplete_update_with_other_ghostwords_and_synonyms_test) {
+    const std::vector<std::pair<unsigned int, std::string>> strings = {{0, "rue st jean"}, {1, "place de la gare"}};
+
+    Autocomplete<unsigned int> ac;
+    ac.update(strings, {}, {});
+    BOOST_CHECK(ac.find(ac.tokenize("saint", {})).empty());
+    BOOST_CHECK_EQUAL(ac.find(ac.tokenize("de", {})).size(), 1);
+
+    // the strings did not change but their tokens did
+    autocomplete_map synonyms;
+    synonyms["st"] = "saint";
+    const std::set<std::string> ghostwords = {"de"};
+    ac.update(strings, ghostwords, synonyms);
+    BOOST_CHECK_EQUAL(ac.find(ac.tokenize("saint", {})).size(), 1);
+    BOOST_CHECK(ac.find(ac.tokenize("de", {})).empty());
+
+    // and back
+    ac.update(strings, {}, {});
+    BOOST_CHECK(ac.find(ac.tokenize("saint", {})).empty());
+    BOOST_CHECK_EQUAL(ac.find(ac.tokenize("de", {})).size(), 1);
+}
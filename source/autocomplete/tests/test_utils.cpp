@@ -31,6 +31,7 @@ www.navitia.io
 #include <boost/test/unit_test.hpp>
 #include "type/type_interfaces.h"
 #include "autocomplete/utils.h"
+#include "autocomplete/intersection.h"
 #include "tests/utils_test.h"
 
 using namespace navitia::autocomplete;
@@ -86,3 +87,34 @@ BOOST_AUTO_TEST_CASE(autocomplete_build_type_group) {
     expected = {Type_e::VehicleJourney, Type_e::JourneyPattern};
     BOOST_REQUIRE_EQUAL_COLLECTIONS(result[1].begin(), result[1].end(), expected.begin(), expected.end());
 }
+
+BOOST_AUTO_TEST_CASE(autocomplete_intersect_sorted) {
+    std::vector<uint32_t> a, b, expected;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        a.push_back(i * 3);
+        b.push_back(i * 5 + 1);
+        if ((i * 3) % 5 == 1 && i * 3 < 5000) {
+            expected.push_back(i * 3);
+        }
+    }
+    std::vector<uint32_t> out;
+    intersect_merge(a.data(), a.size(), b.data(), b.size(), out);
+    BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.end(), expected.begin(), expected.end());
+    out.clear();
+    intersect_galloping(a.data(), a.size(), b.data(), b.size(), out);
+    BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.end(), expected.begin(), expected.end());
+
+    // a few elements in a long list
+    const std::vector<uint32_t> small = {0, 6, 7, 2997};
+    out.clear();
+    intersect_sorted(small.data(), small.size(), a.data(), a.size(), out);
+    expected = {0, 6, 2997};
+    BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.end(), expected.begin(), expected.end());
+    out.clear();
+    intersect_sorted(a.data(), a.size(), small.data(), small.size(), out);
+    BOOST_CHECK_EQUAL_COLLECTIONS(out.begin(), out.end(), expected.begin(), expected.end());
+
+    out.clear();
+    intersect_sorted(a.data(), 0, b.data(), b.size(), out);
+    BOOST_CHECK(out.empty());
+}
@@ -0,0 +1,297 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/serialization/serialization.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace navitia {
+namespace autocomplete {
+
+/** Immutable dictionary of the tokens of an autocomplete, each token having the sorted list of
+ * the elements containing it (its posting list)
+ *
+ * The tokens are sorted and front coded by blocks of BLOCK_SIZE: the first token of a block is
+ * stored whole, the next ones as the length of the prefix shared with the previous token and
+ * the remaining suffix. A prefix is looked up by a binary search on the first tokens of the
+ * blocks, then by decoding one block.
+ *
+ * The posting lists are in one buffer, each one being its size then the deltas between its
+ * successive elements, as varints.
+ *
+ * A token is designated by its rank in the sorted tokens.
+ */
+template <class T>
+class TokenIndex {
+public:
+    static constexpr size_t BLOCK_SIZE = 16;
+
+    /// Build the index from sorted tokens and their sorted elements, like a map<string, set<T>>
+    template <class SortedMap>
+    void build(const SortedMap& tokens_elements) {
+        clear();
+        std::string previous;
+        for (const auto& token_elements : tokens_elements) {
+            append(previous, token_elements.first, token_elements.second);
+        }
+        finish();
+    }
+
+    /** This index with the elements of added and without the ones of removed
+     *
+     * added is sorted like for build, removed is sorted. The tokens left without element are dropped.
+     */
+    template <class SortedMap>
+    TokenIndex merge(const SortedMap& added, const std::vector<T>& removed) const {
+        TokenIndex merged;
+        std::string previous;
+        std::string token;
+        std::vector<T> elements;
+        std::vector<T> union_elements;
+        size_t rank = 0;
+        size_t pos = 0;
+        auto added_it = added.begin();
+        while (rank < nb_tokens || added_it != added.end()) {
+            // the tokens are read one after the other, each one being decoded from the previous one
+            std::string next_token = token;
+            size_t next_pos = pos;
+            if (rank < nb_tokens) {
+                next_pos = read_token(pos, next_token);
+            }
+            const bool take_old = rank < nb_tokens && (added_it == added.end() || next_token <= added_it->first);
+            const bool take_added = added_it != added.end() && (rank >= nb_tokens || added_it->first <= next_token);
+
+            elements.clear();
+            if (take_old) {
+                for_each_element(rank, [&](const T elt) {
+                    if (!std::binary_search(removed.begin(), removed.end(), elt)) {
+                        elements.push_back(elt);
+                    }
+                });
+                token = std::move(next_token);
+                pos = next_pos;
+                ++rank;
+            }
+            if (take_added) {
+                union_elements.clear();
+                std::set_union(elements.begin(), elements.end(), added_it->second.begin(), added_it->second.end(),
+                               std::back_inserter(union_elements));
+                elements.swap(union_elements);
+            }
+            const std::string& merged_token = take_old ? token : added_it->first;
+            if (!elements.empty()) {
+                merged.append(previous, merged_token, elements);
+            }
+            if (take_added) {
+                ++added_it;
+            }
+        }
+        merged.finish();
+        return merged;
+    }
+
+    void clear() {
+        nb_tokens = 0;
+        tokens.clear();
+        block_offsets.clear();
+        postings.clear();
+        posting_offsets.clear();
+    }
+
+    size_t size() const { return nb_tokens; }
+    bool empty() const { return nb_tokens == 0; }
+
+    /// The ranks [first, last) of the tokens starting with prefix
+    std::pair<size_t, size_t> prefix_range(const std::string& prefix) const {
+        const auto first = first_token([&](const std::string& token) { return token >= prefix; });
+        const auto last = first_token([&](const std::string& token) {
+            return token >= prefix && token.compare(0, prefix.size(), prefix) != 0;
+        });
+        return {first, std::max(first, last)};
+    }
+
+    std::string token(size_t rank) const {
+        std::string token;
+        size_t pos = block_offsets[rank / BLOCK_SIZE];
+        for (size_t r = rank - rank % BLOCK_SIZE; r <= rank; ++r) {
+            pos = read_token(pos, token);
+        }
+        return token;
+    }
+
+    /// Number of elements containing the token
+    size_t nb_elements(size_t rank) const {
+        size_t pos = posting_offsets[rank];
+        return read_varint(postings, pos);
+    }
+
+    /// Call f on each element containing the token, in increasing order
+    template <class F>
+    void for_each_element(size_t rank, F f) const {
+        size_t pos = posting_offsets[rank];
+        auto nb = read_varint(postings, pos);
+        T elt = 0;
+        for (; nb > 0; --nb) {
+            elt += T(read_varint(postings, pos));
+            f(elt);
+        }
+    }
+
+    /// Append the elements containing the token to out
+    void append_elements(size_t rank, std::vector<T>& out) const {
+        out.reserve(out.size() + nb_elements(rank));
+        for_each_element(rank, [&](const T elt) { out.push_back(elt); });
+    }
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& nb_tokens& tokens& block_offsets& postings& posting_offsets;
+    }
+
+private:
+    size_t nb_tokens = 0;
+    // the front coded tokens, and where each block starts in it
+    std::vector<uint8_t> tokens;
+    std::vector<uint64_t> block_offsets;
+    // the posting lists, and where the one of each token starts in it
+    std::vector<uint8_t> postings;
+    std::vector<uint64_t> posting_offsets;
+
+    // append a token greater than the previous one
+    template <class Elements>
+    void append(std::string& previous, const std::string& token, const Elements& elements) {
+        size_t shared = 0;
+        if (nb_tokens % BLOCK_SIZE == 0) {
+            block_offsets.push_back(tokens.size());
+        } else {
+            const auto max_shared = std::min(previous.size(), token.size());
+            while (shared < max_shared && previous[shared] == token[shared]) {
+                ++shared;
+            }
+        }
+        write_varint(tokens, shared);
+        write_varint(tokens, token.size() - shared);
+        tokens.insert(tokens.end(), token.begin() + shared, token.end());
+        previous = token;
+
+        posting_offsets.push_back(postings.size());
+        write_varint(postings, elements.size());
+        T last = 0;
+        for (const T elt : elements) {
+            write_varint(postings, elt - last);
+            last = elt;
+        }
+        ++nb_tokens;
+    }
+
+    void finish() {
+        posting_offsets.push_back(postings.size());
+        tokens.shrink_to_fit();
+        postings.shrink_to_fit();
+        block_offsets.shrink_to_fit();
+        posting_offsets.shrink_to_fit();
+    }
+
+    static void write_varint(std::vector<uint8_t>& buffer, uint64_t value) {
+        while (value >= 0x80) {
+            buffer.push_back(uint8_t(value) | 0x80);
+            value >>= 7;
+        }
+        buffer.push_back(uint8_t(value));
+    }
+
+    static uint64_t read_varint(const std::vector<uint8_t>& buffer, size_t& pos) {
+        uint64_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            const uint8_t byte = buffer[pos++];
+            value |= uint64_t(byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return value;
+            }
+        }
+    }
+
+    // decode the token at pos, token holding the previous one, and return the position of the next one
+    size_t read_token(size_t pos, std::string& token) const {
+        const auto shared = read_varint(tokens, pos);
+        const auto suffix = read_varint(tokens, pos);
+        token.resize(shared);
+        token.append(reinterpret_cast<const char*>(tokens.data()) + pos, suffix);
+        return pos + suffix;
+    }
+
+    // rank of the first token on which pred is true, pred being false then true along the tokens
+    template <class Pred>
+    size_t first_token(Pred pred) const {
+        // the first block whose first token is true, the searched token being before it or that one
+        std::string token;
+        size_t low = 0, high = block_offsets.size();
+        while (low < high) {
+            const auto mid = (low + high) / 2;
+            token.clear();
+            read_token(block_offsets[mid], token);
+            if (pred(token)) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        if (low == 0) {
+            return 0;
+        }
+        // in the previous block, whose first token is false
+        const auto block = low - 1;
+        const auto block_end = std::min(nb_tokens, low * BLOCK_SIZE);
+        size_t pos = block_offsets[block];
+        token.clear();
+        pos = read_token(pos, token);
+        for (size_t rank = block * BLOCK_SIZE + 1; rank < block_end; ++rank) {
+            pos = read_token(pos, token);
+            if (pred(token)) {
+                return rank;
+            }
+        }
+        return block_end;
+    }
+};
+
+template <class T>
+constexpr size_t TokenIndex<T>::BLOCK_SIZE;
+
+}  // namespace autocomplete
+}  // namespace navitia
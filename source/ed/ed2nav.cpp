@@ -145,7 +145,7 @@ struct FindAdminWithCities {
         return admin;
     }
 
-    result_type get_admins_from_cities(const navitia::type::GeographicalCoord& c, georef::AdminRtree& admin_tree) {
+    result_type get_admins_from_cities(const navitia::type::GeographicalCoord& c, georef::AdminIndex& admin_index) {
         /*
             We only fetch admins containings the coordinate in their boundary shape
             because a left join between above result and another query using boundary shape
@@ -198,23 +198,15 @@ struct FindAdminWithCities {
         //clang-format on
         boost::range::transform(filtered_res, std::back_inserter(new_admins), make_admin_from_row);
 
-        auto add_admin_to_cache = [&](georef::Admin* admin) {
-            if (admin->boundary.empty()) {
-                return;
-            }
-            const auto box = boost::geometry::return_envelope<georef::Box>(admin->boundary);
-            const double min[2] = {box.min_corner().lon(), box.min_corner().lat()};
-            const double max[2] = {box.max_corner().lon(), box.max_corner().lat()};
-            admin_tree.Insert(min, max, admin);
-        };
+        auto add_admin_to_cache = [&](georef::Admin* admin) { admin_index.insert(admin); };
 
-        // Add admins to RTree cache
+        // Add admins to the index cache
         boost::range::for_each(new_admins, add_admin_to_cache);
 
-        return georef.find_admins(c, admin_tree);
+        return georef.find_admins(c, admin_index);
     }
 
-    result_type operator()(const navitia::type::GeographicalCoord& c, georef::AdminRtree& admin_tree) {
+    result_type operator()(const navitia::type::GeographicalCoord& c, georef::AdminIndex& admin_index) {
         auto log = log4cplus::Logger::getInstance("ed2nav::FindAdminWithCities");
 
         if (nb_call == 0) {
@@ -227,7 +219,7 @@ struct FindAdminWithCities {
             return {};
         }
 
-        const auto& georef_res = georef.find_admins(c, admin_tree);
+        const auto& georef_res = georef.find_admins(c, admin_index);
 
         if (!georef_res.empty()) {
             ++nb_georef;
@@ -237,7 +229,7 @@ struct FindAdminWithCities {
         TimerGuard tg([&](const StopWatch& stopwatch) {
             LOG4CPLUS_TRACE(log, "Find admin in cities db | " << stopwatch.elapsed() << " us");
         });
-        auto res = get_admins_from_cities(c, admin_tree);
+        auto res = get_admins_from_cities(c, admin_index);
         ++cities_stats[res.size()];
         return res;
     }
@@ -31,6 +31,7 @@ www.navitia.io
 #include "ed_reader.h"
 
 #include "ed/connectors/fare_utils.h"
+#include "georef/hilbert_curve.h"
 #include "type/meta_data.h"
 #include "type/access_point.h"
 #include "type/network.h"
@@ -1640,7 +1641,8 @@ void EdReader::fill_vector_to_ignore(pqxx::work& work, const double min_non_conn
 void EdReader::fill_vertex(navitia::type::Data& data, pqxx::work& work) {
     std::string request = "select id, ST_X(coord::geometry) as lon, ST_Y(coord::geometry) as lat from georef.node;";
     pqxx::result result = work.exec(request);
-    uint64_t idx = 0;
+    std::vector<uint64_t> ids;
+    std::vector<nt::GeographicalCoord> coords;
     for (auto const_it = result.begin(); const_it != result.end(); ++const_it) {
         auto id = const_it["id"].as<uint64_t>();
 
@@ -1649,11 +1651,17 @@ void EdReader::fill_vertex(navitia::type::Data& data, pqxx::work& work) {
             continue;
         }
 
+        ids.push_back(id);
+        coords.emplace_back(const_it["lon"].as<double>(), const_it["lat"].as<double>());
+    }
+    // the vertices are numbered along a Hilbert curve, so that the neighbouring intersections, and their
+    // out edges, are close in memory for the street network searches
+    uint64_t idx = 0;
+    for (const size_t i : ng::hilbert_order(coords)) {
         navitia::georef::Vertex v;
-        v.coord.set_lon(const_it["lon"].as<double>());
-        v.coord.set_lat(const_it["lat"].as<double>());
+        v.coord = coords[i];
         boost::add_vertex(v, data.geo_ref->graph);
-        this->node_map[id] = idx;
+        this->node_map[ids[i]] = idx;
         idx++;
     }
     data.geo_ref->init();
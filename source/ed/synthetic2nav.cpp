@@ -0,0 +1,119 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed/synthetic_network.h"
+
+#include "conf.h"
+#include "utils/init.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/program_options.hpp>
+
+#include <iostream>
+
+namespace po = boost::program_options;
+namespace pt = boost::posix_time;
+
+int main(int argc, const char** argv) {
+    ed::SyntheticNetworkParams params;
+    std::string output;
+    po::options_description desc("Allowed options");
+
+    // clang-format off
+    desc.add_options()
+        ("help,h", "Show this message")
+        ("version,v", "Show version")
+        ("output,o", po::value<std::string>(&output)->default_value("data.nav.lz4"), "Output file")
+        ("lines,l", po::value<size_t>(&params.nb_lines)->default_value(params.nb_lines), "Number of lines")
+        ("stops,s", po::value<size_t>(&params.nb_stops_by_line)->default_value(params.nb_stops_by_line),
+            "Number of stops by line")
+        ("inter_stop_distance", po::value<uint32_t>(&params.inter_stop_distance)
+            ->default_value(params.inter_stop_distance), "Distance between two stops of a line, in meters")
+        ("frequency_line_step", po::value<size_t>(&params.frequency_line_step)
+            ->default_value(params.frequency_line_step), "One line every n lines is a frequency line (0 for none)")
+        ("start_time", po::value<uint32_t>(&params.start_time)->default_value(params.start_time),
+            "Start of the service, in seconds since midnight")
+        ("end_time", po::value<uint32_t>(&params.end_time)->default_value(params.end_time),
+            "End of the service, in seconds since midnight")
+        ("headway", po::value<uint32_t>(&params.headway)->default_value(params.headway),
+            "Time between two vehicles of a line, in seconds")
+        ("transfer_duration", po::value<uint32_t>(&params.transfer_duration)->default_value(params.transfer_duration),
+            "Minimal duration of a transfer, in seconds")
+        ("street_grid_step", po::value<uint32_t>(&params.street_grid_step)->default_value(params.street_grid_step),
+            "Distance between two intersections of the street grid, in meters (0 for no street network)")
+        ("disruptions", po::value<size_t>(&params.nb_disruptions)->default_value(params.nb_disruptions),
+            "Number of lines impacted by a disruption")
+        ("begin_date", po::value<std::string>(&params.begin_date)->default_value(params.begin_date),
+            "Beginning of the production period (YYYYMMDD)")
+        ("seed", po::value<uint32_t>(&params.seed)->default_value(params.seed), "Seed of the random generator");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+
+    if (vm.count("version")) {
+        std::cout << argv[0] << " " << navitia::config::project_version << " " << navitia::config::navitia_build_type
+                  << std::endl;
+        return 0;
+    }
+    if (vm.count("help")) {
+        std::cout << "Generates a synthetic network readable by kraken, to be used by the benchmarks" << std::endl;
+        std::cout << desc << std::endl;
+        return 1;
+    }
+    po::notify(vm);
+
+    navitia::init_app("synthetic2nav", "INFO", false, "");
+    auto logger = log4cplus::Logger::getInstance("log");
+
+    auto start = pt::microsec_clock::local_time();
+    const auto b = ed::make_synthetic_network(params);
+    const auto& data = *b->data;
+    const int generation = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    LOG4CPLUS_INFO(logger, "line: " << data.pt_data->lines.size());
+    LOG4CPLUS_INFO(logger, "stoppoint: " << data.pt_data->stop_points.size());
+    LOG4CPLUS_INFO(logger, "vehiclejourney: " << data.pt_data->vehicle_journeys.size());
+    LOG4CPLUS_INFO(logger, "stop: " << data.pt_data->nb_stop_times());
+    LOG4CPLUS_INFO(logger, "connection: " << data.pt_data->stop_point_connections.size());
+    LOG4CPLUS_INFO(logger, "street vertices: " << boost::num_vertices(data.geo_ref->graph));
+    LOG4CPLUS_INFO(logger, "street edges: " << boost::num_edges(data.geo_ref->graph));
+    LOG4CPLUS_INFO(logger, "disruptions: " << data.pt_data->disruption_holder.nb_disruptions());
+
+    start = pt::microsec_clock::local_time();
+    data.save(output);
+    const int save = (pt::microsec_clock::local_time() - start).total_milliseconds();
+
+    LOG4CPLUS_INFO(logger, "Computing times");
+    LOG4CPLUS_INFO(logger, "\t Generation: " << generation << "ms");
+    LOG4CPLUS_INFO(logger, "\t Data writing: " << save << "ms");
+
+    return 0;
+}
@@ -0,0 +1,294 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed/synthetic_network.h"
+
+#include "georef/adminref.h"
+#include "kraken/apply_disruption.h"
+#include "type/datetime.h"
+#include "type/disruption.h"
+#include "utils/exception.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace nt = navitia::type;
+namespace ng = navitia::georef;
+namespace pt = boost::posix_time;
+
+namespace ed {
+
+namespace {
+
+// approximation good enough for the size of the generated networks
+constexpr double meters_by_degree = 111320.;
+
+struct Layout {
+    const SyntheticNetworkParams& params;
+    size_t nb_horizontal_lines;
+    size_t nb_vertical_lines;
+    // length of the side of the covered square, in meters
+    double side;
+
+    explicit Layout(const SyntheticNetworkParams& params)
+        : params(params),
+          nb_horizontal_lines((params.nb_lines + 1) / 2),
+          nb_vertical_lines(params.nb_lines / 2),
+          side(double(params.nb_stops_by_line - 1) * params.inter_stop_distance) {}
+
+    // the lines are evenly spaced on the covered square
+    double line_offset(size_t line_pos, size_t nb_lines) const { return (line_pos + 0.5) * side / nb_lines; }
+
+    nt::GeographicalCoord to_coord(double x, double y) const {
+        const double lat = params.center_lat + (y - side / 2) / meters_by_degree;
+        const double lon =
+            params.center_lon + (x - side / 2) / (meters_by_degree * std::cos(params.center_lat * M_PI / 180.));
+        return {lon, lat};
+    }
+
+    static std::string line_uri(bool horizontal, size_t line_pos) {
+        return std::string("line:") + (horizontal ? "H" : "V") + std::to_string(line_pos);
+    }
+
+    static std::string stop_area_name(bool horizontal, size_t line_pos, size_t stop_pos) {
+        return "stop_area:" + line_uri(horizontal, line_pos).substr(5) + ":" + std::to_string(stop_pos);
+    }
+
+    // position in meters of a stop on the covered square
+    std::pair<double, double> stop_position(bool horizontal, size_t line_pos, size_t stop_pos) const {
+        const double along = double(stop_pos) * params.inter_stop_distance;
+        if (horizontal) {
+            return {along, line_offset(line_pos, nb_horizontal_lines)};
+        }
+        return {line_offset(line_pos, nb_vertical_lines), along};
+    }
+};
+
+void add_street_grid(builder& b, const Layout& layout) {
+    const auto& params = layout.params;
+    auto& geo_ref = *b.data->geo_ref;
+
+    // the grid overflows the covered square by one step on each side so that
+    // every stop is surrounded by streets
+    const double step = params.street_grid_step;
+    const size_t nb_by_side = size_t(std::ceil(layout.side / step)) + 3;
+    auto vertex_idx = [&](size_t row, size_t col) { return ng::vertex_t(row * nb_by_side + col); };
+
+    for (size_t row = 0; row < nb_by_side; ++row) {
+        for (size_t col = 0; col < nb_by_side; ++col) {
+            ng::Vertex v(layout.to_coord((double(col) - 1) * step, (double(row) - 1) * step));
+            boost::add_vertex(v, geo_ref.graph);
+        }
+    }
+    geo_ref.init();
+
+    auto add_way = [&](const std::string& uri, const std::string& name) {
+        auto* way = new ng::Way;
+        way->idx = geo_ref.ways.size();
+        way->uri = uri;
+        way->name = name;
+        way->way_type = "street";
+        geo_ref.ways.push_back(way);
+        return way;
+    };
+    auto add_edges = [&](ng::Way* way, ng::vertex_t source, ng::vertex_t target) {
+        for (const auto mode : {nt::Mode_e::Walking, nt::Mode_e::Bike, nt::Mode_e::Car}) {
+            const auto offset = geo_ref.offsets[mode];
+            const auto duration = navitia::time_res_traits::sec_type(std::lround(step / ng::default_speed[mode]));
+            const ng::Edge e(way->idx, navitia::seconds(duration));
+            boost::add_edge(offset + source, offset + target, e, geo_ref.graph);
+            boost::add_edge(offset + target, offset + source, e, geo_ref.graph);
+            way->edges.emplace_back(offset + source, offset + target);
+            way->edges.emplace_back(offset + target, offset + source);
+        }
+    };
+
+    for (size_t row = 0; row < nb_by_side; ++row) {
+        auto* way = add_way("way:row:" + std::to_string(row), "rue " + std::to_string(row));
+        for (size_t col = 0; col + 1 < nb_by_side; ++col) {
+            add_edges(way, vertex_idx(row, col), vertex_idx(row, col + 1));
+        }
+    }
+    for (size_t col = 0; col < nb_by_side; ++col) {
+        auto* way = add_way("way:col:" + std::to_string(col), "avenue " + std::to_string(col));
+        for (size_t row = 0; row + 1 < nb_by_side; ++row) {
+            add_edges(way, vertex_idx(row, col), vertex_idx(row + 1, col));
+        }
+    }
+
+    auto* admin = new ng::Admin(0, "admin:synthetic", "Synthetic city", 8, "00000", "Synthetic city",
+                                layout.to_coord(layout.side / 2, layout.side / 2), {"00000"});
+    geo_ref.admins.push_back(admin);
+}
+
+void add_line(builder& b, const Layout& layout, bool horizontal, size_t line_pos, std::mt19937& rng) {
+    const auto& params = layout.params;
+    const auto line_uri = Layout::line_uri(horizontal, line_pos);
+    const auto nb_stops = params.nb_stops_by_line;
+    const int inter_stop_time = int(std::lround(params.inter_stop_distance / params.vehicle_speed)) + params.dwell_time;
+    // counted in each orientation, so that there are horizontal and vertical frequency lines
+    const bool is_frequency = params.frequency_line_step != 0 && line_pos % params.frequency_line_step == 0;
+
+    for (bool forward : {true, false}) {
+        const auto route_uri = "route:" + line_uri.substr(5) + (forward ? ":forward" : ":backward");
+        auto add_stop_times = [&](VJ& vj, int first_departure) {
+            for (size_t i = 0; i < nb_stops; ++i) {
+                const size_t stop_pos = forward ? i : nb_stops - 1 - i;
+                const int time = first_departure + int(i) * inter_stop_time;
+                vj("stop_point:" + Layout::stop_area_name(horizontal, line_pos, stop_pos), time,
+                   time + int(params.dwell_time));
+            }
+        };
+
+        // the lines do not all start at the same time to avoid perfectly synchronized transfers
+        const int shift = int(rng() % std::max<uint32_t>(params.headway, 1));
+        const int first_departure = int(params.start_time) + shift;
+        if (is_frequency) {
+            auto vj = b.frequency_vj(line_uri, first_departure, params.end_time, params.headway, "base_network");
+            vj.route(route_uri).valid_all_days();
+            add_stop_times(vj, first_departure);
+            vj.make();
+            continue;
+        }
+        size_t vj_count = 0;
+        for (int departure = first_departure; departure < int(params.end_time); departure += params.headway) {
+            auto vj = b.vj(line_uri);
+            vj.route(route_uri).name("vj:" + route_uri.substr(6) + ":" + std::to_string(vj_count++)).valid_all_days();
+            add_stop_times(vj, departure);
+            vj.make();
+        }
+    }
+}
+
+void add_transfers(builder& b, const Layout& layout) {
+    const auto& params = layout.params;
+    const double walking_speed = ng::default_speed[nt::Mode_e::Walking];
+    const auto last_stop = double(params.nb_stops_by_line - 1);
+
+    for (size_t h = 0; h < layout.nb_horizontal_lines; ++h) {
+        const double y = layout.line_offset(h, layout.nb_horizontal_lines);
+        for (size_t v = 0; v < layout.nb_vertical_lines; ++v) {
+            const double x = layout.line_offset(v, layout.nb_vertical_lines);
+            // nearest stop of each line from the crossing
+            const auto h_stop = size_t(std::min(std::round(x / params.inter_stop_distance), last_stop));
+            const auto v_stop = size_t(std::min(std::round(y / params.inter_stop_distance), last_stop));
+            const auto h_pos = layout.stop_position(true, h, h_stop);
+            const auto v_pos = layout.stop_position(false, v, v_stop);
+            const double distance = std::abs(h_pos.first - v_pos.first) + std::abs(h_pos.second - v_pos.second);
+            const auto duration = float(params.transfer_duration + std::lround(distance / walking_speed));
+
+            const auto h_sp = "stop_point:" + Layout::stop_area_name(true, h, h_stop);
+            const auto v_sp = "stop_point:" + Layout::stop_area_name(false, v, v_stop);
+            b.connection(h_sp, v_sp, duration);
+            b.connection(v_sp, h_sp, duration);
+        }
+    }
+}
+
+void add_disruptions(builder& b, const Layout& layout, std::mt19937& rng) {
+    const auto& params = layout.params;
+    std::vector<std::string> line_uris;
+    for (size_t i = 0; i < layout.nb_horizontal_lines; ++i) {
+        line_uris.push_back(Layout::line_uri(true, i));
+    }
+    for (size_t i = 0; i < layout.nb_vertical_lines; ++i) {
+        line_uris.push_back(Layout::line_uri(false, i));
+    }
+    std::shuffle(line_uris.begin(), line_uris.end(), rng);
+
+    const auto& production_period = b.data->meta->production_date;
+    const pt::time_period publication(pt::ptime(production_period.begin()), pt::ptime(production_period.end()));
+    const size_t nb_disruptions = std::min(params.nb_disruptions, line_uris.size());
+    for (size_t i = 0; i < nb_disruptions; ++i) {
+        // a morning peak of one of the first days of the production period
+        const auto day = b.begin + boost::gregorian::days(rng() % 7);
+        const pt::time_period application(pt::ptime(day, pt::hours(6)), pt::hours(4));
+        navitia::apply_disruption(b.impact(nt::RTLevel::Adapted, "disruption:synthetic:" + std::to_string(i))
+                                      .severity(nt::disruption::Effect::NO_SERVICE)
+                                      .on(nt::Type_e::Line, line_uris[i], *b.data->pt_data)
+                                      .application_periods(application)
+                                      .publish(publication)
+                                      .get_disruption(),
+                                  *b.data->pt_data, *b.data->meta);
+    }
+}
+
+}  // namespace
+
+std::unique_ptr<builder> make_synthetic_network(const SyntheticNetworkParams& params) {
+    if (params.nb_lines == 0 || params.nb_stops_by_line < 2) {
+        throw navitia::exception("a synthetic network needs at least one line of two stops");
+    }
+    if (params.headway == 0 || params.vehicle_speed <= 0) {
+        throw navitia::exception("the headway and the speed of a synthetic network must be positive");
+    }
+    const Layout layout(params);
+    std::mt19937 rng(params.seed);
+
+    auto b = std::make_unique<builder>(params.begin_date, [&](builder& b) {
+        for (bool horizontal : {true, false}) {
+            const size_t nb = horizontal ? layout.nb_horizontal_lines : layout.nb_vertical_lines;
+            for (size_t line_pos = 0; line_pos < nb; ++line_pos) {
+                for (size_t stop_pos = 0; stop_pos < params.nb_stops_by_line; ++stop_pos) {
+                    const auto position = layout.stop_position(horizontal, line_pos, stop_pos);
+                    b.sa(Layout::stop_area_name(horizontal, line_pos, stop_pos),
+                         layout.to_coord(position.first, position.second));
+                }
+            }
+        }
+        for (bool horizontal : {true, false}) {
+            const size_t nb = horizontal ? layout.nb_horizontal_lines : layout.nb_vertical_lines;
+            for (size_t line_pos = 0; line_pos < nb; ++line_pos) {
+                add_line(b, layout, horizontal, line_pos, rng);
+            }
+        }
+        add_transfers(b, layout);
+        if (params.street_grid_step != 0) {
+            add_street_grid(b, layout);
+        }
+    });
+
+    b->data->complete();
+    b->manage_admin();
+    b->make();
+
+    if (params.nb_disruptions != 0) {
+        add_disruptions(*b, layout, rng);
+        b->finalize_disruption_batch();
+    }
+    b->data->meta->publication_date = pt::microsec_clock::universal_time();
+    return b;
+}
+
+}  // namespace ed
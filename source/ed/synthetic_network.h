@@ -0,0 +1,88 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "ed/build_helper.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/** Generation of synthetic networks
+ *
+ * Used to produce datasets of a controlled size for the benchmarks and the
+ * micro-benchmarks: the public transport network and the street network are
+ * generated from a few parameters instead of being read from real data.
+ *
+ * The lines are laid out on a square area, half of them horizontally and the
+ * other half vertically, so that each horizontal line crosses each vertical
+ * line. A transfer is created at every crossing. The street network is a
+ * regular grid covering the area, usable by every street network mode.
+ */
+
+namespace ed {
+
+struct SyntheticNetworkParams {
+    size_t nb_lines = 10;
+    size_t nb_stops_by_line = 20;
+    // distance in meters between two consecutive stops of a line
+    uint32_t inter_stop_distance = 500;
+    // one line every 'frequency_line_step' lines of each orientation is a frequency line (0 to disable)
+    size_t frequency_line_step = 4;
+    // service of each line, in seconds since midnight
+    uint32_t start_time = 5 * 3600;
+    uint32_t end_time = 24 * 3600;
+    uint32_t headway = 10 * 60;
+    // speed of the vehicles, in m/s
+    float vehicle_speed = 8.;
+    uint32_t dwell_time = 30;
+    // minimal duration of a transfer, on top of the walking time between the stops
+    uint32_t transfer_duration = 2 * 60;
+    // distance in meters between two intersections of the street grid (0 to disable the street network)
+    uint32_t street_grid_step = 100;
+    // number of lines impacted by a NO_SERVICE disruption
+    size_t nb_disruptions = 0;
+    // the network is centered on this coordinate
+    double center_lon = 2.35;
+    double center_lat = 48.85;
+    std::string begin_date = "20220101";
+    uint32_t seed = 42;
+};
+
+/**
+ * Build a synthetic network according to the params
+ *
+ * The returned data is complete (relations, raptor, proximity lists,
+ * autocomplete, disruptions) and can be used directly or saved in a .nav.lz4
+ */
+std::unique_ptr<builder> make_synthetic_network(const SyntheticNetworkParams& params);
+
+}  // namespace ed
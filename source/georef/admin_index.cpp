@@ -0,0 +1,295 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "georef/admin_index.h"
+
+#include "type/parallel.h"
+
+#include <boost/function_output_iterator.hpp>
+#include <boost/geometry/algorithms/envelope.hpp>
+#include <boost/geometry/algorithms/within.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace navitia {
+namespace georef {
+
+// the grid has about one cell per 4 segments of the boundary, up to MAX_GRID_SIZE cells by side
+static const uint32_t MAX_GRID_SIZE = 32;
+
+// > 0 if c is on the left of the line from a to b, < 0 on its right, 0 on it
+static double orientation(const type::GeographicalCoord& a,
+                          const type::GeographicalCoord& b,
+                          const type::GeographicalCoord& c) {
+    return (b.lon() - a.lon()) * (c.lat() - a.lat()) - (b.lat() - a.lat()) * (c.lon() - a.lon());
+}
+
+// squared distance from coord to the segment from a to b
+static double square_distance(const type::GeographicalCoord& coord,
+                              const type::GeographicalCoord& a,
+                              const type::GeographicalCoord& b) {
+    const double dlon = b.lon() - a.lon();
+    const double dlat = b.lat() - a.lat();
+    const double length = dlon * dlon + dlat * dlat;
+    double t = 0;
+    if (length > 0) {
+        t = std::min(1., std::max(0., ((coord.lon() - a.lon()) * dlon + (coord.lat() - a.lat()) * dlat) / length));
+    }
+    const double lon = a.lon() + t * dlon - coord.lon();
+    const double lat = a.lat() + t * dlat - coord.lat();
+    return lon * lon + lat * lat;
+}
+
+static bool on_segment(const type::GeographicalCoord& coord,
+                       const type::GeographicalCoord& a,
+                       const type::GeographicalCoord& b) {
+    return orientation(a, b, coord) == 0 && std::min(a.lon(), b.lon()) <= coord.lon()
+           && coord.lon() <= std::max(a.lon(), b.lon()) && std::min(a.lat(), b.lat()) <= coord.lat()
+           && coord.lat() <= std::max(a.lat(), b.lat());
+}
+
+AdminBoundaryGrid::AdminBoundaryGrid(const multi_polygon_type& boundary) : boundary(&boundary) {
+    auto add_ring = [&](const polygon_type::ring_type& ring) {
+        for (size_t i = 0; i + 1 < ring.size(); ++i) {
+            segments.emplace_back(ring[i], ring[i + 1]);
+        }
+        if (ring.size() > 1 && ring.front() != ring.back()) {
+            segments.emplace_back(ring.back(), ring.front());
+        }
+    };
+    for (const auto& polygon : boundary) {
+        add_ring(polygon.outer());
+        for (const auto& inner : polygon.inners()) {
+            add_ring(inner);
+        }
+    }
+    if (segments.empty()) {
+        return;
+    }
+
+    const auto envelope = boost::geometry::return_envelope<Box>(boundary);
+    const auto grid_size = std::min(
+        MAX_GRID_SIZE, std::max(uint32_t(1), uint32_t(std::ceil(std::sqrt(double(segments.size()) / 4)))));
+    nb_columns = nb_rows = grid_size;
+    min_lon = envelope.min_corner().lon();
+    min_lat = envelope.min_corner().lat();
+    cell_width = std::max(envelope.max_corner().lon() - min_lon, 1e-9) / nb_columns;
+    cell_height = std::max(envelope.max_corner().lat() - min_lat, 1e-9) / nb_rows;
+
+    // the cells overlapped by the box of each segment, slightly enlarged against the rounding
+    const double margin = 1e-9;
+    auto for_each_cell = [&](const Segment& segment, auto f) {
+        const auto clamp = [](double pos, uint32_t size) {
+            return uint32_t(std::min(std::max(pos, 0.), double(size - 1)));
+        };
+        const auto first_column =
+            clamp(std::floor((std::min(segment.first.lon(), segment.second.lon()) - min_lon) / cell_width - margin),
+                  nb_columns);
+        const auto last_column =
+            clamp(std::floor((std::max(segment.first.lon(), segment.second.lon()) - min_lon) / cell_width + margin),
+                  nb_columns);
+        const auto first_row =
+            clamp(std::floor((std::min(segment.first.lat(), segment.second.lat()) - min_lat) / cell_height - margin),
+                  nb_rows);
+        const auto last_row =
+            clamp(std::floor((std::max(segment.first.lat(), segment.second.lat()) - min_lat) / cell_height + margin),
+                  nb_rows);
+        for (auto row = first_row; row <= last_row; ++row) {
+            for (auto column = first_column; column <= last_column; ++column) {
+                f(row * nb_columns + column);
+            }
+        }
+    };
+    const size_t nb_cells = size_t(nb_columns) * nb_rows;
+    cell_offsets.assign(nb_cells + 1, 0);
+    for (const auto& segment : segments) {
+        for_each_cell(segment, [&](uint32_t cell) { ++cell_offsets[cell + 1]; });
+    }
+    for (size_t cell = 0; cell < nb_cells; ++cell) {
+        cell_offsets[cell + 1] += cell_offsets[cell];
+    }
+    segment_indexes.resize(cell_offsets.back());
+    auto next_index = cell_offsets;
+    for (uint32_t s = 0; s < segments.size(); ++s) {
+        for_each_cell(segments[s], [&](uint32_t cell) { segment_indexes[next_index[cell]++] = s; });
+    }
+
+    // The cells not crossed have the state of their center. Along a row, the consecutive cells not
+    // crossed are on the same side of the boundary, their state is tested once.
+    cells.assign(nb_cells, Cell::Outside);
+    const double min_square_distance = std::pow(1e-6 * std::min(cell_width, cell_height), 2);
+    for (uint32_t row = 0; row < nb_rows; ++row) {
+        bool run_started = false;
+        Cell run_state = Cell::Outside;
+        for (uint32_t column = 0; column < nb_columns; ++column) {
+            const auto cell = row * nb_columns + column;
+            const auto c = center(column, row);
+            if (cell_offsets[cell] == cell_offsets[cell + 1]) {
+                if (!run_started) {
+                    run_state = boost::geometry::within(c, boundary) ? Cell::Inside : Cell::Outside;
+                    run_started = true;
+                }
+                cells[cell] = run_state;
+                continue;
+            }
+            run_started = false;
+            cells[cell] = boost::geometry::within(c, boundary) ? Cell::CrossedInside : Cell::CrossedOutside;
+            // a center almost on the boundary could be on the wrong side after the rounding
+            for (auto i = cell_offsets[cell]; i < cell_offsets[cell + 1]; ++i) {
+                const auto& segment = segments[segment_indexes[i]];
+                if (square_distance(c, segment.first, segment.second) <= min_square_distance) {
+                    cells[cell] = Cell::CrossedOnCenter;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+type::GeographicalCoord AdminBoundaryGrid::center(uint32_t column, uint32_t row) const {
+    return {min_lon + (column + 0.5) * cell_width, min_lat + (row + 0.5) * cell_height};
+}
+
+bool AdminBoundaryGrid::contains(const type::GeographicalCoord& coord) const {
+    if (cells.empty()) {
+        return false;
+    }
+    const double column = std::floor((coord.lon() - min_lon) / cell_width);
+    const double row = std::floor((coord.lat() - min_lat) / cell_height);
+    if (column < 0 || row < 0 || column >= nb_columns || row >= nb_rows) {
+        // out of the envelope
+        return false;
+    }
+    const auto cell = uint32_t(row) * nb_columns + uint32_t(column);
+    switch (cells[cell]) {
+        case Cell::Outside:
+            return false;
+        case Cell::Inside:
+            return true;
+        case Cell::CrossedOnCenter:
+            return boost::geometry::within(coord, *boundary);
+        case Cell::CrossedOutside:
+        case Cell::CrossedInside:
+            break;
+    }
+
+    // The segments from the center to coord and from a to b cross if a and b are on both sides of the
+    // first one and the center and coord on both sides of the second one. The points on the line from
+    // the center to coord are counted on its right, so that a boundary passing through one of its
+    // vertices on the line is counted once.
+    const auto c = center(uint32_t(column), uint32_t(row));
+    bool within = cells[cell] == Cell::CrossedInside;
+    for (auto i = cell_offsets[cell]; i < cell_offsets[cell + 1]; ++i) {
+        const auto& a = segments[segment_indexes[i]].first;
+        const auto& b = segments[segment_indexes[i]].second;
+        if (on_segment(coord, a, b)) {
+            // on the boundary
+            return false;
+        }
+        if ((orientation(c, coord, a) > 0) == (orientation(c, coord, b) > 0)) {
+            continue;
+        }
+        const auto side_center = orientation(a, b, c);
+        const auto side_coord = orientation(a, b, coord);
+        if ((side_center > 0 && side_coord < 0) || (side_center < 0 && side_coord > 0)) {
+            within = !within;
+        }
+    }
+    return within;
+}
+
+void AdminIndex::build(const std::vector<Admin*>& admins_to_index) {
+    clear();
+    for (auto* admin : admins_to_index) {
+        if (!admin->boundary.empty()) {
+            admins.push_back(admin);
+        }
+    }
+    grids.resize(admins.size());
+
+    parallel_for_chunks(admins.size(), 16, 0, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            grids[i] = AdminBoundaryGrid(admins[i]->boundary);
+        }
+    });
+
+    std::vector<Value> values;
+    values.reserve(admins.size());
+    for (size_t i = 0; i < admins.size(); ++i) {
+        values.emplace_back(boost::geometry::return_envelope<Box>(admins[i]->boundary), i);
+    }
+    // packed by the range constructor
+    rtree = decltype(rtree)(values);
+}
+
+void AdminIndex::insert(Admin* admin) {
+    if (admin->boundary.empty()) {
+        return;
+    }
+    rtree.insert({boost::geometry::return_envelope<Box>(admin->boundary), admins.size()});
+    admins.push_back(admin);
+    grids.emplace_back(admin->boundary);
+}
+
+void AdminIndex::clear() {
+    admins.clear();
+    grids.clear();
+    rtree.clear();
+}
+
+std::vector<Admin*> AdminIndex::find(const type::GeographicalCoord& coord) const {
+    std::vector<size_t> candidates;
+    rtree.query(boost::geometry::index::intersects(coord),
+                boost::make_function_output_iterator([&](const Value& value) { candidates.push_back(value.second); }));
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<Admin*> result;
+    for (const auto i : candidates) {
+        if (grids[i].contains(coord)) {
+            result.push_back(admins[i]);
+        }
+    }
+    return result;
+}
+
+std::vector<std::vector<Admin*>> AdminIndex::find(const std::vector<type::GeographicalCoord>& coords) const {
+    std::vector<std::vector<Admin*>> result(coords.size());
+
+    parallel_for_chunks(coords.size(), 256, 0, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = find(coords[i]);
+        }
+    });
+    return result;
+}
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,122 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "georef/adminref.h"
+#include "type/geographical_coord.h"
+
+#include <boost/geometry/index/rtree.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/** Boundary of an admin split in a grid of cells, to know if a coordinate is within it without
+ * going through all the segments of the boundary
+ *
+ * The grid covers the envelope of the boundary. Most cells are not crossed by the boundary,
+ * they are all inside or all outside. A crossed cell keeps the segments crossing it and whether
+ * its center is within the boundary: a coordinate in it is within the boundary if the segment
+ * from the center to the coordinate crosses the boundary an even number of times and the center
+ * is within, or an odd number of times and the center is not.
+ *
+ * The answers are the ones of boost::geometry::within on the boundary, which must outlive the grid.
+ */
+class AdminBoundaryGrid {
+public:
+    AdminBoundaryGrid() = default;
+    explicit AdminBoundaryGrid(const multi_polygon_type& boundary);
+
+    bool contains(const type::GeographicalCoord& coord) const;
+
+private:
+    enum class Cell : uint8_t {
+        Outside,
+        Inside,
+        // crossed by the boundary, with a center not within it
+        CrossedOutside,
+        // crossed by the boundary, with a center within it
+        CrossedInside,
+        // crossed by the boundary on or very near its center, the coordinates are tested on the whole boundary
+        CrossedOnCenter
+    };
+    using Segment = std::pair<type::GeographicalCoord, type::GeographicalCoord>;
+
+    const multi_polygon_type* boundary = nullptr;
+    double min_lon = 0;
+    double min_lat = 0;
+    double cell_width = 1;
+    double cell_height = 1;
+    uint32_t nb_columns = 0;
+    uint32_t nb_rows = 0;
+    std::vector<Cell> cells;
+    // the segments crossing the cell i are segments[segment_indexes[j]] for j in [cell_offsets[i], cell_offsets[i + 1])
+    std::vector<uint32_t> cell_offsets;
+    std::vector<uint32_t> segment_indexes;
+    std::vector<Segment> segments;
+
+    type::GeographicalCoord center(uint32_t column, uint32_t row) const;
+};
+
+/** Index of the admins by their boundary, to find the admins containing a coordinate
+ *
+ * The envelopes of the boundaries are in an R-tree, each boundary being split in an
+ * AdminBoundaryGrid. The admins without boundary are not indexed. It is not serialized, like
+ * the boundaries.
+ */
+class AdminIndex {
+public:
+    /// Index the admins, the grids being built on several threads
+    void build(const std::vector<Admin*>& admins);
+    /// Add an admin to the index
+    void insert(Admin* admin);
+    void clear();
+
+    size_t size() const { return admins.size(); }
+
+    /// The admins whose boundary contains coord, in the order they were indexed
+    std::vector<Admin*> find(const type::GeographicalCoord& coord) const;
+    /// find for each coordinate, on several threads
+    std::vector<std::vector<Admin*>> find(const std::vector<type::GeographicalCoord>& coords) const;
+
+private:
+    using Value = std::pair<Box, size_t>;
+
+    std::vector<Admin*> admins;
+    std::vector<AdminBoundaryGrid> grids;
+    boost::geometry::index::rtree<Value, boost::geometry::index::rstar<16>> rtree;
+};
+
+}  // namespace georef
+}  // namespace navitia
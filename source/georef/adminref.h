@@ -35,7 +35,6 @@ www.navitia.io
 
 #include <boost/geometry/geometries/polygon.hpp>
 #include <boost/geometry/geometries/box.hpp>
-#include <RTree/RTree.h>
 
 #include <unordered_map>
 
@@ -96,8 +95,5 @@ struct Admin : nt::Header, nt::Nameable {
             odt_stop_points& postal_codes;
     }
 };
-
-using AdminRtree = RTree<Admin*, double, 2>;
-AdminRtree build_admins_tree(const std::vector<Admin*> admins);
 }  // namespace georef
 }  // namespace navitia
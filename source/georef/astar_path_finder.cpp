@@ -35,6 +35,8 @@ www.navitia.io
 #include <boost/graph/astar_search.hpp>
 #include <boost/graph/filtered_graph.hpp>
 
+#include <cmath>
+
 namespace navitia {
 namespace georef {
 
@@ -48,12 +50,12 @@ void AstarPathFinder::init(const type::GeographicalCoord& start_coord,
 
     // we initialize the costs to the maximum value
     size_t n = boost::num_vertices(geo_ref.graph);
-    costs.assign(n, bt::pos_infin);
+    costs.reset(n, bt::pos_infin);
 
     if (starting_edge.found) {
-        costs.at(starting_edge[source_e]) =
+        costs[starting_edge[source_e]] =
             compute_cost_from_starting_edge_to_dist(starting_edge[source_e], dest_projected_coord);
-        costs.at(starting_edge[target_e]) =
+        costs[starting_edge[target_e]] =
             compute_cost_from_starting_edge_to_dist(starting_edge[target_e], dest_projected_coord);
     }
 }
@@ -74,6 +76,55 @@ void AstarPathFinder::start_distance_or_target_astar(const navitia::time_duratio
     }
 }
 
+std::pair<navitia::time_duration, ProjectionData::Direction> AstarPathFinder::start_contraction_hierarchy(
+    const ContractionHierarchy& ch,
+    const navitia::time_duration& radius,
+    const ProjectionData& target) {
+    constexpr auto max = bt::pos_infin;
+    if (!starting_edge.found || !target.found) {
+        return {max, source_e};
+    }
+    computation_launch = true;
+
+    std::vector<std::pair<vertex_t, double>> sources;
+    std::vector<std::pair<vertex_t, double>> targets;
+    for (const auto direction : {source_e, target_e}) {
+        const auto source = starting_edge[direction];
+        if (distances[source] != max) {
+            sources.emplace_back(source, double(distances[source].ticks()));
+        }
+        // as in find_nearest_vertex, when the target is projected on a node we go directly to this node
+        const auto projection_duration =
+            target.distances[direction] < 0.01 ? navitia::seconds(0) : crow_fly_duration(target.distances[direction]);
+        targets.emplace_back(target[direction], double(projection_duration.ticks()));
+    }
+
+    const auto result = ch_query.shortest_path(ch, sources, targets, speed_factor, double(radius.ticks()));
+    if (result.path.empty()) {
+        return {max, source_e};
+    }
+
+    // the path is stored as an astar would have done, to be built the same way
+    const auto combiner = SpeedDistanceCombiner(speed_factor);
+    const auto& csr = geo_ref.csr_graph;
+    predecessors[result.path.front()] = result.path.front();
+    for (size_t i = 1; i < result.path.size(); ++i) {
+        const auto u = result.path[i - 1];
+        const auto v = result.path[i];
+        auto duration = navitia::time_duration(bt::pos_infin);
+        for (auto range = csr.out_edges(u); range.first != range.second; ++range.first) {
+            if (csr.target(*range.first) == v && csr.duration(*range.first) < duration) {
+                duration = csr.duration(*range.first);
+            }
+        }
+        predecessors[v] = u;
+        distances[v] = combiner(distances[u], duration);
+    }
+
+    const auto direction = result.path.back() == target[source_e] ? source_e : target_e;
+    return {navitia::time_duration(0, 0, 0, std::llround(result.cost)), direction};
+}
+
 /**
  * Launch an astar without initializing the data structure
  * Warning, it modifies the distances and the predecessors
@@ -84,17 +135,23 @@ void AstarPathFinder::astar(const std::array<georef::vertex_t, 2>& origin_vertex
     // Note: the predecessors have been updated in init
 
     // Fill color map in white before A*
-    std::fill(color.data.get(),
-              color.data.get()
-                  + (color.n + boost::two_bit_color_map<>::elements_per_char - 1)
-                        / boost::two_bit_color_map<>::elements_per_char,
-              0);
+    color.reset(boost::num_vertices(geo_ref.graph), boost::color_traits<boost::two_bit_color_type>::white());
+
+    auto filter = TransportationModeFilter(mode, geo_ref);
+    auto combiner = SpeedDistanceCombiner(speed_factor);
 
     // we filter the graph to only use certain mean of transport
+    // the compact copy of the graph is used when it is up to date
+    if (geo_ref.csr_graph.is_built_for(geo_ref.graph)) {
+        using filtered_csr = boost::filtered_graph<CsrGraph, boost::keep_all, TransportationModeFilter>;
+        auto g = filtered_csr(geo_ref.csr_graph, {}, filter);
+        astar_shortest_paths_no_init_with_heap(g, origin_vertexes.front(), origin_vertexes.back(), heuristic, visitor,
+                                               CsrDurationMap{&geo_ref.csr_graph}, combiner);
+        return;
+    }
     using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, TransportationModeFilter>;
-    auto g = filtered_graph(geo_ref.graph, {}, TransportationModeFilter(mode, geo_ref));
+    auto g = filtered_graph(geo_ref.graph, {}, filter);
     auto weight_map = boost::get(&Edge::duration, geo_ref.graph);
-    auto combiner = SpeedDistanceCombiner(speed_factor);
 
     astar_shortest_paths_no_init_with_heap(g, origin_vertexes.front(), origin_vertexes.back(), heuristic, visitor,
                                            weight_map, combiner);
@@ -109,16 +166,20 @@ void AstarPathFinder::astar_shortest_paths_no_init_with_heap(const Graph& g,
                                                              const WeightMap& weight,
                                                              const SpeedDistanceCombiner& combine,
                                                              const Compare& compare) {
-    using MutableQueue = boost::d_ary_heap_indirect<vertex_t, 4, vertex_t*, navitia::time_duration*, Compare>;
-    MutableQueue Q(&costs[0], &index_in_heap_map[0], compare);
+    using IndexInHeapMap = SparseVertexMap<std::size_t>::PropertyMap;
+    using DistanceMap = SparseVertexMap<navitia::time_duration>::PropertyMap;
+    using PredecessorMap = SparseVertexMap<vertex_t>::PropertyMap;
+    using ColorMap = SparseVertexMap<boost::two_bit_color_type>::PropertyMap;
+    using MutableQueue = boost::d_ary_heap_indirect<vertex_t, 4, IndexInHeapMap, DistanceMap, Compare>;
+    MutableQueue Q(costs.property_map(), index_in_heap_map.property_map(), compare);
 
     boost::detail::astar_bfs_visitor<astar_distance_heuristic, astar_distance_or_target_visitor, MutableQueue,
-                                     vertex_t*, navitia::time_duration*, navitia::time_duration*, WeightMap,
-                                     boost::two_bit_color_map<>, SpeedDistanceCombiner, Compare>
-        bfs_vis(h, vis, Q, &predecessors[0], &costs[0], &distances[0], weight, color, combine, compare,
-                navitia::seconds(0));
+                                     PredecessorMap, DistanceMap, DistanceMap, WeightMap, ColorMap,
+                                     SpeedDistanceCombiner, Compare>
+        bfs_vis(h, vis, Q, predecessors.property_map(), costs.property_map(), distances.property_map(), weight,
+                color.property_map(), combine, compare, navitia::seconds(0));
 
-    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, color);
+    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, color.property_map());
 }
 
 // The cost of a starting edge is the distance from this edge to the projected destination point (distance_to_dest)
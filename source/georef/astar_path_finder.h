@@ -56,7 +56,7 @@ struct astar_distance_heuristic : public boost::astar_heuristic<Graph, navitia::
 class AstarPathFinder : public PathFinder {
 public:
     // Distance array for the Astar
-    std::vector<navitia::time_duration> costs;
+    SparseVertexMap<navitia::time_duration> costs;
 
     AstarPathFinder(const GeoRef& geo_ref) : PathFinder(geo_ref) {}
     AstarPathFinder(const AstarPathFinder& o) = default;
@@ -71,6 +71,17 @@ public:
                                         const type::GeographicalCoord& dest_projected,
                                         const std::vector<vertex_t>& destinations);
 
+    /**
+     * Compute the path to the target with a contraction hierarchy instead of the astar
+     * The searches stop at radius, like the astar
+     * Only the distances and the predecessors of the vertices of the path are updated
+     * return the distance to the target and the vertex of its edge to use, like find_nearest_vertex
+     **/
+    std::pair<navitia::time_duration, ProjectionData::Direction> start_contraction_hierarchy(
+        const ContractionHierarchy& ch,
+        const navitia::time_duration& radius,
+        const ProjectionData& target);
+
     /**
      * Launch an astar without initializing the data structure
      * Warning, it modifies the distances and the predecessors
@@ -80,6 +91,9 @@ public:
                const astar_distance_or_target_visitor& visitor);
 
 private:
+    // buffers of the contraction hierarchy queries
+    ContractionHierarchyQuery ch_query;
+
     template <class Graph, class WeightMap, class Compare = std::less<navitia::time_duration>>
     void astar_shortest_paths_no_init_with_heap(const Graph& g,
                                                 const vertex_t& s_begin,
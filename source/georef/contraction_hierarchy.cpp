@@ -0,0 +1,491 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "georef/contraction_hierarchy.h"
+
+#include "georef/csr_graph.h"
+#include "georef/georef.h"
+#include "utils/exception.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+
+namespace navitia {
+namespace georef {
+
+constexpr uint32_t ContractionHierarchy::no_middle;
+constexpr vertex_t ContractionHierarchyQuery::invalid_vertex;
+
+namespace {
+
+using ChEdge = ContractionHierarchy::ChEdge;
+
+// number of vertices settled by a witness search, more gives less shortcuts but a longer build
+constexpr size_t max_settled_for_priority = 50;
+constexpr size_t max_settled_for_contraction = 500;
+
+constexpr uint64_t infinite_cost = std::numeric_limits<uint64_t>::max();
+
+/// Remaining graph during the contraction: the edges between the vertices not yet contracted
+struct RemainingGraph {
+    std::vector<std::vector<ChEdge>> out;
+    std::vector<std::vector<ChEdge>> in;
+
+    explicit RemainingGraph(size_t nb_vertices) : out(nb_vertices), in(nb_vertices) {}
+
+    // only the fastest of the parallel edges is kept
+    static void upsert(std::vector<ChEdge>& edges, const ChEdge& edge) {
+        for (auto& e : edges) {
+            if (e.other == edge.other) {
+                if (edge.duration < e.duration) {
+                    e = edge;
+                }
+                return;
+            }
+        }
+        edges.push_back(edge);
+    }
+
+    static void erase(std::vector<ChEdge>& edges, uint32_t other) {
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [&](const ChEdge& e) { return e.other == other; }),
+                    edges.end());
+    }
+
+    void add_edge(uint32_t u, uint32_t w, uint32_t duration, uint32_t middle) {
+        upsert(out[u], {w, duration, middle});
+        upsert(in[w], {u, duration, middle});
+    }
+};
+
+struct Shortcut {
+    uint32_t source;
+    uint32_t target;
+    uint32_t duration;
+};
+
+/// Bounded Dijkstra on the remaining graph, looking for paths not going through the contracted vertex
+class WitnessSearch {
+public:
+    explicit WitnessSearch(size_t nb_vertices) : costs(nb_vertices, infinite_cost), target_marks(nb_vertices, 0) {}
+
+    // the search stops when all the out neighbors of the avoided vertex are settled
+    void run(const RemainingGraph& graph, uint32_t source, uint32_t avoided, uint64_t max_cost, size_t max_settled) {
+        for (auto v : touched) {
+            costs[v] = infinite_cost;
+        }
+        touched.clear();
+        queue.clear();
+
+        ++mark;
+        size_t nb_targets = 0;
+        for (const auto& e : graph.out[avoided]) {
+            if (e.other != source) {
+                target_marks[e.other] = mark;
+                ++nb_targets;
+            }
+        }
+
+        costs[source] = 0;
+        touched.push_back(source);
+        push(0, source);
+        size_t nb_settled = 0;
+        while (!queue.empty() && nb_settled < max_settled && nb_targets > 0) {
+            const auto top = pop();
+            if (top.first > costs[top.second]) {
+                continue;
+            }
+            if (top.first > max_cost) {
+                break;
+            }
+            ++nb_settled;
+            if (target_marks[top.second] == mark) {
+                --nb_targets;
+            }
+            for (const auto& e : graph.out[top.second]) {
+                if (e.other == avoided) {
+                    continue;
+                }
+                const uint64_t cost = top.first + e.duration;
+                if (cost < costs[e.other]) {
+                    if (costs[e.other] == infinite_cost) {
+                        touched.push_back(e.other);
+                    }
+                    costs[e.other] = cost;
+                    push(cost, e.other);
+                }
+            }
+        }
+    }
+
+    uint64_t cost(uint32_t v) const { return costs[v]; }
+
+private:
+    using Entry = std::pair<uint64_t, uint32_t>;
+
+    void push(uint64_t cost, uint32_t v) {
+        queue.emplace_back(cost, v);
+        std::push_heap(queue.begin(), queue.end(), std::greater<Entry>());
+    }
+    Entry pop() {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<Entry>());
+        const auto top = queue.back();
+        queue.pop_back();
+        return top;
+    }
+
+    std::vector<uint64_t> costs;
+    std::vector<uint32_t> touched;
+    // the heap is kept between the searches to avoid the allocations
+    std::vector<Entry> queue;
+    std::vector<uint32_t> target_marks;
+    uint32_t mark = 0;
+};
+
+/// Shortcuts needed to contract v: the paths u -> v -> w without a witness as short
+void find_shortcuts(const RemainingGraph& graph,
+                    WitnessSearch& witness,
+                    uint32_t v,
+                    size_t max_settled,
+                    std::vector<Shortcut>& shortcuts) {
+    shortcuts.clear();
+    const auto& out = graph.out[v];
+    for (const auto& in_edge : graph.in[v]) {
+        const uint32_t u = in_edge.other;
+        bool has_other_neighbor = false;
+        uint64_t max_cost = 0;
+        for (const auto& out_edge : out) {
+            if (out_edge.other != u) {
+                has_other_neighbor = true;
+                max_cost = std::max(max_cost, uint64_t(in_edge.duration) + out_edge.duration);
+            }
+        }
+        if (!has_other_neighbor) {
+            continue;
+        }
+        witness.run(graph, u, v, max_cost, max_settled);
+        for (const auto& out_edge : out) {
+            if (out_edge.other == u) {
+                continue;
+            }
+            const uint64_t cost = uint64_t(in_edge.duration) + out_edge.duration;
+            if (witness.cost(out_edge.other) > cost) {
+                if (cost > std::numeric_limits<uint32_t>::max()) {
+                    throw navitia::exception("contraction hierarchy: shortcut duration overflow");
+                }
+                shortcuts.push_back({u, out_edge.other, uint32_t(cost)});
+            }
+        }
+    }
+}
+
+void pack(const std::vector<std::vector<ChEdge>>& edges_by_vertex,
+          std::vector<uint32_t>& offsets,
+          std::vector<ChEdge>& edges) {
+    offsets.clear();
+    offsets.reserve(edges_by_vertex.size() + 1);
+    offsets.push_back(0);
+    size_t nb_edges = 0;
+    for (const auto& v_edges : edges_by_vertex) {
+        nb_edges += v_edges.size();
+        offsets.push_back(uint32_t(nb_edges));
+    }
+    edges.clear();
+    edges.reserve(nb_edges);
+    for (const auto& v_edges : edges_by_vertex) {
+        edges.insert(edges.end(), v_edges.begin(), v_edges.end());
+    }
+}
+
+}  // namespace
+
+void ContractionHierarchy::build(const CsrGraph& graph, const std::function<bool(vertex_t)>& keep_vertex) {
+    const size_t nb_vertices = graph.num_vertices();
+    fingerprint = graph.source_fingerprint();
+    if (nb_vertices >= std::numeric_limits<uint32_t>::max()) {
+        throw navitia::exception("too many vertices in the street network for the contraction hierarchy");
+    }
+
+    RemainingGraph remaining(nb_vertices);
+    std::vector<uint32_t> to_contract;
+    for (vertex_t v = 0; v < nb_vertices; ++v) {
+        if (!keep_vertex(v)) {
+            continue;
+        }
+        to_contract.push_back(uint32_t(v));
+        for (auto range = graph.out_edges(v); range.first != range.second; ++range.first) {
+            const auto e = *range.first;
+            const vertex_t w = graph.target(e);
+            if (w == v || !keep_vertex(w)) {
+                continue;
+            }
+            remaining.add_edge(uint32_t(v), uint32_t(w), uint32_t(graph.duration(e).ticks()), no_middle);
+        }
+    }
+
+    WitnessSearch witness(nb_vertices);
+    std::vector<Shortcut> shortcuts;
+    std::vector<int> nb_contracted_neighbors(nb_vertices, 0);
+    // the fewer edges the contraction adds, and the fewer neighbors already contracted, the sooner
+    auto priority = [&](uint32_t v) {
+        find_shortcuts(remaining, witness, v, max_settled_for_priority, shortcuts);
+        return 2 * (int(shortcuts.size()) - int(remaining.out[v].size() + remaining.in[v].size()))
+               + nb_contracted_neighbors[v];
+    };
+
+    using Entry = std::pair<int, uint32_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    std::vector<int> priorities(nb_vertices, 0);
+    for (auto v : to_contract) {
+        priorities[v] = priority(v);
+        queue.push({priorities[v], v});
+    }
+
+    ranks.assign(nb_vertices, std::numeric_limits<uint32_t>::max());
+    std::vector<std::vector<ChEdge>> up_by_vertex(nb_vertices);
+    std::vector<std::vector<ChEdge>> down_by_vertex(nb_vertices);
+    uint32_t next_rank = 0;
+    while (!queue.empty()) {
+        const auto top = queue.top();
+        queue.pop();
+        const uint32_t v = top.second;
+        if (ranks[v] != std::numeric_limits<uint32_t>::max() || top.first != priorities[v]) {
+            continue;
+        }
+        // lazy update: the priority may have grown since it was computed
+        priorities[v] = priority(v);
+        if (!queue.empty() && priorities[v] > queue.top().first) {
+            queue.push({priorities[v], v});
+            continue;
+        }
+
+        ranks[v] = next_rank++;
+        find_shortcuts(remaining, witness, v, max_settled_for_contraction, shortcuts);
+
+        // the remaining neighbors will all have a higher rank
+        std::vector<uint32_t> neighbors;
+        for (const auto& e : remaining.out[v]) {
+            up_by_vertex[v].push_back(e);
+            RemainingGraph::erase(remaining.in[e.other], v);
+            neighbors.push_back(e.other);
+        }
+        for (const auto& e : remaining.in[v]) {
+            down_by_vertex[v].push_back(e);
+            RemainingGraph::erase(remaining.out[e.other], v);
+            neighbors.push_back(e.other);
+        }
+        std::vector<ChEdge>().swap(remaining.out[v]);
+        std::vector<ChEdge>().swap(remaining.in[v]);
+        for (const auto& shortcut : shortcuts) {
+            remaining.add_edge(shortcut.source, shortcut.target, shortcut.duration, v);
+        }
+
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+        for (auto n : neighbors) {
+            ++nb_contracted_neighbors[n];
+            priorities[n] = priority(n);
+            queue.push({priorities[n], n});
+        }
+    }
+
+    pack(up_by_vertex, up_offsets, up_edges);
+    pack(down_by_vertex, down_offsets, down_edges);
+}
+
+bool ContractionHierarchy::is_built_for(const CsrGraph& graph) const {
+    return fingerprint == graph.source_fingerprint() && num_vertices() == graph.num_vertices();
+}
+
+void ContractionHierarchy::unpack(vertex_t u, vertex_t w, uint32_t middle, std::vector<vertex_t>& path) const {
+    auto find = [](std::pair<const ChEdge*, const ChEdge*> edges, vertex_t other) -> const ChEdge& {
+        for (; edges.first != edges.second; ++edges.first) {
+            if (edges.first->other == other) {
+                return *edges.first;
+            }
+        }
+        throw navitia::exception("contraction hierarchy: unable to unpack a shortcut");
+    };
+
+    // the shortcuts to unpack, the next one on top
+    struct ToUnpack {
+        vertex_t source;
+        vertex_t target;
+        uint32_t middle;
+    };
+    std::vector<ToUnpack> stack{{u, w, middle}};
+    while (!stack.empty()) {
+        const auto current = stack.back();
+        stack.pop_back();
+        if (current.middle == no_middle) {
+            path.push_back(current.target);
+            continue;
+        }
+        // source -> middle is stored on the middle as a down edge, middle -> target as an up edge
+        const auto& second = find(up(current.middle), current.target);
+        const auto& first = find(down(current.middle), current.source);
+        stack.push_back({current.middle, current.target, second.middle});
+        stack.push_back({current.source, current.middle, first.middle});
+    }
+}
+
+void ContractionHierarchyQuery::prepare(const ContractionHierarchy& ch) {
+    forward.reset(ch.num_vertices(), Label());
+    backward.reset(ch.num_vertices(), Label());
+}
+
+ContractionHierarchyQuery::Result ContractionHierarchyQuery::shortest_path(
+    const ContractionHierarchy& ch,
+    const std::vector<std::pair<vertex_t, double>>& sources,
+    const std::vector<std::pair<vertex_t, double>>& targets,
+    float speed_factor,
+    double max_cost) {
+    prepare(ch);
+
+    using Entry = std::pair<double, vertex_t>;
+    using Queue = std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>>;
+    Queue forward_queue;
+    Queue backward_queue;
+    auto init = [&](const std::vector<std::pair<vertex_t, double>>& seeds, Labels& labels, Queue& queue) {
+        for (const auto& seed : seeds) {
+            if (seed.second <= max_cost && seed.second < labels[seed.first].cost) {
+                labels[seed.first].cost = seed.second;
+                queue.push({seed.second, seed.first});
+            }
+        }
+    };
+    init(sources, forward, forward_queue);
+    init(targets, backward, backward_queue);
+
+    const double inv_speed_factor = 1. / speed_factor;
+    double best_cost = std::numeric_limits<double>::infinity();
+    vertex_t meeting = invalid_vertex;
+    // settle the next vertex of one of the searches, the searches go up the hierarchy
+    auto settle = [&](Queue& queue, Labels& labels, const Labels& other_labels, bool is_forward) {
+        const auto top = queue.top();
+        queue.pop();
+        const vertex_t u = top.second;
+        if (top.first > labels[u].cost) {
+            return;
+        }
+        if (top.first + other_labels[u].cost < best_cost) {
+            best_cost = top.first + other_labels[u].cost;
+            meeting = u;
+        }
+        const auto edges = is_forward ? ch.up(u) : ch.down(u);
+        for (auto e = edges.first; e != edges.second; ++e) {
+            const double cost = top.first + e->duration * inv_speed_factor;
+            // read first, a label is only allocated when it is written
+            if (cost <= max_cost && cost < static_cast<const Labels&>(labels)[e->other].cost) {
+                auto& label = labels[e->other];
+                label.cost = cost;
+                label.parent = u;
+                label.middle = e->middle;
+                queue.push({cost, e->other});
+            }
+        }
+    };
+
+    // each search stops when it can no longer improve the best path
+    while (true) {
+        const bool forward_done = forward_queue.empty() || forward_queue.top().first >= best_cost;
+        const bool backward_done = backward_queue.empty() || backward_queue.top().first >= best_cost;
+        if (forward_done && backward_done) {
+            break;
+        }
+        if (backward_done || (!forward_done && forward_queue.top().first <= backward_queue.top().first)) {
+            settle(forward_queue, forward, backward, true);
+        } else {
+            settle(backward_queue, backward, forward, false);
+        }
+    }
+
+    Result result;
+    if (meeting == invalid_vertex || best_cost > max_cost) {
+        return result;
+    }
+    result.cost = best_cost;
+
+    // the forward part of the path is read backward, from the meeting vertex to the source
+    std::vector<vertex_t> forward_part;
+    for (vertex_t v = meeting; v != invalid_vertex; v = forward[v].parent) {
+        forward_part.push_back(v);
+    }
+    result.path.push_back(forward_part.back());
+    for (size_t i = forward_part.size() - 1; i > 0; --i) {
+        const vertex_t v = forward_part[i - 1];
+        ch.unpack(forward_part[i], v, forward[v].middle, result.path);
+    }
+    for (vertex_t v = meeting; backward[v].parent != invalid_vertex; v = backward[v].parent) {
+        ch.unpack(v, backward[v].parent, backward[v].middle, result.path);
+    }
+    return result;
+}
+
+void ContractionHierarchyQuery::upward_search(const ContractionHierarchy& ch,
+                                              const std::vector<std::pair<vertex_t, double>>& seeds,
+                                              float speed_factor,
+                                              double max_cost,
+                                              bool is_forward,
+                                              const std::function<void(vertex_t, double)>& on_settle) {
+    prepare(ch);
+
+    using Entry = std::pair<double, vertex_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+    for (const auto& seed : seeds) {
+        if (seed.second <= max_cost && seed.second < forward[seed.first].cost) {
+            forward[seed.first].cost = seed.second;
+            queue.push({seed.second, seed.first});
+        }
+    }
+
+    const double inv_speed_factor = 1. / speed_factor;
+    while (!queue.empty()) {
+        const auto top = queue.top();
+        queue.pop();
+        const vertex_t u = top.second;
+        if (top.first > forward[u].cost) {
+            continue;
+        }
+        on_settle(u, top.first);
+        const auto edges = is_forward ? ch.up(u) : ch.down(u);
+        for (auto e = edges.first; e != edges.second; ++e) {
+            const double cost = top.first + e->duration * inv_speed_factor;
+            if (cost <= max_cost && cost < static_cast<const Labels&>(forward)[e->other].cost) {
+                forward[e->other].cost = cost;
+                queue.push({cost, e->other});
+            }
+        }
+    }
+}
+
+}  // namespace georef
+}  // namespace navitia
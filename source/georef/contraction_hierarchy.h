@@ -0,0 +1,165 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "georef/georef_types.h"
+#include "georef/sparse_vertex_map.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+class CsrGraph;
+
+/** Contraction hierarchy of the part of the street graph used by a transportation mode
+ *
+ * The vertices are contracted one by one, from the least to the most important,
+ * and shortcuts are added between their neighbors when no other path (witness)
+ * is as short. Each edge is then stored on its lowest ranked extremity:
+ *  - up_edges[v] are the edges v -> w with rank(w) > rank(v),
+ *  - down_edges[v] are the edges w -> v with rank(w) > rank(v).
+ * A shortest path only climbs the hierarchy from the source and only climbs
+ * it backward from the target, so a query explores a few hundred vertices
+ * whatever the length of the path.
+ *
+ * A shortcut u -> w remembers the contracted vertex it bypasses, u -> v -> w,
+ * and is unpacked recursively into the edges of the street graph.
+ *
+ * The durations are in ticks of navitia::time_duration, without speed factor:
+ * the speed factor applies the same ratio to all the edges and does not change the paths.
+ */
+class ContractionHierarchy {
+public:
+    static constexpr uint32_t no_middle = std::numeric_limits<uint32_t>::max();
+
+    struct ChEdge {
+        uint32_t other;
+        uint32_t duration;
+        // contracted vertex bypassed by the shortcut, no_middle for an edge of the street graph
+        uint32_t middle;
+    };
+
+    /// Contract the vertices of the graph accepted by keep_vertex
+    void build(const CsrGraph& graph, const std::function<bool(vertex_t)>& keep_vertex);
+
+    size_t num_vertices() const { return ranks.size(); }
+    size_t num_edges() const { return up_edges.size() + down_edges.size(); }
+    /// Cheap check that the hierarchy has been built for a graph with the same vertices and edges
+    bool is_built_for(const CsrGraph& graph) const;
+
+    uint32_t rank(vertex_t v) const { return ranks[v]; }
+    std::pair<const ChEdge*, const ChEdge*> up(vertex_t v) const {
+        return {up_edges.data() + up_offsets[v], up_edges.data() + up_offsets[v + 1]};
+    }
+    std::pair<const ChEdge*, const ChEdge*> down(vertex_t v) const {
+        return {down_edges.data() + down_offsets[v], down_edges.data() + down_offsets[v + 1]};
+    }
+
+    /// Append to path the vertices after u of the shortest path u -> w represented by the edge, u excluded
+    void unpack(vertex_t u, vertex_t w, uint32_t middle, std::vector<vertex_t>& path) const;
+
+private:
+    // fingerprint of the street graph of the compact graph it has been built from
+    uint64_t fingerprint = 0;
+    std::vector<uint32_t> ranks;
+    std::vector<uint32_t> up_offsets;
+    std::vector<ChEdge> up_edges;
+    std::vector<uint32_t> down_offsets;
+    std::vector<ChEdge> down_edges;
+};
+
+/** Bidirectional query on a ContractionHierarchy
+ *
+ * Holds the buffers of the searches so that they are allocated once by path finder.
+ * The labels are in SparseVertexMap, their memory and their reset grow with the searched
+ * vertices. Going up the hierarchy the searches are scattered, the pages are small.
+ */
+class ContractionHierarchyQuery {
+public:
+    static constexpr vertex_t invalid_vertex = std::numeric_limits<vertex_t>::max();
+
+    struct Result {
+        // vertices of the path in the street graph, from a source to a target, empty if no path was found
+        std::vector<vertex_t> path;
+        // cost of the path, with the speed factor and the costs of the source and the target, in ticks
+        double cost = std::numeric_limits<double>::infinity();
+    };
+
+    /**
+     * Find the shortest path from one of the sources to one of the targets
+     *
+     * The sources and targets come with an initial cost in ticks (the projection on the
+     * street graph), the edges durations are divided by the speed factor.
+     * The searches stop at max_cost, no path is found if it costs more.
+     */
+    Result shortest_path(const ContractionHierarchy& ch,
+                         const std::vector<std::pair<vertex_t, double>>& sources,
+                         const std::vector<std::pair<vertex_t, double>>& targets,
+                         float speed_factor,
+                         double max_cost = std::numeric_limits<double>::infinity());
+
+    /**
+     * Settle all the vertices reached going up the hierarchy from the seeds, up to max_cost
+     *
+     * The forward search follows the up edges, from the origins, the backward search
+     * follows the down edges, from the destinations. The settled vertices and their
+     * costs are given to on_settle, to be joined with the searches of the other side.
+     */
+    void upward_search(const ContractionHierarchy& ch,
+                       const std::vector<std::pair<vertex_t, double>>& seeds,
+                       float speed_factor,
+                       double max_cost,
+                       bool is_forward,
+                       const std::function<void(vertex_t, double)>& on_settle);
+
+private:
+    struct Label {
+        double cost = std::numeric_limits<double>::infinity();
+        vertex_t parent = invalid_vertex;
+        uint32_t middle = ContractionHierarchy::no_middle;
+    };
+
+    // size the labels for the hierarchy, or reset the ones used by the previous query
+    void prepare(const ContractionHierarchy& ch);
+
+    using Labels = SparseVertexMap<Label, 6>;
+
+    Labels forward;
+    Labels backward;
+};
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,181 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "georef/csr_graph.h"
+
+#include "georef/georef.h"
+#include "utils/exception.h"
+
+#include <array>
+
+namespace navitia {
+namespace georef {
+
+constexpr uint32_t CsrGraph::transfer_flag;
+
+namespace {
+
+constexpr size_t max_nb_copies = 8;
+
+struct StreetEdge {
+    uint32_t target;
+    nt::idx_t way_idx;
+    nt::idx_t geom_idx;
+    uint8_t copies;
+    std::array<int32_t, max_nb_copies> durations;
+};
+
+struct Transfer {
+    vertex_t source;
+    vertex_t target;
+    int32_t duration;
+    nt::idx_t way_idx;
+    nt::idx_t geom_idx;
+};
+
+}  // namespace
+
+uint64_t graph_fingerprint(const Graph& graph) {
+    // FNV-1a on the 64 bits words
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](uint64_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+    add(boost::num_vertices(graph));
+    for (vertex_t v = 0; v < boost::num_vertices(graph); ++v) {
+        for (auto range = boost::out_edges(v, graph); range.first != range.second; ++range.first) {
+            const Edge& edge = graph[*range.first];
+            add(v);
+            add(boost::target(*range.first, graph));
+            add(uint64_t(edge.duration.ticks()));
+            add(edge.way_idx);
+        }
+    }
+    return hash;
+}
+
+void CsrGraph::build(const Graph& graph, size_t nb_vertex_by_mode) {
+    source_graph = &graph;
+    fingerprint = graph_fingerprint(graph);
+    nb_vertices = boost::num_vertices(graph);
+    // a graph not split in copies is a single copy
+    if (nb_vertex_by_mode == 0 || nb_vertices % nb_vertex_by_mode != 0) {
+        nb_vertex_by_mode = nb_vertices;
+    }
+    nb_vertex_by_copy = std::max<size_t>(nb_vertex_by_mode, 1);
+    nb_copies = std::max<size_t>(nb_vertices / nb_vertex_by_copy, 1);
+    if (nb_copies > max_nb_copies) {
+        throw navitia::exception("too many copies of the street network for the compact graph");
+    }
+
+    offsets.clear();
+    offsets.reserve(nb_vertex_by_copy + 1);
+    targets.clear();
+    copies.clear();
+    durations.clear();
+    way_idxs.clear();
+    geom_idxs.clear();
+
+    std::vector<StreetEdge> street_edges;
+    std::vector<Transfer> transfers;
+    offsets.push_back(0);
+    for (vertex_t local = 0; local < nb_vertex_by_copy && local < nb_vertices; ++local) {
+        street_edges.clear();
+        for (size_t copy = 0; copy < nb_copies; ++copy) {
+            const vertex_t v = copy * nb_vertex_by_copy + local;
+            const auto bit = uint8_t(1 << copy);
+            // the copies add their edges in the same order, an edge is looked for after the previous one
+            size_t cursor = 0;
+            for (auto range = boost::out_edges(v, graph); range.first != range.second; ++range.first) {
+                const Edge& edge = graph[*range.first];
+                const vertex_t t = boost::target(*range.first, graph);
+                if (t / nb_vertex_by_copy != copy) {
+                    transfers.push_back({v, t, int32_t(edge.duration.ticks()), edge.way_idx, edge.geom_idx});
+                    continue;
+                }
+                const auto local_target = uint32_t(t - copy * nb_vertex_by_copy);
+                auto it = std::find_if(street_edges.begin() + cursor, street_edges.end(), [&](const StreetEdge& e) {
+                    return e.target == local_target && e.way_idx == edge.way_idx && e.geom_idx == edge.geom_idx
+                           && !(e.copies & bit);
+                });
+                if (it == street_edges.end()) {
+                    it = street_edges.insert(street_edges.begin() + cursor,
+                                             StreetEdge{local_target, edge.way_idx, edge.geom_idx, 0, {}});
+                }
+                it->copies |= bit;
+                it->durations[copy] = int32_t(edge.duration.ticks());
+                cursor = size_t(it - street_edges.begin()) + 1;
+            }
+        }
+        for (const auto& e : street_edges) {
+            targets.push_back(e.target);
+            copies.push_back(e.copies);
+            durations.insert(durations.end(), e.durations.begin(), e.durations.begin() + nb_copies);
+            way_idxs.push_back(e.way_idx);
+            geom_idxs.push_back(e.geom_idx);
+        }
+        if (targets.size() >= transfer_flag) {
+            throw navitia::exception("too many edges in the street network for the compact graph");
+        }
+        offsets.push_back(uint32_t(targets.size()));
+    }
+    targets.shrink_to_fit();
+    copies.shrink_to_fit();
+    durations.shrink_to_fit();
+    way_idxs.shrink_to_fit();
+    geom_idxs.shrink_to_fit();
+
+    // the transfers of a vertex stay in the order of the graph
+    std::stable_sort(transfers.begin(), transfers.end(),
+                     [](const Transfer& a, const Transfer& b) { return a.source < b.source; });
+    has_transfers.assign(nb_vertices, false);
+    transfer_sources.clear();
+    transfer_targets.clear();
+    transfer_durations.clear();
+    transfer_way_idxs.clear();
+    transfer_geom_idxs.clear();
+    for (const auto& transfer : transfers) {
+        has_transfers[transfer.source] = true;
+        transfer_sources.push_back(transfer.source);
+        transfer_targets.push_back(transfer.target);
+        transfer_durations.push_back(transfer.duration);
+        transfer_way_idxs.push_back(transfer.way_idx);
+        transfer_geom_idxs.push_back(transfer.geom_idx);
+    }
+}
+
+size_t CsrGraph::num_edges() const {
+    size_t result = transfer_sources.size();
+    for (const auto c : copies) {
+        result += __builtin_popcount(c);
+    }
+    return result;
+}
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,266 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "georef/georef_types.h"
+#include "type/time_duration.h"
+
+#include <boost/graph/graph_traits.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/property_map/property_map.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/// Edge of a CsrGraph: its source and its position in the edge arrays
+struct CsrEdge {
+    vertex_t source = 0;
+    // index of a street edge, or of a transfer edge with CsrGraph::transfer_flag
+    uint32_t idx = 0;
+    // copy of the street graph of the source (walking, bike, car)
+    uint8_t copy = 0;
+
+    bool operator==(const CsrEdge& other) const { return idx == other.idx; }
+    bool operator!=(const CsrEdge& other) const { return idx != other.idx; }
+};
+
+/** Compressed sparse row copy of the street graph, with one topology for all the modes
+ *
+ * The street graph holds a copy of the streets by mode (walking, bike, car), the vertex v
+ * of the walking copy being nb_vertex_by_mode * copy + v in the other ones. The streets of
+ * the copies share their vertices and most of their edges, only the durations differ.
+ * Here the edges are stored once, on the vertices of the first copy:
+ *  - the street edges of v are [offsets[v], offsets[v + 1]), with their target in the
+ *    same copy, a bit by copy telling the copies where the edge exists, and a duration by copy,
+ *  - the few transfer edges between copies (bike sharing stations, car parks) are kept aside,
+ *    sorted by source.
+ * The searches only need the targets and the durations, the way and geometry indexes
+ * are kept aside in cold arrays.
+ *
+ * The vertices are the same as in the adjacency_list, and the out edges of a vertex come in
+ * the same order when the copies add their edges in the same order and the transfers last,
+ * as the data loading does. The searches then give exactly the same results on both.
+ *
+ * It models a boost IncidenceGraph and VertexListGraph, so the boost
+ * algorithms, filtered_graph and the georef visitors can run on it.
+ *
+ * It does not replace the adjacency_list, which stays the serialized graph read by the rest of
+ * georef: it is built beside it at load, for about a ninth more memory than the adjacency_list.
+ */
+class CsrGraph {
+public:
+    static constexpr uint32_t transfer_flag = uint32_t(1) << 31;
+
+    /// Walks the street edges of the copy of the source, then its transfers
+    class out_edge_iterator
+        : public boost::iterator_facade<out_edge_iterator, CsrEdge, boost::forward_traversal_tag, CsrEdge> {
+    public:
+        out_edge_iterator() = default;
+        out_edge_iterator(const CsrGraph* graph, const CsrEdge& edge, uint32_t end_street, uint32_t first_transfer)
+            : graph(graph), edge(edge), end_street(end_street), first_transfer(first_transfer) {
+            skip_other_copies();
+        }
+
+    private:
+        friend class boost::iterator_core_access;
+        CsrEdge dereference() const { return edge; }
+        bool equal(const out_edge_iterator& other) const { return edge.idx == other.edge.idx; }
+        void increment() {
+            ++edge.idx;
+            skip_other_copies();
+        }
+        void skip_other_copies() {
+            if (edge.idx & transfer_flag) {
+                return;
+            }
+            while (edge.idx < end_street && !(graph->copies[edge.idx] & (1 << edge.copy))) {
+                ++edge.idx;
+            }
+            if (edge.idx == end_street) {
+                edge.idx = first_transfer | transfer_flag;
+            }
+        }
+
+        const CsrGraph* graph = nullptr;
+        CsrEdge edge;
+        uint32_t end_street = 0;
+        uint32_t first_transfer = 0;
+    };
+
+    // boost graph traits
+    using vertex_descriptor = vertex_t;
+    using edge_descriptor = CsrEdge;
+    using directed_category = boost::directed_tag;
+    using edge_parallel_category = boost::allow_parallel_edge_tag;
+    struct traversal_category : boost::incidence_graph_tag, boost::vertex_list_graph_tag {};
+    using vertex_iterator = boost::counting_iterator<vertex_t>;
+    using vertices_size_type = size_t;
+    using edges_size_type = size_t;
+    using degree_size_type = uint32_t;
+    static vertex_t null_vertex() { return std::numeric_limits<vertex_t>::max(); }
+
+    /**
+     * Build the compact copy of the graph, to be called again each time the graph is modified
+     * nb_vertex_by_mode is the number of vertices of each copy, 0 if the graph is not split in copies
+     */
+    void build(const Graph& graph, size_t nb_vertex_by_mode);
+
+    /**
+     * Copy the compact copy of another graph with the same vertices and edges, like the graph of a clone
+     * of the data, instead of building it again
+     */
+    void copy_for(const CsrGraph& other, const Graph& graph) {
+        *this = other;
+        source_graph = &graph;
+    }
+
+    size_t num_vertices() const { return nb_vertices; }
+    size_t num_edges() const;
+
+    /** Cheap check that the compact copy has been built for this graph object
+     *
+     * The edges are not compared, it would cost a pass on the whole graph for each search:
+     * build must be called again when the graph is modified.
+     */
+    bool is_built_for(const Graph& graph) const {
+        return source_graph == &graph && num_vertices() == boost::num_vertices(graph);
+    }
+    /// Hash of the vertices and edges of the graph the copy has been built for
+    uint64_t source_fingerprint() const { return fingerprint; }
+
+    std::pair<out_edge_iterator, out_edge_iterator> out_edges(vertex_t v) const {
+        const auto copy = uint8_t(v / nb_vertex_by_copy);
+        const auto local = v - copy * nb_vertex_by_copy;
+        uint32_t first_transfer = 0;
+        uint32_t end_transfer = 0;
+        if (has_transfers[v]) {
+            const auto range = std::equal_range(transfer_sources.begin(), transfer_sources.end(), v);
+            first_transfer = uint32_t(range.first - transfer_sources.begin());
+            end_transfer = uint32_t(range.second - transfer_sources.begin());
+        }
+        return {out_edge_iterator(this, {v, offsets[local], copy}, offsets[local + 1], first_transfer),
+                out_edge_iterator(this, {v, end_transfer | transfer_flag, copy}, 0, 0)};
+    }
+
+    vertex_t target(const CsrEdge& e) const {
+        if (e.idx & transfer_flag) {
+            return transfer_targets[e.idx & ~transfer_flag];
+        }
+        return e.copy * nb_vertex_by_copy + targets[e.idx];
+    }
+    navitia::time_duration duration(const CsrEdge& e) const {
+        if (e.idx & transfer_flag) {
+            return navitia::time_duration(0, 0, 0, transfer_durations[e.idx & ~transfer_flag]);
+        }
+        return navitia::time_duration(0, 0, 0, durations[e.idx * nb_copies + e.copy]);
+    }
+    nt::idx_t way_idx(const CsrEdge& e) const {
+        return e.idx & transfer_flag ? transfer_way_idxs[e.idx & ~transfer_flag] : way_idxs[e.idx];
+    }
+    nt::idx_t geom_idx(const CsrEdge& e) const {
+        return e.idx & transfer_flag ? transfer_geom_idxs[e.idx & ~transfer_flag] : geom_idxs[e.idx];
+    }
+
+private:
+    const Graph* source_graph = nullptr;
+    uint64_t fingerprint = 0;
+    size_t nb_vertices = 0;
+    size_t nb_vertex_by_copy = 1;
+    size_t nb_copies = 1;
+
+    // hot arrays of the street edges, read by the searches
+    std::vector<uint32_t> offsets;
+    // target in the copy of the source
+    std::vector<uint32_t> targets;
+    // bit i set if the edge exists in the copy i
+    std::vector<uint8_t> copies;
+    // in ticks of navitia::time_duration (tenth of seconds), nb_copies by edge
+    std::vector<int32_t> durations;
+
+    // transfer edges between the copies, sorted by source
+    std::vector<bool> has_transfers;
+    std::vector<vertex_t> transfer_sources;
+    std::vector<vertex_t> transfer_targets;
+    std::vector<int32_t> transfer_durations;
+
+    // cold arrays, only read to build the paths
+    std::vector<nt::idx_t> way_idxs;
+    std::vector<nt::idx_t> geom_idxs;
+    std::vector<nt::idx_t> transfer_way_idxs;
+    std::vector<nt::idx_t> transfer_geom_idxs;
+};
+
+/// Hash of the number of vertices and of the targets and durations of the edges, to compare two graphs
+uint64_t graph_fingerprint(const Graph& graph);
+
+// boost graph interface of the CsrGraph
+inline vertex_t source(const CsrEdge& e, const CsrGraph&) {
+    return e.source;
+}
+inline vertex_t target(const CsrEdge& e, const CsrGraph& g) {
+    return g.target(e);
+}
+inline std::pair<CsrGraph::out_edge_iterator, CsrGraph::out_edge_iterator> out_edges(vertex_t v, const CsrGraph& g) {
+    return g.out_edges(v);
+}
+inline uint32_t out_degree(vertex_t v, const CsrGraph& g) {
+    const auto range = g.out_edges(v);
+    return uint32_t(std::distance(range.first, range.second));
+}
+inline std::pair<CsrGraph::vertex_iterator, CsrGraph::vertex_iterator> vertices(const CsrGraph& g) {
+    return {CsrGraph::vertex_iterator(0), CsrGraph::vertex_iterator(g.num_vertices())};
+}
+inline size_t num_vertices(const CsrGraph& g) {
+    return g.num_vertices();
+}
+
+/// Readable property map of the durations of the CsrGraph edges, the weight map of the searches
+struct CsrDurationMap {
+    using key_type = CsrEdge;
+    using value_type = navitia::time_duration;
+    using reference = navitia::time_duration;
+    using category = boost::readable_property_map_tag;
+
+    const CsrGraph* graph;
+};
+inline navitia::time_duration get(const CsrDurationMap& map, const CsrEdge& e) {
+    return map.graph->duration(e);
+}
+
+}  // namespace georef
+}  // namespace navitia
@@ -31,10 +31,13 @@ www.navitia.io
 #include "dijkstra_path_finder.h"
 
 #include "georef/georef.h"
+#include "georef/stop_point_walking_table.h"
 #include "utils/logger.h"
 
 #include <boost/graph/dijkstra_shortest_paths.hpp>
 
+#include <algorithm>
+
 namespace navitia {
 namespace georef {
 
@@ -158,23 +161,79 @@ routing::map_stop_point_duration DijkstraPathFinder::find_nearest_stop_points(
             }
         }
     }
-    // case 2 : start coord is an edge (dijkstra)
-    else {
-        std::vector<routing::SpIdx> dest_sp_idx;
-        dest_sp_idx.reserve(elements.size());
-        for (const auto& e : elements) {
-            dest_sp_idx.emplace_back(routing::SpIdx{e.first});
+    // case 2 : start coord is an edge (dijkstra), unless the durations are in the walking table
+    else if (!find_in_stop_point_walking_table(max_duration, elements, result)) {
+        result = find_reached_stop_points(max_duration, elements);
+    }
+    return result;
+}
+
+routing::map_stop_point_duration DijkstraPathFinder::find_reached_stop_points(
+    const navitia::time_duration& max_duration,
+    const std::vector<std::pair<type::idx_t, type::GeographicalCoord>>& elements) {
+    std::vector<routing::SpIdx> dest_sp_idx;
+    dest_sp_idx.reserve(elements.size());
+    for (const auto& e : elements) {
+        dest_sp_idx.emplace_back(routing::SpIdx{e.first});
+    }
+    ProjectionGetterByCache projection_getter{mode, geo_ref.projected_stop_points};
+    auto resp = start_dijkstra_and_fill_duration_map<routing::SpIdx, routing::SpIdx, ProjectionGetterByCache>(
+        max_duration, dest_sp_idx, projection_getter);
+    routing::map_stop_point_duration result;
+    for (const auto& r : resp) {
+        if (r.second.routing_status == RoutingStatus_e::reached) {
+            result[r.first] = r.second.time_duration;
         }
-        ProjectionGetterByCache projection_getter{mode, geo_ref.projected_stop_points};
-        auto resp = start_dijkstra_and_fill_duration_map<routing::SpIdx, routing::SpIdx, ProjectionGetterByCache>(
-            max_duration, dest_sp_idx, projection_getter);
-        for (const auto& r : resp) {
-            if (r.second.routing_status == RoutingStatus_e::reached) {
-                result[r.first] = r.second.time_duration;
+    }
+    return result;
+}
+
+bool DijkstraPathFinder::find_in_stop_point_walking_table(
+    const navitia::time_duration& max_duration,
+    const std::vector<std::pair<type::idx_t, type::GeographicalCoord>>& elements,
+    routing::map_stop_point_duration& result) {
+    const auto& table = geo_ref.stop_point_walking_table;
+    // the table is computed at the default walking speed
+    if (!table || mode != nt::Mode_e::Walking || speed_factor != 1.f || max_duration > table->get_radius()) {
+        return false;
+    }
+    if (std::any_of(elements.begin(), elements.end(), [&](const std::pair<type::idx_t, type::GeographicalCoord>& e) {
+            return e.first >= table->nb_stop_points();
+        })) {
+        return false;
+    }
+
+    // the stop points are reached through one of the vertices of the starting edge, as in the Dijkstra
+    const auto starting_durations = get_starting_durations();
+    for (const auto& e : elements) {
+        const auto& projection = geo_ref.projected_stop_points[e.first][mode];
+        if (!projection.found) {
+            continue;
+        }
+        navitia::time_duration duration = bt::pos_infin;
+        if (is_projected_on_same_edge(starting_edge, projection)) {
+            duration = path_duration_on_same_edge(starting_edge, projection);
+        } else {
+            for (const auto direction : {source_e, target_e}) {
+                if (starting_durations[direction] != bt::pos_infin) {
+                    duration = std::min(duration, starting_durations[direction]
+                                                      + table->get_duration(e.first, starting_edge[direction]));
+                }
             }
         }
+        if (duration <= max_duration) {
+            result[routing::SpIdx{e.first}] = duration;
+        }
     }
-    return result;
+    durations_from_table = true;
+    return true;
+}
+
+Path DijkstraPathFinder::get_path(type::idx_t idx) {
+    if (durations_from_table) {
+        update_path(geo_ref.projected_stop_points[idx][mode]);
+    }
+    return PathFinder::get_path(idx);
 }
 
 struct ProjectionGetterOnCoords {
@@ -207,17 +266,22 @@ template <class Visitor>
 void DijkstraPathFinder::dijkstra(const std::array<georef::vertex_t, 2>& origin_vertexes, const Visitor& visitor) {
     // Note: the predecessors have been updated in init
     // Fill color map in white before dijkstra
-    std::fill(color.data.get(),
-              color.data.get()
-                  + (color.n + boost::two_bit_color_map<>::elements_per_char - 1)
-                        / boost::two_bit_color_map<>::elements_per_char,
-              0);
+    color.reset(boost::num_vertices(geo_ref.graph), boost::color_traits<boost::two_bit_color_type>::white());
+
+    auto const filter = TransportationModeFilter(mode, geo_ref);
+    auto const combiner = SpeedDistanceCombiner(speed_factor);  // we multiply the edge duration by a speed factor
 
     // we filter the graph to only use certain mean of transport
+    // the compact copy of the graph is used when it is up to date, it is much more cache friendly
+    if (geo_ref.csr_graph.is_built_for(geo_ref.graph)) {
+        using filtered_csr = boost::filtered_graph<CsrGraph, boost::keep_all, TransportationModeFilter>;
+        auto const g = filtered_csr(geo_ref.csr_graph, {}, filter);
+        dijkstra_on_csr_with_radix_heap(g, geo_ref.csr_graph, filter, origin_vertexes, visitor, combiner);
+        return;
+    }
     using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, TransportationModeFilter>;
-    auto const g = filtered_graph(geo_ref.graph, {}, TransportationModeFilter(mode, geo_ref));
+    auto const g = filtered_graph(geo_ref.graph, {}, filter);
     auto const weight_map = boost::get(&Edge::duration, geo_ref.graph);
-    auto const combiner = SpeedDistanceCombiner(speed_factor);  // we multiply the edge duration by a speed factor
 
     dijkstra_shortest_paths_no_init_with_heap(g, origin_vertexes.front(), origin_vertexes.back(), visitor, weight_map,
                                               combiner);
@@ -280,15 +344,86 @@ void DijkstraPathFinder::dijkstra_shortest_paths_no_init_with_heap(const Graph&
                                                                    const WeightMap& weight,
                                                                    const SpeedDistanceCombiner& combine,
                                                                    const Compare& compare) {
-    using MutableQueue = boost::d_ary_heap_indirect<vertex_t, 4, vertex_t*, navitia::time_duration*, Compare>;
+    using IndexInHeapMap = SparseVertexMap<std::size_t>::PropertyMap;
+    using DistanceMap = SparseVertexMap<navitia::time_duration>::PropertyMap;
+    using PredecessorMap = SparseVertexMap<vertex_t>::PropertyMap;
+    using MutableQueue = boost::d_ary_heap_indirect<vertex_t, 4, IndexInHeapMap, DistanceMap, Compare>;
 
-    MutableQueue Q(&distances[0], &index_in_heap_map[0], compare);
+    MutableQueue Q(distances.property_map(), index_in_heap_map.property_map(), compare);
 
-    boost::detail::dijkstra_bfs_visitor<DijkstraVisitor, MutableQueue, WeightMap, vertex_t*, navitia::time_duration*,
+    boost::detail::dijkstra_bfs_visitor<DijkstraVisitor, MutableQueue, WeightMap, PredecessorMap, DistanceMap,
                                         SpeedDistanceCombiner, Compare>
-        bfs_vis(visitor, Q, weight, &predecessors[0], &distances[0], combine, compare, navitia::seconds(0));
+        bfs_vis(visitor, Q, weight, predecessors.property_map(), distances.property_map(), combine, compare,
+                navitia::seconds(0));
+
+    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, color.property_map());
+}
+
+template <class Graph, class DijkstraVisitor>
+void DijkstraPathFinder::dijkstra_on_csr_with_radix_heap(const Graph& g,
+                                                         const CsrGraph& csr,
+                                                         const TransportationModeFilter& filter,
+                                                         const std::array<georef::vertex_t, 2>& origin_vertexes,
+                                                         const DijkstraVisitor& visitor,
+                                                         const SpeedDistanceCombiner& combine) {
+    using Color = boost::color_traits<boost::two_bit_color_type>;
+    // the visitors count the finished vertices, like in boost we work on a copy
+    DijkstraVisitor vis = visitor;
+
+    // the durations fit in 32 bits of ticks, more than a year
+    auto key = [](const navitia::time_duration& duration) { return uint32_t(duration.ticks()); };
+    radix_heap.clear();
+    uint32_t last_key = 0;
+    // like breadth_first_visit, a white vertex is queued with its current distance even if it is not improved:
+    // a search launched again on the distances of a previous one goes through the already reached vertices
+    auto discover = [&](vertex_t v) {
+        if (distances[v].is_special()) {
+            return;
+        }
+        color[v] = Color::gray();
+        radix_heap.push(std::max(key(distances[v]), last_key), v);
+    };
+
+    for (const auto v : origin_vertexes) {
+        if (color[v] == Color::white()) {
+            discover(v);
+        }
+    }
 
-    breadth_first_visit(g, &s_begin, &s_end, Q, bfs_vis, color);
+    while (!radix_heap.empty()) {
+        const auto top = radix_heap.pop();
+        const vertex_t u = top.second;
+        // a vertex is queued again when its distance decreases, its first entry out is the good one
+        if (color[u] == Color::black()) {
+            continue;
+        }
+        last_key = top.first;
+        vis.examine_vertex(u, g);
+        for (auto range = csr.out_edges(u); range.first != range.second; ++range.first) {
+            const auto e = *range.first;
+            const vertex_t v = csr.target(e);
+            if (!filter(v)) {
+                continue;
+            }
+            const auto v_color = color[v];
+            if (v_color == Color::black()) {
+                continue;
+            }
+            const auto duration = combine(distances[u], csr.duration(e));
+            const bool relaxed = duration < distances[v];
+            if (relaxed) {
+                distances[v] = duration;
+                predecessors[v] = u;
+            }
+            if (v_color == Color::white()) {
+                discover(v);
+            } else if (relaxed) {
+                radix_heap.push(std::max(key(duration), last_key), v);
+            }
+        }
+        color[u] = Color::black();
+        vis.finish_vertex(u, g);
+    }
 }
 
 }  // namespace georef
@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 
 #include "path_finder.h"
+#include "radix_heap.h"
 #include "visitor.h"
 
 #include <boost/graph/filtered_graph.hpp>
@@ -46,6 +47,7 @@ public:
 
     void init(const type::GeographicalCoord& start_coord, nt::Mode_e mode, const float speed_factor) {
         PathFinder::init_start(start_coord, mode, speed_factor);
+        durations_from_table = false;
     }
 
     void start_distance_dijkstra(const navitia::time_duration& radius);
@@ -54,6 +56,15 @@ public:
     routing::map_stop_point_duration find_nearest_stop_points(const navitia::time_duration& max_duration,
                                                               const proximitylist::ProximityList<type::idx_t>& pl);
 
+    // compute with a Dijkstra the stop points reached within the radius among the candidates
+    routing::map_stop_point_duration find_reached_stop_points(
+        const navitia::time_duration& max_duration,
+        const std::vector<std::pair<type::idx_t, type::GeographicalCoord>>& elements);
+
+    // the durations read in the stop point walking table have no predecessors: the path is searched first
+    using PathFinder::get_path;
+    Path get_path(type::idx_t idx);
+
     using coord_uri = std::string;
     boost::container::flat_map<coord_uri, georef::RoutingElement> get_duration_with_dijkstra(
         const navitia::time_duration& radius,
@@ -82,6 +93,11 @@ private:
         const std::vector<U>& destinations,
         const G& projection_getter);
 
+    // read the durations to the candidates in the walking table, when it is built for the mode and the duration
+    bool find_in_stop_point_walking_table(const navitia::time_duration& max_duration,
+                                          const std::vector<std::pair<type::idx_t, type::GeographicalCoord>>& elements,
+                                          routing::map_stop_point_duration& result);
+
     // compute the reachable stop points within the radius with a simple crow fly
     std::vector<std::pair<type::idx_t, type::GeographicalCoord>> crow_fly_find_nearest_stop_points(
         const navitia::time_duration& max_duration,
@@ -97,6 +113,25 @@ private:
                                                    const WeightMap& weight,
                                                    const SpeedDistanceCombiner& combine,
                                                    const Compare& compare = Compare());
+
+    /**
+     * Same search as dijkstra_shortest_paths_no_init_with_heap on the compact copy of the graph,
+     * with a radix heap on the durations in ticks instead of the d-ary heap
+     * The visitor is called the same way, only the order of the vertices at the same distance may differ
+     */
+    template <class Graph, class DijkstraVisitor>
+    void dijkstra_on_csr_with_radix_heap(const Graph& g,
+                                         const CsrGraph& csr,
+                                         const TransportationModeFilter& filter,
+                                         const std::array<georef::vertex_t, 2>& origin_vertexes,
+                                         const DijkstraVisitor& visitor,
+                                         const SpeedDistanceCombiner& combine);
+
+    // kept between the searches to avoid the allocations
+    RadixHeap<vertex_t> radix_heap;
+
+    // the last stop points have been found in the walking table, without a search
+    bool durations_from_table = false;
 };
 
 }  // namespace georef
@@ -0,0 +1,99 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#include "georef/edge_rtree.h"
+
+#include "georef/georef.h"
+
+#include <boost/foreach.hpp>
+#include <boost/geometry/algorithms/expand.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+void EdgeRtree::build(const GeoRef& geo_ref) {
+    const auto& graph = geo_ref.graph;
+    const size_t nb_vertices = boost::num_vertices(graph);
+    size_t nb_vertex_by_copy = geo_ref.nb_vertex_by_mode;
+    if (nb_vertex_by_copy == 0 || nb_vertices % nb_vertex_by_copy != 0) {
+        // graph not split in copies
+        nb_vertex_by_copy = nb_vertices;
+    }
+
+    std::vector<Value> values;
+    values.reserve(nb_vertex_by_copy);
+    for (vertex_t v = 0; v < nb_vertex_by_copy; ++v) {
+        Box box;
+        bool has_edge = false;
+        for (vertex_t u = v; u < nb_vertices; u += nb_vertex_by_copy) {
+            BOOST_FOREACH (const edge_t& e, boost::out_edges(u, graph)) {
+                const auto w = boost::target(e, graph);
+                // the transfers between the copies are not streets
+                if (w / nb_vertex_by_copy != u / nb_vertex_by_copy) {
+                    continue;
+                }
+                if (!has_edge) {
+                    box = Box(graph[u].coord, graph[u].coord);
+                    has_edge = true;
+                }
+                boost::geometry::expand(box, graph[w].coord);
+                const auto& edge = graph[e];
+                if (edge.geom_idx != nt::invalid_idx) {
+                    for (const auto& coord : geo_ref.ways[edge.way_idx]->geoms[edge.geom_idx]) {
+                        boost::geometry::expand(box, coord);
+                    }
+                }
+            }
+        }
+        if (has_edge) {
+            values.emplace_back(box, v);
+        }
+    }
+    // the range constructor packs the tree
+    rtree = decltype(rtree)(values.begin(), values.end());
+}
+
+EdgeRtree::Box EdgeRtree::search_box(const type::GeographicalCoord& coord, double radius) {
+    // same approximation as GeographicalCoord::approx_sqr_distance, with a small margin
+    const double radius_deg =
+        1.01 * radius / (type::GeographicalCoord::EARTH_RADIUS_IN_METERS * type::GeographicalCoord::N_DEG_TO_RAD);
+    const double coslat = std::max(::cos(coord.lat() * type::GeographicalCoord::N_DEG_TO_RAD), 1e-6);
+    const double dlon = radius_deg / coslat;
+    return Box(type::GeographicalCoord(coord.lon() - dlon, coord.lat() - radius_deg),
+               type::GeographicalCoord(coord.lon() + dlon, coord.lat() + radius_deg));
+}
+
+}  // namespace georef
+}  // namespace navitia
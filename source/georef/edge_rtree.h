@@ -0,0 +1,81 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#pragma once
+
+#include "georef/georef_types.h"
+#include "type/geographical_coord.h"
+
+#include <boost/function_output_iterator.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include <utility>
+
+namespace navitia {
+namespace georef {
+
+/** R-tree of the street edges, to find the edges near a coordinate
+ *
+ * The street graph holds a copy of the streets by mode (walking, bike, car) sharing the same
+ * geometries, so one R-tree is built for all the copies: its values are the vertices of the
+ * first copy, with the bounding box of their out edges (geometries included) in every copy.
+ * A vertex v is the vertex nb_vertex_by_mode * copy + v in the other copies, the caller
+ * checks the out edges of the copy it is interested in.
+ *
+ * The tree is packed at build, it is not serialized and only read by the workers.
+ */
+class EdgeRtree {
+public:
+    /// Index the out edges of the street graph, to be called again each time the graph is modified
+    void build(const GeoRef& geo_ref);
+
+    size_t size() const { return rtree.size(); }
+
+    /// Call f with the vertices of the first copy having an out edge that can be within radius meters of coord
+    template <typename F>
+    void for_each_vertex(const type::GeographicalCoord& coord, double radius, F f) const {
+        rtree.query(boost::geometry::index::intersects(search_box(coord, radius)),
+                    boost::make_function_output_iterator([&](const Value& value) { f(value.second); }));
+    }
+
+private:
+    using Box = boost::geometry::model::box<type::GeographicalCoord>;
+    using Value = std::pair<Box, vertex_t>;
+
+    // box containing the circle of radius meters around coord
+    static Box search_box(const type::GeographicalCoord& coord, double radius);
+
+    boost::geometry::index::rtree<Value, boost::geometry::index::rstar<16>> rtree;
+};
+
+}  // namespace georef
+}  // namespace navitia
@@ -29,10 +29,12 @@ www.navitia.io
 */
 
 #include "georef.h"
+#include "georef/path_finder.h"
 
 #include "type/stop_area.h"
 #include "type/stop_point.h"
 #include "type/access_point.h"
+#include "type/parallel.h"
 #include "utils/configuration.h"
 #include "utils/csv.h"
 #include "utils/functions.h"
@@ -46,7 +48,9 @@ www.navitia.io
 #include <boost/range/algorithm/sort.hpp>
 
 #include <array>
+#include <chrono>
 #include <unordered_map>
+#include <unordered_set>
 
 using navitia::type::idx_t;
 
@@ -376,7 +380,7 @@ void GeoRef::init() {
     offsets[nt::Mode_e::CarNoPark] = offsets[nt::Mode_e::Car];
 }
 
-void GeoRef::build_proximity_list() {
+void GeoRef::build_proximity_list(const GeoRef* previous) {
     pl_walking.clear();
     pl_bike.clear();
     pl_car.clear();
@@ -409,6 +413,65 @@ void GeoRef::build_proximity_list() {
         poi_proximity_list.add(poi->coord, poi->idx);
     }
     poi_proximity_list.build();
+
+    if (previous && previous->csr_graph.num_vertices() == boost::num_vertices(graph)) {
+        // the clone of the data has the same street network
+        LOG4CPLUS_INFO(log, "Copying compact street graph and R-tree of the street edges");
+        csr_graph.copy_for(previous->csr_graph, graph);
+        edge_rtree = previous->edge_rtree;
+    } else {
+        LOG4CPLUS_INFO(log, "Building compact street graph");
+        csr_graph.build(graph, nb_vertex_by_mode);
+
+        LOG4CPLUS_INFO(log, "Building R-tree of the street edges");
+        edge_rtree.build(*this);
+    }
+}
+
+void GeoRef::build_contraction_hierarchies(const std::vector<nt::Mode_e>& modes) {
+    auto log = log4cplus::Logger::getInstance("GeoRef::build_contraction_hierarchies");
+    for (const auto mode : modes) {
+        LOG4CPLUS_INFO(log, "Building contraction hierarchy for " << mode);
+        const auto begin = std::chrono::steady_clock::now();
+        const auto filter = TransportationModeFilter(mode, *this);
+        auto ch = std::make_shared<ContractionHierarchy>();
+        ch->build(csr_graph, filter);
+        contraction_hierarchies[mode] = std::move(ch);
+        LOG4CPLUS_INFO(log, "Contraction hierarchy for " << mode << " built in "
+                                                         << std::chrono::duration_cast<std::chrono::seconds>(
+                                                                std::chrono::steady_clock::now() - begin)
+                                                                .count()
+                                                         << "s with " << contraction_hierarchies[mode]->num_edges()
+                                                         << " edges");
+    }
+}
+
+void GeoRef::build_stop_point_walking_table(const navitia::time_duration& radius,
+                                            const StopPointWalkingTable* previous) {
+    auto log = log4cplus::Logger::getInstance("GeoRef::build_stop_point_walking_table");
+    LOG4CPLUS_INFO(log, "Building stop point walking table within " << radius.total_seconds() << "s");
+    const auto begin = std::chrono::steady_clock::now();
+    auto table = std::make_shared<StopPointWalkingTable>();
+    table->build(*this, radius, previous);
+    stop_point_walking_table = std::move(table);
+    const auto duration = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - begin);
+    LOG4CPLUS_INFO(log, "Stop point walking table built in "
+                            << duration.count() << "s with " << stop_point_walking_table->num_entries()
+                            << " durations, " << stop_point_walking_table->nb_computed_rows()
+                            << " stop points computed");
+}
+
+void GeoRef::warmup(const GeoRef& other) {
+    for (const auto& mode_ch : other.contraction_hierarchies) {
+        if (mode_ch.second && mode_ch.second->is_built_for(csr_graph) && !contraction_hierarchies[mode_ch.first]) {
+            contraction_hierarchies[mode_ch.first] = mode_ch.second;
+        }
+    }
+    // the stop points are projected again with the realtime data, the table is kept if they have not changed
+    if (other.stop_point_walking_table && other.stop_point_walking_table->is_built_for(*this)
+        && !stop_point_walking_table) {
+        stop_point_walking_table = other.stop_point_walking_table;
+    }
 }
 
 static const Admin* find_city_admin(const std::vector<Admin*>& admins) {
@@ -422,55 +485,69 @@ static const Admin* find_city_admin(const std::vector<Admin*>& admins) {
 }
 
 void GeoRef::build_autocomplete_list() {
-    int pos = -1;
-    fl_way.clear();
-    for (Way* way : ways) {
-        ++pos;
-        if (way->name.empty()) {
-            continue;
-        }
-        // skip way without edges as we don't kwow where they are (no coordinate)
-        if (way->edges.empty()) {
-            continue;
+    // the indexes are independent, they are built by the workers in turn
+    std::vector<std::function<void()>> builds;
+    builds.emplace_back([this]() {
+        int pos = -1;
+        fl_way.clear();
+        for (Way* way : ways) {
+            ++pos;
+            if (way->name.empty()) {
+                continue;
+            }
+            // skip way without edges as we don't kwow where they are (no coordinate)
+            if (way->edges.empty()) {
+                continue;
+            }
+            if (!way->visible) {
+                continue;
+            }
+            if (auto admin = find_city_admin(way->admin_list)) {
+                // @TODO:
+                // For each object admin we have one element in the dictionnary of admins.
+                // With multi postal codes for the same admin we will have to create one element
+                // for each postal code of admin.
+                // Same way for all address in the admin.
+                // After this modification the result found with postal code in search string
+                // should contain only this postal code but not others of the admin found.
+                std::string key =
+                    way->way_type + " " + way->name + " " + admin->name + " " + admin->postal_codes_to_string();
+                fl_way.add_string(key, pos, this->ghostwords, this->synonyms);
+            }
         }
-        if (!way->visible) {
-            continue;
+        fl_way.build();
+    });
+
+    builds.emplace_back([this]() {
+        fl_poi.clear();
+        // Autocomplete poi list
+        for (const POI* poi : pois) {
+            if (poi->name.empty() || !poi->visible) {
+                continue;
+            }
+            std::string key = poi->name;
+            if (auto admin = find_city_admin(poi->admin_list)) {
+                key += " " + admin->name;
+            }
+            fl_poi.add_string(key, poi->idx, this->ghostwords, this->synonyms);
         }
-        if (auto admin = find_city_admin(way->admin_list)) {
-            // @TODO:
-            // For each object admin we have one element in the dictionnary of admins.
-            // With multi postal codes for the same admin we will have to create one element
-            // for each postal code of admin.
-            // Same way for all address in the admin.
-            // After this modification the result found with postal code in search string
-            // should contain only this postal code but not others of the admin found.
-            std::string key =
-                way->way_type + " " + way->name + " " + admin->name + " " + admin->postal_codes_to_string();
-            fl_way.add_string(key, pos, this->ghostwords, this->synonyms);
+        fl_poi.build();
+    });
+
+    builds.emplace_back([this]() {
+        fl_admin.clear();
+        for (Admin* admin : admins) {
+            fl_admin.add_string(admin->name + " " + admin->postal_codes_to_string(), admin->idx, this->ghostwords,
+                                this->synonyms);
         }
-    }
-    fl_way.build();
+        fl_admin.build();
+    });
 
-    fl_poi.clear();
-    // Autocomplete poi list
-    for (const POI* poi : pois) {
-        if (poi->name.empty() || !poi->visible) {
-            continue;
-        }
-        std::string key = poi->name;
-        if (auto admin = find_city_admin(poi->admin_list)) {
-            key += " " + admin->name;
+    parallel_for_chunks(builds.size(), 1, 0, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            builds[i]();
         }
-        fl_poi.add_string(key, poi->idx, this->ghostwords, this->synonyms);
-    }
-    fl_poi.build();
-
-    fl_admin.clear();
-    for (Admin* admin : admins) {
-        fl_admin.add_string(admin->name + " " + admin->postal_codes_to_string(), admin->idx, this->ghostwords,
-                            this->synonyms);
-    }
-    fl_admin.build();
+    });
 }
 
 /** poitype_map load: mapping external codes -> POIType*/
@@ -551,7 +628,8 @@ std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> GeoRef::find_ways(
     return to_return;
 }
 
-void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points) {
+void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points,
+                                                   const GeoRef* previous) {
     enum class error {
         matched = 0,
         matched_walking,
@@ -565,16 +643,6 @@ void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopP
     navitia::flat_enum_map<error, int> stop_point_messages{{{}}};
     navitia::flat_enum_map<error, int> access_point_messages{{{}}};
 
-    this->projected_stop_points.clear();
-
-    this->projected_stop_points.reserve(stop_points.size());
-
-    this->projected_coords.clear();
-    // This projection cache is used by distributed scenari. It contains projections for
-    // both stop points and access points. Since we cannot know the exact number of access points
-    // ahead of time, we just suppose every stop point has at least one access point. Thus the factor is 2.
-    this->projected_coords.reserve(stop_points.size() * 2);
-
     auto update_message = [](navitia::flat_enum_map<error, int>& messages,
                              const std::pair<GeoRef::ProjectionByMode, bool>& p,
                              const navitia::type::GeographicalCoord& coord) {
@@ -601,38 +669,93 @@ void GeoRef::project_stop_points_and_access_points(const std::vector<type::StopP
         }
     };
 
-    int access_points_num = 0;
-    for (const type::StopPoint* stop_point : stop_points) {
-        std::pair<GeoRef::ProjectionByMode, bool> pair = project_coord(stop_point->coord);
-
-        /*
-         * We build 2 different caches :
-         *  1. projected_stop_points : based on the stop_point id for NewDefault
-         *  2. projected_coords : based on GeographicalCoord for distributed.
-         *
-         *  TODO: remove projected_stop_points and replace it with the other one.
-         *  This could save us spave, but the Dijkstra related interface for Georef
-         *  needs a lot of rework.
-         */
-        this->projected_stop_points.push_back(pair.first);
-        this->projected_coords[stop_point->coord] = pair.first;
+    auto log = log4cplus::Logger::getInstance("kraken::type::Data::project_stop_point");
 
-        update_message(stop_point_messages, pair, stop_point->coord);
+    // the projections only depend on the coordinates and on the street network
+    if (previous
+        && (boost::num_vertices(previous->graph) != boost::num_vertices(graph)
+            || boost::num_edges(previous->graph) != boost::num_edges(graph))) {
+        LOG4CPLUS_INFO(log, "the street network has changed, the previous projections are not reused");
+        previous = nullptr;
+    }
 
+    // coordinates to project: the stop points, then the access points whose coordinate is not yet projected
+    std::vector<type::GeographicalCoord> coords;
+    coords.reserve(stop_points.size() * 2);
+    std::vector<size_t> first_access_point;
+    first_access_point.reserve(stop_points.size());
+    std::unordered_set<type::GeographicalCoord> seen_coords;
+    for (const type::StopPoint* stop_point : stop_points) {
+        coords.push_back(stop_point->coord);
+        seen_coords.insert(stop_point->coord);
+        first_access_point.push_back(coords.size());
         for (const auto& ap : stop_point->access_points) {
-            auto it = projected_coords.find(ap.coord);
-            if (it != projected_coords.end()) {
-                continue;
+            if (seen_coords.insert(ap.coord).second) {
+                coords.push_back(ap.coord);
             }
-            std::pair<GeoRef::ProjectionByMode, bool> ap_pair = project_coord(ap.coord);
-            this->projected_coords[ap.coord] = ap_pair.first;
-            ++access_points_num;
+        }
+    }
 
-            update_message(access_point_messages, ap_pair, ap.coord);
-        };
+    std::vector<bool> to_project(coords.size(), true);
+    size_t nb_reused = 0;
+    if (previous) {
+        for (size_t i = 0; i < coords.size(); ++i) {
+            if (previous->projected_coords.count(coords[i])) {
+                to_project[i] = false;
+                ++nb_reused;
+            }
+        }
+    }
+    auto projections = project_coords(coords, to_project);
+    for (size_t i = 0; i < coords.size(); ++i) {
+        if (to_project[i]) {
+            continue;
+        }
+        const auto& reused = previous->projected_coords.at(coords[i]);
+        projections[i].first = reused;
+        projections[i].second = false;
+        for (const auto& mode_projection : reused) {
+            projections[i].second = projections[i].second || mode_projection.second.found;
+        }
     }
 
-    auto log = log4cplus::Logger::getInstance("kraken::type::Data::project_stop_point");
+    /*
+     * We build 2 different caches :
+     *  1. projected_stop_points : based on the stop_point id for NewDefault
+     *  2. projected_coords : based on GeographicalCoord for distributed.
+     *
+     *  TODO: remove projected_stop_points and replace it with the other one.
+     *  This could save us spave, but the Dijkstra related interface for Georef
+     *  needs a lot of rework.
+     */
+    ProjectedCoords new_projected_coords;
+    // This projection cache is used by distributed scenari. It contains projections for
+    // both stop points and access points.
+    new_projected_coords.reserve(coords.size());
+    std::vector<ProjectionByMode> new_projected_stop_points;
+    new_projected_stop_points.reserve(stop_points.size());
+
+    int access_points_num = 0;
+    for (size_t sp = 0; sp < stop_points.size(); ++sp) {
+        const size_t i = first_access_point[sp] - 1;
+        new_projected_stop_points.push_back(projections[i].first);
+        new_projected_coords[coords[i]] = projections[i].first;
+        update_message(stop_point_messages, projections[i], coords[i]);
+
+        const size_t end = sp + 1 < stop_points.size() ? first_access_point[sp + 1] - 1 : coords.size();
+        for (size_t ap = first_access_point[sp]; ap < end; ++ap) {
+            new_projected_coords[coords[ap]] = projections[ap].first;
+            ++access_points_num;
+            update_message(access_point_messages, projections[ap], coords[ap]);
+        }
+    }
+    // previous may be this georef
+    this->projected_stop_points = std::move(new_projected_stop_points);
+    this->projected_coords = std::move(new_projected_coords);
+
+    LOG4CPLUS_INFO(log, coords.size() << " coordinates of stop points and access points projected, " << nb_reused
+                                      << " projections reused");
+
 
     auto log_messages = [&log](const navitia::flat_enum_map<error, int>& messages, std::string type, size_t total) {
         LOG4CPLUS_DEBUG(log, "Number of " + type + " projected on the georef network : " << messages[error::matched]
@@ -668,24 +791,8 @@ std::vector<Admin*> GeoRef::find_admins(const type::GeographicalCoord& coord) co
     }
 }
 
-std::vector<Admin*> search_admins(const type::GeographicalCoord& coord, AdminRtree& admins_tree) {
-    std::vector<Admin*> result;
-
-    auto callback = [](Admin* admin, void* c) -> bool {
-        auto* context = reinterpret_cast<std::pair<type::GeographicalCoord, std::vector<Admin*>*>*>(c);
-        if (boost::geometry::within(context->first, admin->boundary)) {
-            context->second->push_back(admin);
-        }
-        return true;
-    };
-    double c[2] = {coord.lon(), coord.lat()};
-    auto context = std::make_pair(coord, &result);
-    admins_tree.Search(c, c, callback, &context);
-    return result;
-}
-
-std::vector<Admin*> GeoRef::find_admins(const type::GeographicalCoord& coord, AdminRtree& admins_tree) const {
-    auto result = search_admins(coord, admins_tree);
+std::vector<Admin*> GeoRef::find_admins(const type::GeographicalCoord& coord, const AdminIndex& admin_index) const {
+    auto result = admin_index.find(coord);
 
     if (result.empty()) {
         // we didn't find any result within the boundary, as a fallback we retrieve the admin of the closest way
@@ -720,63 +827,99 @@ std::pair<GeoRef::ProjectionByMode, bool> GeoRef::project_coord(const type::Geog
     return {projections, one_proj_found};
 }
 
+std::vector<std::pair<GeoRef::ProjectionByMode, bool>> GeoRef::project_coords(
+    const std::vector<type::GeographicalCoord>& coords,
+    const std::vector<bool>& to_project) const {
+    std::vector<std::pair<ProjectionByMode, bool>> projections(coords.size());
+    // the neighbouring coordinates are projected by the same worker, on the same part of the edge index
+    const auto order = proximitylist::sort_along_grid(coords);
+
+    // a chunk is small enough to balance the dense and the sparse areas
+    parallel_for_chunks(coords.size(), 256, 0, [&](const size_t begin, const size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            const auto i = order[k];
+            if (to_project.empty() || to_project[i]) {
+                projections[i] = project_coord(coords[i]);
+            }
+        }
+    });
+    return projections;
+}
+
 vertex_t GeoRef::nearest_vertex(const type::GeographicalCoord& coordinates,
                                 const proximitylist::ProximityList<vertex_t>& prox) const {
     return prox.find_nearest(coordinates);
 }
 
 edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates) const {
-    return nearest_edge(coordinates, pl_walking);
+    return nearest_edge(coordinates, offsets[nt::Mode_e::Walking]);
 }
 
 edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates, type::Mode_e mode) const {
     switch (mode) {
         case type::Mode_e::Walking:
         case type::Mode_e::Bss:
-            return nearest_edge(coordinates, pl_walking);
+            return nearest_edge(coordinates, offsets[nt::Mode_e::Walking]);
         case type::Mode_e::Bike:
-            return nearest_edge(coordinates, pl_bike);
+            return nearest_edge(coordinates, offsets[nt::Mode_e::Bike]);
         case type::Mode_e::Car:
         case type::Mode_e::CarNoPark:
-            return nearest_edge(coordinates, pl_car);
+            return nearest_edge(coordinates, offsets[nt::Mode_e::Car]);
         default:
             throw navitia::recoverable_exception("Unknown mode when looking for nearest edges");
     }
 }
 
-/// Get the nearest_edge with at least one vertex in the graph corresponding to the offset (walking, bike, ...)
-edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates,
-                            const proximitylist::ProximityList<vertex_t>& prox,
-                            double horizon) const {
+// approximate squared distance in meters between the coordinate and the edge, on its geometry if there is one
+static float edge_sqr_distance(const GeoRef& geo_ref,
+                               const edge_t& e,
+                               const type::GeographicalCoord& coord,
+                               double coslat) {
+    const auto& edge = geo_ref.graph[e];
+    if (edge.geom_idx != nt::invalid_idx) {
+        const auto projected = type::project(geo_ref.ways[edge.way_idx]->geoms[edge.geom_idx], coord);
+        return coord.approx_sqr_distance(projected, coslat);
+    }
+    const float dist = coord
+                           .approx_project(geo_ref.graph[boost::source(e, geo_ref.graph)].coord,
+                                           geo_ref.graph[boost::target(e, geo_ref.graph)].coord, coslat)
+                           .second;
+    return dist * dist;
+}
+
+/// Get the nearest_edge within the horizon in the graph corresponding to the offset (walking, bike, ...)
+edge_t GeoRef::nearest_edge(const type::GeographicalCoord& coordinates, nt::idx_t offset, double horizon) const {
+    // the first search box is enough in town, it grows in the sparse areas
+    constexpr double first_search_radius = 50;
+
     boost::optional<edge_t> res;
-    float min_dist = 0., cur_dist = 0.;
-    double coslat = ::cos(coordinates.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
-
-    // TODO: set different nb for different modes
-    // we can set -1 for both walking and bike mode
-    // set smaller number (ex: 50) for car
-    constexpr int nb_nearest_vertices = -1;
-
-    for (const auto& u : prox.find_within<proximitylist::IndexOnly>(coordinates, horizon, nb_nearest_vertices)) {
-        BOOST_FOREACH (const edge_t& e, boost::out_edges(u, graph)) {
-            const auto& v = target(e, graph);
-            auto source_mode = get_mode(u);
-            auto target_mode = get_mode(v);
-            if (source_mode != target_mode) {
-                continue;
-            }
-            const auto& edge = graph[e];
-            // If there is a geometry for this edge get the projected point to get the distance
-            if (edge.geom_idx != nt::invalid_idx) {
-                const auto projected = type::project(ways[edge.way_idx]->geoms[edge.geom_idx], coordinates);
-                cur_dist = coordinates.approx_sqr_distance(projected, coslat);
-            } else {
-                cur_dist = coordinates.approx_project(graph[u].coord, graph[v].coord, coslat).second;
-            }
-            if (!res || cur_dist < min_dist) {
-                min_dist = cur_dist;
-                res = e;
+    // between edges at the same distance (both directions of a street), the one leaving the nearest vertex is kept
+    auto min_dist = std::make_tuple(0.f, 0., vertex_t(0));
+    const double coslat = ::cos(coordinates.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+    const float sqr_horizon = horizon * horizon;
+
+    for (double radius = std::min(first_search_radius, horizon);; radius = std::min(4 * radius, horizon)) {
+        edge_rtree.for_each_vertex(coordinates, radius, [&](vertex_t v) {
+            const vertex_t u = offset + v;
+            BOOST_FOREACH (const edge_t& e, boost::out_edges(u, graph)) {
+                if (get_mode(u) != get_mode(boost::target(e, graph))) {
+                    continue;
+                }
+                const float sqr_dist = edge_sqr_distance(*this, e, coordinates, coslat);
+                if (sqr_dist > sqr_horizon) {
+                    continue;
+                }
+                const auto cur_dist =
+                    std::make_tuple(sqr_dist, coordinates.approx_sqr_distance(graph[u].coord, coslat), u);
+                if (!res || cur_dist < min_dist) {
+                    min_dist = cur_dist;
+                    res = e;
+                }
             }
+        });
+        // an edge out of the search box is farther than the radius
+        if ((res && std::get<0>(min_dist) <= radius * radius) || radius >= horizon) {
+            break;
         }
     }
     if (res) {
@@ -792,19 +935,22 @@ std::pair<int, const Way*> GeoRef::nearest_addr(const type::GeographicalCoord& c
 
 std::pair<int, const Way*> GeoRef::nearest_addr(const type::GeographicalCoord& coord,
                                                 const std::function<bool(const Way&)>& filter) const {
-    // first, we collect each ways with its distance to the coord
+    constexpr double horizon = 500;
+    const double coslat = ::cos(coord.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+
+    // first, we collect each ways near the coord with its distance to the coord
     std::map<const Way*, double> way_dist;
-    for (const auto& ind : pl_walking.find_within<proximitylist::IndexOnly>(coord)) {
-        BOOST_FOREACH (const edge_t& e, boost::out_edges(ind, graph)) {
+    edge_rtree.for_each_vertex(coord, horizon, [&](vertex_t v) {
+        BOOST_FOREACH (const edge_t& e, boost::out_edges(offsets[nt::Mode_e::Walking] + v, graph)) {
             const Way* w = ways[graph[e].way_idx];
-            if (filter(*w)) {
+            if (filter(*w) || way_dist.count(w) != 0) {
                 continue;
             }
-            if (way_dist.count(w) == 0) {
+            if (edge_sqr_distance(*this, e, coord, coslat) <= horizon * horizon) {
                 way_dist[w] = coord.distance_to(w->projected_centroid(graph));
             }
         }
-    }
+    });
     if (way_dist.empty()) {
         throw proximitylist::NotFound();
     }
@@ -32,13 +32,18 @@ www.navitia.io
 #include "autocomplete/autocomplete.h"
 #include "proximity_list/proximity_list.h"
 #include "adminref.h"
+#include "georef/admin_index.h"
 #include "utils/exception.h"
 #include "utils/flat_enum_map.h"
 #include "utils/serialization_vector.h"
 #include "type/time_duration.h"
 #include "georef/fwd_georef.h"
 #include "georef/georef_types.h"
+#include "georef/contraction_hierarchy.h"
+#include "georef/csr_graph.h"
+#include "georef/edge_rtree.h"
 #include "georef/projection_data.h"
+#include "georef/stop_point_walking_table.h"
 
 #include <boost/graph/adj_list_serialize.hpp>
 #include <boost/serialization/serialization.hpp>
@@ -46,6 +51,7 @@ www.navitia.io
 #include <boost/serialization/set.hpp>
 
 #include <map>
+#include <memory>
 #include <set>
 #include <functional>
 
@@ -176,8 +182,6 @@ struct Path {
     std::deque<PathItem> path_items = {};  //< List of street used
 };
 
-std::vector<Admin*> search_admins(const type::GeographicalCoord& coord, AdminRtree& admins_tree);
-
 /** All you need about the street network */
 struct GeoRef {
     // parameters
@@ -222,6 +226,22 @@ struct GeoRef {
     /// Graphe pour effectuer le calcul d'itinéraire
     Graph graph;
 
+    /// Compact copy of the graph used by the searches, not serialized: built with the proximity lists
+    CsrGraph csr_graph;
+
+    /// Spatial index of the edges used by the projections, not serialized: built with the proximity lists
+    EdgeRtree edge_rtree;
+
+    /// Index of the admins by boundary, not serialized like the boundaries: built with the administrative regions
+    AdminIndex admin_index;
+
+    /// Optional contraction hierarchies used by the direct paths, by mode
+    /// not serialized, and shared with the clones of the data as the graph does not change
+    flat_enum_map<nt::Mode_e, std::shared_ptr<const ContractionHierarchy>> contraction_hierarchies;
+
+    /// Optional walking durations between the stop points, not serialized, built after the projections
+    std::shared_ptr<const StopPointWalkingTable> stop_point_walking_table;
+
     /*
      * We have 3 graphs :
      *  1/ for walking
@@ -258,8 +278,25 @@ struct GeoRef {
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
-    /** Construit l'indexe spatial */
-    void build_proximity_list();
+    /** Construit l'indexe spatial
+     *
+     * The compact graph and the R-tree of the edges of previous are copied instead of being built again,
+     * previous has to be a georef with the same street network, like the one the data has been cloned from
+     */
+    void build_proximity_list(const GeoRef* previous = nullptr);
+
+    /// Build the contraction hierarchies of the given modes, the compact graph has to be built
+    void build_contraction_hierarchies(const std::vector<nt::Mode_e>& modes);
+
+    /**
+     * Build the walking durations from the vertices to the stop points within the radius, the stop points have
+     * to be projected. The rows of the previous table are kept for the stop points that have not moved
+     */
+    void build_stop_point_walking_table(const navitia::time_duration& radius,
+                                        const StopPointWalkingTable* previous = nullptr);
+
+    /// Reuse what has been built for the other georef if it has the same graph
+    void warmup(const GeoRef& other);
 
     ///  Construit l'indexe autocomplete à partir des rues
     void build_autocomplete_list();
@@ -280,12 +317,17 @@ struct GeoRef {
                                                                    const std::function<bool(nt::idx_t)>& keep_element,
                                                                    const std::set<std::string>& ghostwords) const;
     std::vector<Admin*> find_admins(const type::GeographicalCoord&) const;
-    std::vector<Admin*> find_admins(const type::GeographicalCoord&, AdminRtree&) const;
+    /// The admins whose boundary contains the coordinate, or the ones of the closest way if there is none
+    std::vector<Admin*> find_admins(const type::GeographicalCoord&, const AdminIndex&) const;
 
     /**
      * Project each stop_point and their access points(if any) on the georef network
+     *
+     * The coordinates are projected in parallel, by chunks. The projections of previous are
+     * reused for the coordinates it has already projected, if it has the same street network.
      */
-    void project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points);
+    void project_stop_points_and_access_points(const std::vector<type::StopPoint*>& stop_points,
+                                               const GeoRef* previous = nullptr);
 
     /** project the a coordinate on all transportation mode
      * return a pair with :
@@ -294,10 +336,19 @@ struct GeoRef {
      */
     std::pair<ProjectionByMode, bool> project_coord(const type::GeographicalCoord& coord) const;
 
+    /** project_coord for each coordinate, on several threads
+     *
+     * The coordinates are projected along the grid of the proximity lists, the results being in the
+     * order of coords. If to_project is not empty, only the flagged coordinates are projected, the
+     * others being left not found.
+     */
+    std::vector<std::pair<ProjectionByMode, bool>> project_coords(const std::vector<type::GeographicalCoord>& coords,
+                                                                  const std::vector<bool>& to_project = {}) const;
+
     /** Retourne l'arc (segment) le plus proche
      *
-     * Pour le trouver, on cherche le nœud le plus proche, puis pour chaque arc adjacent, on garde le plus proche
-     * Ce n'est donc pas optimal, mais pour améliorer ça, il faudrait indexer des segments, ou ratisser plus large
+     * The edges are indexed in an R-tree on their geometries, the search box grows until the
+     * nearest edge found is inside it: it is then the nearest edge of the graph of the mode
      */
 
     vertex_t nearest_vertex(const type::GeographicalCoord& coordinates,
@@ -325,9 +376,7 @@ struct GeoRef {
     GeoRef(const GeoRef& other) = default;
 
 private:
-    edge_t nearest_edge(const type::GeographicalCoord& coordinates,
-                        const proximitylist::ProximityList<vertex_t>& prox,
-                        double horizon = 500) const;
+    edge_t nearest_edge(const type::GeographicalCoord& coordinates, nt::idx_t offset, double horizon = 500) const;
 };
 
 /** Nommage d'un POI (point of interest). **/
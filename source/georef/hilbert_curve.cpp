@@ -0,0 +1,95 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#include "georef/hilbert_curve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+namespace navitia {
+namespace georef {
+
+uint64_t hilbert_index(uint32_t x, uint32_t y, unsigned order) {
+    uint64_t index = 0;
+    for (uint32_t s = uint32_t(1) << (order - 1); s > 0; s /= 2) {
+        const uint32_t rx = (x & s) ? 1 : 0;
+        const uint32_t ry = (y & s) ? 1 : 0;
+        index += uint64_t(s) * s * ((3 * rx) ^ ry);
+        // rotate the quadrant so that the sub-curve starts and ends at the right corners
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+std::vector<size_t> hilbert_order(const std::vector<type::GeographicalCoord>& coords) {
+    constexpr unsigned order = 20;
+    constexpr double max_cell = (1 << order) - 1;
+
+    std::vector<size_t> indexes(coords.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    if (coords.empty()) {
+        return indexes;
+    }
+
+    double min_lon = coords.front().lon(), max_lon = min_lon;
+    double min_lat = coords.front().lat(), max_lat = min_lat;
+    for (const auto& coord : coords) {
+        min_lon = std::min(min_lon, coord.lon());
+        max_lon = std::max(max_lon, coord.lon());
+        min_lat = std::min(min_lat, coord.lat());
+        max_lat = std::max(max_lat, coord.lat());
+    }
+    // same scale on both axes, the cells are squares in degrees
+    const double extent = std::max(max_lon - min_lon, max_lat - min_lat);
+    const double scale = extent > 0 ? max_cell / extent : 0;
+
+    std::vector<uint64_t> positions;
+    positions.reserve(coords.size());
+    for (const auto& coord : coords) {
+        const auto x = uint32_t(std::lround((coord.lon() - min_lon) * scale));
+        const auto y = uint32_t(std::lround((coord.lat() - min_lat) * scale));
+        positions.push_back(hilbert_index(x, y, order));
+    }
+    std::stable_sort(indexes.begin(), indexes.end(),
+                     [&](size_t lhs, size_t rhs) { return positions[lhs] < positions[rhs]; });
+    return indexes;
+}
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,57 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#pragma once
+
+#include "type/geographical_coord.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/** Position of the cell (x, y) along the Hilbert curve filling a 2^order x 2^order grid
+ *
+ * Two consecutive positions are neighbouring cells, and the cells of a square of the grid
+ * have close positions: sorting points by position keeps the close points together.
+ */
+uint64_t hilbert_index(uint32_t x, uint32_t y, unsigned order);
+
+/** Order of the coordinates along a Hilbert curve over their bounding box
+ *
+ * Returns the indexes of the coordinates, sorted by position on the curve. The curve has
+ * 2^20 cells by side, about 1m for a whole country, the coordinates of a cell keep their order.
+ */
+std::vector<size_t> hilbert_order(const std::vector<type::GeographicalCoord>& coords);
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,147 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "many_to_many_path_finder.h"
+
+#include "georef/georef.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace navitia {
+namespace georef {
+
+ManyToManyPathFinder::~ManyToManyPathFinder() = default;
+
+std::vector<std::vector<RoutingElement>> ManyToManyPathFinder::compute_matrix(
+    const ContractionHierarchy& ch,
+    const std::vector<type::GeographicalCoord>& origins,
+    const std::vector<type::GeographicalCoord>& destinations,
+    nt::Mode_e mode,
+    const float speed_factor,
+    const navitia::time_duration& radius) {
+    // no init_start: the searches only touch the hierarchy, not the distances of the whole graph
+    computation_launch = true;
+    this->mode = mode;
+    this->speed_factor = speed_factor;
+    const double max_cost = double(radius.ticks());
+
+    // the destinations are projected as in get_duration_with_dijkstra
+    const auto dest_mode = mode == nt::Mode_e::Car ? nt::Mode_e::Walking : mode;
+    std::vector<ProjectionData> projections;
+    projections.reserve(destinations.size());
+    for (const auto& coord : destinations) {
+        const auto it = geo_ref.projected_coords.find(coord);
+        if (it != geo_ref.projected_coords.end()) {
+            projections.push_back(it->second[dest_mode]);
+        } else {
+            projections.emplace_back(coord, geo_ref, dest_mode);
+        }
+    }
+
+    buckets.clear();
+    std::vector<std::pair<vertex_t, double>> seeds;
+    for (size_t i = 0; i < projections.size(); ++i) {
+        const auto& projection = projections[i];
+        if (!projection.found) {
+            continue;
+        }
+        // as in find_nearest_vertex, when the destination is projected on a node only this node is used
+        seeds.clear();
+        if (projection.distances[source_e] < 0.01) {
+            seeds.emplace_back(projection[source_e], 0.);
+        } else if (projection.distances[target_e] < 0.01) {
+            seeds.emplace_back(projection[target_e], 0.);
+        } else {
+            for (const auto direction : {source_e, target_e}) {
+                seeds.emplace_back(projection[direction],
+                                   double(crow_fly_duration(projection.distances[direction]).ticks()));
+            }
+        }
+        ch_query.upward_search(ch, seeds, speed_factor, max_cost, false,
+                               [&](vertex_t v, double cost) { buckets.push_back({v, i, cost}); });
+    }
+    std::sort(buckets.begin(), buckets.end(),
+              [](const BucketEntry& a, const BucketEntry& b) { return a.vertex < b.vertex; });
+
+    std::vector<std::vector<RoutingElement>> result;
+    result.reserve(origins.size());
+    std::vector<double> costs;
+    for (const auto& origin : origins) {
+        start_coord = origin;
+        starting_edge = ProjectionData(origin, geo_ref, mode);
+        costs.assign(destinations.size(), std::numeric_limits<double>::infinity());
+
+        if (starting_edge.found) {
+            seeds.clear();
+            const auto starting_durations = get_starting_durations();
+            for (const auto direction : {source_e, target_e}) {
+                if (starting_durations[direction] != bt::pos_infin) {
+                    seeds.emplace_back(starting_edge[direction], double(starting_durations[direction].ticks()));
+                }
+            }
+            ch_query.upward_search(ch, seeds, speed_factor, max_cost, true, [&](vertex_t v, double cost) {
+                const auto range = std::equal_range(
+                    buckets.begin(), buckets.end(), BucketEntry{v, 0, 0.},
+                    [](const BucketEntry& a, const BucketEntry& b) { return a.vertex < b.vertex; });
+                for (auto it = range.first; it != range.second; ++it) {
+                    costs[it->destination] = std::min(costs[it->destination], cost + it->cost);
+                }
+            });
+        }
+
+        std::vector<RoutingElement> row;
+        row.reserve(destinations.size());
+        for (size_t i = 0; i < destinations.size(); ++i) {
+            const auto& projection = projections[i];
+            if (!projection.found) {
+                row.emplace_back(navitia::time_duration(), RoutingStatus_e::unknown);
+                continue;
+            }
+            navitia::time_duration duration = bt::pos_infin;
+            if (starting_edge.found && is_projected_on_same_edge(starting_edge, projection)) {
+                // the hierarchy does not know the paths along a single edge
+                duration = path_duration_on_same_edge(starting_edge, projection);
+            } else if (!std::isinf(costs[i])) {
+                duration = navitia::time_duration(0, 0, 0, std::llround(costs[i]));
+            }
+            if (duration <= radius) {
+                row.emplace_back(duration, RoutingStatus_e::reached);
+            } else {
+                row.emplace_back(navitia::time_duration(), RoutingStatus_e::unreached);
+            }
+        }
+        result.push_back(std::move(row));
+    }
+    return result;
+}
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,78 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "path_finder.h"
+#include "contraction_hierarchy.h"
+
+namespace navitia {
+namespace georef {
+
+/** Street network durations from several origins to several destinations on a contraction hierarchy
+ *
+ * Bucket many-to-many: a backward upward search is run once from each destination and the
+ * vertices it settles are stored with their cost in buckets. The forward upward search of each
+ * origin then scans the buckets of the vertices it settles: the shortest path to a destination
+ * meets the backward search of this destination on its highest vertex.
+ * The cost is one upward search by origin and by destination instead of one Dijkstra by origin.
+ */
+class ManyToManyPathFinder : public PathFinder {
+public:
+    ManyToManyPathFinder(const GeoRef& geo_ref) : PathFinder(geo_ref) {}
+    ManyToManyPathFinder(const ManyToManyPathFinder& o) = default;
+    ~ManyToManyPathFinder() override;
+
+    /**
+     * Compute the durations from each origin to each destination, the rows are the origins
+     * The destinations are projected as get_duration_with_dijkstra does, and the statuses are the same:
+     * unknown for a destination not projected, unreached beyond the radius
+     */
+    std::vector<std::vector<RoutingElement>> compute_matrix(const ContractionHierarchy& ch,
+                                                            const std::vector<type::GeographicalCoord>& origins,
+                                                            const std::vector<type::GeographicalCoord>& destinations,
+                                                            nt::Mode_e mode,
+                                                            const float speed_factor,
+                                                            const navitia::time_duration& radius);
+
+private:
+    struct BucketEntry {
+        vertex_t vertex;
+        size_t destination;
+        double cost;
+    };
+
+    // buffers kept between the matrices
+    ContractionHierarchyQuery ch_query;
+    std::vector<BucketEntry> buckets;
+};
+
+}  // namespace georef
+}  // namespace navitia
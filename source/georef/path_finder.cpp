@@ -89,8 +89,7 @@ nt::LineString PathFinder::path_coordinates_on_same_edge(const Edge& e,
     return result;
 }
 
-PathFinder::PathFinder(const GeoRef& gref)
-    : geo_ref(gref), mode(nt::Mode_e::Walking), color(boost::num_vertices(geo_ref.graph)) {}
+PathFinder::PathFinder(const GeoRef& gref) : geo_ref(gref), mode(nt::Mode_e::Walking) {}
 
 void PathFinder::init_start(const type::GeographicalCoord& start_coord, nt::Mode_e mode, const float speed_factor) {
     computation_launch = false;
@@ -104,34 +103,44 @@ void PathFinder::init_start(const type::GeographicalCoord& start_coord, nt::Mode
     distance_to_entry_point.clear();
     // we initialize the distances to the maximum value
     size_t n = boost::num_vertices(geo_ref.graph);
-    distances.assign(n, bt::pos_infin);
+    distances.reset(n, bt::pos_infin);
     // for the predecessors no need to clean the values, the important one will be updated during search
-    predecessors.resize(n);
-    index_in_heap_map.resize(n);
+    // but the pages used by the previous search are released
+    predecessors.reset(n, vertex_t());
+    index_in_heap_map.reset(n, 0);
 
     if (starting_edge.found) {
         // durations initializations
-        distances[starting_edge[source_e]] = crow_fly_duration(
-            starting_edge.distances[source_e]);  // for the projection, we use the default walking speed.
-        distances[starting_edge[target_e]] = crow_fly_duration(starting_edge.distances[target_e]);
+        const auto starting_durations = get_starting_durations();
+        distances[starting_edge[source_e]] = starting_durations[source_e];
+        distances[starting_edge[target_e]] = starting_durations[target_e];
         predecessors[starting_edge[source_e]] = starting_edge[source_e];
         predecessors[starting_edge[target_e]] = starting_edge[target_e];
 
-        if (starting_edge[target_e] != starting_edge[source_e]) {  // if we're on a useless edge we do not enhance
-            // small enchancement, if the projection is done on a node, we disable the crow fly
-            if (starting_edge.distances[source_e] < 0.01) {
-                predecessors[starting_edge[target_e]] = starting_edge[source_e];
-                distances[starting_edge[target_e]] = bt::pos_infin;
-            } else if (starting_edge.distances[target_e] < 0.01) {
-                predecessors[starting_edge[source_e]] = starting_edge[target_e];
-                distances[starting_edge[source_e]] = bt::pos_infin;
-            }
+        // the vertex not used as a start is reached from the other one
+        if (starting_durations[target_e] == bt::pos_infin) {
+            predecessors[starting_edge[target_e]] = starting_edge[source_e];
+        } else if (starting_durations[source_e] == bt::pos_infin) {
+            predecessors[starting_edge[source_e]] = starting_edge[target_e];
         }
     }
+}
 
-    if (color.n != n) {
-        color = boost::two_bit_color_map<>(n);
+flat_enum_map<ProjectionData::Direction, navitia::time_duration> PathFinder::get_starting_durations() const {
+    // for the projection, we use the default walking speed.
+    flat_enum_map<ProjectionData::Direction, navitia::time_duration> result;
+    result[source_e] = crow_fly_duration(starting_edge.distances[source_e]);
+    result[target_e] = crow_fly_duration(starting_edge.distances[target_e]);
+
+    if (starting_edge[target_e] != starting_edge[source_e]) {  // if we're on a useless edge we do not enhance
+        // small enchancement, if the projection is done on a node, we disable the crow fly
+        if (starting_edge.distances[source_e] < 0.01) {
+            result[target_e] = bt::pos_infin;
+        } else if (starting_edge.distances[target_e] < 0.01) {
+            result[source_e] = bt::pos_infin;
+        }
     }
+    return result;
 }
 
 std::pair<navitia::time_duration, ProjectionData::Direction> PathFinder::find_nearest_vertex(
@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 
 #include "georef.h"
+#include "sparse_vertex_map.h"
 #include "routing/raptor_utils.h"
 
 #include <boost/graph/two_bit_color_map.hpp>
@@ -130,17 +131,20 @@ public:
     // Distance map between entry point and stop point
     std::map<routing::SpIdx, navitia::time_duration> distance_to_entry_point;
 
+    // The states of the searches by vertex are sparse: only the pages of the searched area
+    // are allocated and reset, not the whole graph with its copies by mode
+
     // Distance array for the Dijkstra
-    std::vector<navitia::time_duration> distances;
+    SparseVertexMap<navitia::time_duration> distances;
 
     // Predecessors array for the Dijkstra
-    std::vector<vertex_t> predecessors;
+    SparseVertexMap<vertex_t> predecessors;
 
     // helper for dijkstra internal heap (to avoid extra alloc)
-    std::vector<std::size_t> index_in_heap_map;
+    SparseVertexMap<std::size_t> index_in_heap_map;
 
     // Color map for the dijkstra shortest path (to avoid extra alloc)
-    boost::two_bit_color_map<> color;
+    SparseVertexMap<boost::two_bit_color_type> color;
 
     PathFinder(const GeoRef& gref);
     PathFinder(const PathFinder& o) = default;
@@ -180,6 +184,9 @@ protected:
     // return the time the travel the distance at the current speed (used for projections)
     navitia::time_duration crow_fly_duration(const double distance) const;
 
+    // durations to the vertices of the starting edge, pos_infin for a vertex the search does not start from
+    flat_enum_map<ProjectionData::Direction, navitia::time_duration> get_starting_durations() const;
+
     PathItem::TransportCaracteristic get_transportation_mode_item_to_update(
         const PathItem::TransportCaracteristic& previous_transportation,
         bool append_to_begin) const;
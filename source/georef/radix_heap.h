@@ -0,0 +1,108 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/** Monotone priority queue on 32 bits integer keys
+ *
+ * A Dijkstra only pushes keys greater or equal to the last popped one. The radix heap
+ * uses it: an entry is stored in the bucket of the highest bit where its key differs
+ * from the last popped key, bucket 0 holding the keys equal to it. When bucket 0 is
+ * empty, the first non empty bucket is redistributed around its minimum, each entry
+ * moving to a lower bucket, so an entry is moved at most 32 times.
+ * There is no decrease key: the same value can be pushed several times, the
+ * outdated entries have to be skipped by the caller.
+ *
+ * The buckets keep their capacity between the searches, clear() does not free them.
+ */
+template <typename Value>
+class RadixHeap {
+public:
+    using Entry = std::pair<uint32_t, Value>;
+
+    bool empty() const { return size == 0; }
+
+    void clear() {
+        for (auto& bucket : buckets) {
+            bucket.clear();
+        }
+        size = 0;
+        last = 0;
+    }
+
+    /// the key has to be greater or equal to the last popped key
+    void push(uint32_t key, const Value& value) {
+        buckets[bucket_of(key)].emplace_back(key, value);
+        ++size;
+    }
+
+    Entry pop() {
+        if (buckets[0].empty()) {
+            size_t i = 1;
+            while (buckets[i].empty()) {
+                ++i;
+            }
+            uint32_t new_last = buckets[i].front().first;
+            for (const auto& entry : buckets[i]) {
+                new_last = std::min(new_last, entry.first);
+            }
+            last = new_last;
+            for (const auto& entry : buckets[i]) {
+                buckets[bucket_of(entry.first)].push_back(entry);
+            }
+            buckets[i].clear();
+        }
+        const auto entry = buckets[0].back();
+        buckets[0].pop_back();
+        --size;
+        return entry;
+    }
+
+private:
+    size_t bucket_of(uint32_t key) const {
+        const uint32_t diff = key ^ last;
+        return diff == 0 ? 0 : 32 - __builtin_clz(diff);
+    }
+
+    std::vector<Entry> buckets[33];
+    size_t size = 0;
+    uint32_t last = 0;
+};
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,152 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "georef/georef_types.h"
+
+#include <boost/property_map/property_map.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/** Value by vertex for the searches, with a memory and a reset proportional to the searched area
+ *
+ * The vertices are grouped by pages of page_size consecutive indexes, and a page is only
+ * allocated when one of its vertices is written. The other vertices read the default value.
+ * The neighbor vertices have close indexes, so a search around a point touches a few pages
+ * whatever the size of the graph (the graph holds a copy of the streets by mode).
+ *
+ * reset() only goes through the pages used by the previous search, and keeps them
+ * allocated for the next one.
+ *
+ * Smaller pages suit the searches whose vertices are scattered across the graph.
+ */
+template <typename T, size_t PageBits = 10>
+class SparseVertexMap {
+public:
+    static constexpr size_t page_bits = PageBits;
+    static constexpr size_t page_size = size_t(1) << page_bits;
+
+    SparseVertexMap() = default;
+    explicit SparseVertexMap(const T& default_value) : default_value(default_value) {}
+
+    /// all the vertices of a graph of nb_vertices read default_value again
+    void reset(size_t nb_vertices, const T& default_value) {
+        this->default_value = default_value;
+        const size_t nb_pages = (nb_vertices + page_size - 1) >> page_bits;
+        if (nb_vertices != this->nb_vertices) {
+            this->nb_vertices = nb_vertices;
+            page_slots.assign(nb_pages, no_slot);
+        } else {
+            for (const auto page : used_pages) {
+                page_slots[page] = no_slot;
+            }
+        }
+        used_pages.clear();
+    }
+
+    size_t size() const { return nb_vertices; }
+    size_t nb_used_pages() const { return used_pages.size(); }
+
+    const T& operator[](vertex_t v) const {
+        const uint32_t slot = page_slots[v >> page_bits];
+        return slot == no_slot ? default_value : pool[slot][v & (page_size - 1)];
+    }
+
+    /// checked access, like std::vector::at
+    const T& at(vertex_t v) const {
+        if (v >= nb_vertices) {
+            throw std::out_of_range("SparseVertexMap::at");
+        }
+        return (*this)[v];
+    }
+
+    T& operator[](vertex_t v) {
+        uint32_t& slot = page_slots[v >> page_bits];
+        if (slot == no_slot) {
+            slot = use_page(v >> page_bits);
+        }
+        return pool[slot][v & (page_size - 1)];
+    }
+
+    /// boost property map on the values, for the boost heaps and searches
+    struct PropertyMap : boost::put_get_helper<T&, PropertyMap> {
+        using key_type = vertex_t;
+        using value_type = T;
+        using reference = T&;
+        using category = boost::lvalue_property_map_tag;
+
+        explicit PropertyMap(SparseVertexMap* map) : map(map) {}
+        T& operator[](vertex_t v) const { return (*map)[v]; }
+
+        SparseVertexMap* map;
+    };
+    PropertyMap property_map() { return PropertyMap(this); }
+
+private:
+    static constexpr uint32_t no_slot = std::numeric_limits<uint32_t>::max();
+
+    uint32_t use_page(size_t page) {
+        // the slots are given in the same order after each reset, the pages of the pool are reused
+        const auto slot = uint32_t(used_pages.size());
+        if (slot == pool.size()) {
+            pool.emplace_back(page_size, default_value);
+        } else {
+            std::fill(pool[slot].begin(), pool[slot].end(), default_value);
+        }
+        used_pages.push_back(page);
+        return slot;
+    }
+
+    T default_value = T();
+    size_t nb_vertices = 0;
+    // slot in the pool of each page, no_slot if the page is not used
+    std::vector<uint32_t> page_slots;
+    // pages used since the last reset, the page of slot i is used_pages[i]
+    std::vector<size_t> used_pages;
+    // the inner vectors do not move their values when the pool grows, the references stay valid
+    std::vector<std::vector<T>> pool;
+};
+
+template <typename T, size_t PageBits>
+constexpr size_t SparseVertexMap<T, PageBits>::page_bits;
+template <typename T, size_t PageBits>
+constexpr size_t SparseVertexMap<T, PageBits>::page_size;
+template <typename T, size_t PageBits>
+constexpr uint32_t SparseVertexMap<T, PageBits>::no_slot;
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,215 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#include "stop_point_walking_table.h"
+
+#include "georef/georef.h"
+#include "georef/path_finder.h"
+
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace navitia {
+namespace georef {
+
+// hash of the walking projection of a stop point, the durations of its row depend on it
+static uint64_t walking_projection_fingerprint(const GeoRef::ProjectionByMode& projections) {
+    // FNV-1a on the 64 bits words
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&](uint64_t value) { hash = (hash ^ value) * 1099511628211ULL; };
+    auto add_double = [&](double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        add(bits);
+    };
+    const auto& projection = projections[nt::Mode_e::Walking];
+    add(projection.found);
+    if (!projection.found) {
+        return hash;
+    }
+    for (const auto direction : {source_e, target_e}) {
+        add(projection.vertices[direction]);
+        add_double(projection.distances[direction]);
+    }
+    return hash;
+}
+
+// same conversion as PathFinder::crow_fly_duration at the default walking speed
+static navitia::time_duration walking_crow_fly_duration(const double distance) {
+    return navitia::seconds(distance / double(default_speed[nt::Mode_e::Walking] * 1.f));
+}
+
+void StopPointWalkingTable::build(const GeoRef& geo_ref,
+                                  const navitia::time_duration& radius,
+                                  const StopPointWalkingTable* previous) {
+    const auto& projected_stop_points = geo_ref.projected_stop_points;
+    this->radius = radius;
+    graph_fingerprint = geo_ref.csr_graph.source_fingerprint();
+    projection_fingerprints.clear();
+    projection_fingerprints.reserve(projected_stop_points.size());
+    for (const auto& projections : projected_stop_points) {
+        projection_fingerprints.push_back(walking_projection_fingerprint(projections));
+    }
+    if (previous && (previous->radius != radius || previous->graph_fingerprint != graph_fingerprint)) {
+        previous = nullptr;
+    }
+    offsets.assign(1, 0);
+    offsets.reserve(projected_stop_points.size() + 1);
+    entries.clear();
+    computed_rows = 0;
+
+    for (size_t stop_point = 0; stop_point < projected_stop_points.size(); ++stop_point) {
+        if (previous && stop_point < previous->nb_stop_points()
+            && previous->projection_fingerprints[stop_point] == projection_fingerprints[stop_point]) {
+            entries.insert(entries.end(), previous->entries.begin() + previous->offsets[stop_point],
+                           previous->entries.begin() + previous->offsets[stop_point + 1]);
+        } else if (projected_stop_points[stop_point][nt::Mode_e::Walking].found) {
+            compute_row(geo_ref, projected_stop_points[stop_point][nt::Mode_e::Walking]);
+            ++computed_rows;
+        }
+        offsets.push_back(uint32_t(entries.size()));
+    }
+    entries.shrink_to_fit();
+
+    reverse_offsets = {};
+    reverse_edges = {};
+    distances = {};
+    reached = {};
+    heap.clear();
+}
+
+void StopPointWalkingTable::compute_row(const GeoRef& geo_ref, const ProjectionData& projection) {
+    using navitia::time_duration;
+    const auto nb_vertices = uint32_t(geo_ref.nb_vertex_by_mode);
+    if (reverse_offsets.empty()) {
+        // the walking copy of the graph is the first one, each walking edge is stored on its target
+        reverse_offsets.assign(nb_vertices + 1, 0);
+        for (uint32_t v = 0; v < nb_vertices; ++v) {
+            BOOST_FOREACH (edge_t e, boost::out_edges(v, geo_ref.graph)) {
+                const auto target = boost::target(e, geo_ref.graph);
+                if (target < nb_vertices) {
+                    ++reverse_offsets[target + 1];
+                }
+            }
+        }
+        for (uint32_t v = 0; v < nb_vertices; ++v) {
+            reverse_offsets[v + 1] += reverse_offsets[v];
+        }
+        reverse_edges.resize(reverse_offsets.back());
+        auto next = reverse_offsets;
+        for (uint32_t v = 0; v < nb_vertices; ++v) {
+            BOOST_FOREACH (edge_t e, boost::out_edges(v, geo_ref.graph)) {
+                const auto target = boost::target(e, geo_ref.graph);
+                if (target < nb_vertices) {
+                    reverse_edges[next[target]++] = {v, geo_ref.graph[e].duration};
+                }
+            }
+        }
+        distances.assign(nb_vertices, bt::pos_infin);
+    }
+
+    // the stop point is reached from the vertices of its projection as in PathFinder::find_nearest_vertex,
+    // through the vertex only when it is projected on it
+    auto key = [](const time_duration& duration) { return uint32_t(duration.ticks()); };
+    auto push = [&](vertex_t v, const time_duration& duration) {
+        if (duration < distances[v]) {
+            if (distances[v] == bt::pos_infin) {
+                reached.push_back(uint32_t(v));
+            }
+            distances[v] = duration;
+            heap.push(key(duration), uint32_t(v));
+        }
+    };
+    heap.clear();
+    if (projection.distances[source_e] < 0.01) {
+        push(projection[source_e], time_duration());
+    } else if (projection.distances[target_e] < 0.01) {
+        push(projection[target_e], time_duration());
+    } else {
+        push(projection[source_e], walking_crow_fly_duration(projection.distances[source_e]));
+        push(projection[target_e], walking_crow_fly_duration(projection.distances[target_e]));
+    }
+
+    // the edge durations are combined as in the searches, they give the same sums
+    const SpeedDistanceCombiner combine(1.f);
+    while (!heap.empty()) {
+        const auto top = heap.pop();
+        const uint32_t v = top.second;
+        if (top.first != key(distances[v])) {
+            continue;
+        }
+        if (distances[v] > radius) {
+            break;
+        }
+        for (uint32_t i = reverse_offsets[v]; i < reverse_offsets[v + 1]; ++i) {
+            push(reverse_edges[i].vertex, combine(distances[v], reverse_edges[i].duration));
+        }
+    }
+
+    std::sort(reached.begin(), reached.end());
+    for (const auto v : reached) {
+        if (distances[v] <= radius) {
+            entries.push_back({v, distances[v]});
+        }
+        distances[v] = bt::pos_infin;
+    }
+    reached.clear();
+}
+
+bool StopPointWalkingTable::is_built_for(const GeoRef& geo_ref) const {
+    if (nb_stop_points() != geo_ref.projected_stop_points.size()
+        || graph_fingerprint != geo_ref.csr_graph.source_fingerprint()) {
+        return false;
+    }
+    for (size_t stop_point = 0; stop_point < nb_stop_points(); ++stop_point) {
+        if (projection_fingerprints[stop_point]
+            != walking_projection_fingerprint(geo_ref.projected_stop_points[stop_point])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+navitia::time_duration StopPointWalkingTable::get_duration(type::idx_t stop_point, vertex_t vertex) const {
+    const auto begin = entries.begin() + offsets[stop_point];
+    const auto end = entries.begin() + offsets[stop_point + 1];
+    const auto it =
+        std::lower_bound(begin, end, vertex, [](const Entry& entry, vertex_t v) { return entry.vertex < v; });
+    if (it == end || it->vertex != vertex) {
+        return bt::pos_infin;
+    }
+    return it->duration;
+}
+
+}  // namespace georef
+}  // namespace navitia
@@ -0,0 +1,107 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+
+#pragma once
+
+#include "georef/fwd_georef.h"
+#include "georef/georef_types.h"
+#include "georef/radix_heap.h"
+#include "type/time_duration.h"
+#include "type/type_interfaces.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace navitia {
+namespace georef {
+
+/** Walking durations from the street vertices to the stop points, precomputed at load within a radius
+ *
+ * For each stop point projected on the walking graph, the table stores the walking vertices
+ * from which the stop point is reached in less than the radius, at the default walking speed,
+ * with their duration. It is computed with a backward Dijkstra from the projection of the stop point.
+ * A walking search starting anywhere on the graph is then answered by a lookup instead of a Dijkstra:
+ * the duration to a stop point is the best duration through one of the two vertices of the starting
+ * edge, the same one as DijkstraPathFinder::find_nearest_stop_points computes.
+ *
+ * A row only depends on the graph and on the projection of its stop point: when the stop points are
+ * projected again, only the rows of the stop points added or moved are computed again.
+ * The memory grows with the square of the radius, a few thousands vertices by stop point within 10 minutes.
+ */
+class StopPointWalkingTable {
+public:
+    struct Entry {
+        uint32_t vertex;
+        navitia::time_duration duration;
+    };
+
+    /**
+     * Run a bounded backward walking Dijkstra from each stop point projected on the graph
+     * The rows of the previous table are kept for the stop points projected at the same place
+     */
+    void build(const GeoRef& geo_ref,
+               const navitia::time_duration& radius,
+               const StopPointWalkingTable* previous = nullptr);
+
+    const navitia::time_duration& get_radius() const { return radius; }
+    size_t nb_stop_points() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t num_entries() const { return entries.size(); }
+    /// Number of rows computed by the last build, the others come from the previous table
+    size_t nb_computed_rows() const { return computed_rows; }
+
+    /// The graph and the walking projections of the stop points have not changed since the build
+    bool is_built_for(const GeoRef& geo_ref) const;
+
+    /// Walking duration from the vertex to the stop point, pos_infin beyond the radius
+    navitia::time_duration get_duration(type::idx_t stop_point, vertex_t vertex) const;
+
+private:
+    void compute_row(const GeoRef& geo_ref, const ProjectionData& projection);
+
+    navitia::time_duration radius;
+    // fingerprint of the graph and of the walking projection of each stop point the rows are built for
+    uint64_t graph_fingerprint = 0;
+    std::vector<uint64_t> projection_fingerprints;
+    size_t computed_rows = 0;
+    // the entries of a stop point are sorted by vertex
+    std::vector<uint32_t> offsets;
+    std::vector<Entry> entries;
+
+    // backward walking graph and search buffers, only used by the build
+    std::vector<uint32_t> reverse_offsets;
+    std::vector<Entry> reverse_edges;
+    std::vector<navitia::time_duration> distances;
+    std::vector<uint32_t> reached;
+    RadixHeap<uint32_t> heap;
+};
+
+}  // namespace georef
+}  // namespace navitia
@@ -32,6 +32,7 @@ www.navitia.io
 #include "georef/fwd_georef.h"
 #include "dijkstra_path_finder.h"
 #include "astar_path_finder.h"
+#include "many_to_many_path_finder.h"
 #include "routing/raptor_utils.h"
 #include "type/entry_point.h"
 #include "type/time_duration.h"
@@ -65,6 +66,7 @@ struct StreetNetwork {
     DijkstraPathFinder departure_path_finder;
     DijkstraPathFinder arrival_path_finder;
     AstarPathFinder direct_path_finder;
+    ManyToManyPathFinder matrix_path_finder;
 };
 
 }  // namespace georef
@@ -0,0 +1,144 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed/synthetic_network.h"
+#include "georef/dijkstra_path_finder.h"
+#include "georef/georef.h"
+#include "tests/micro_benchmark.h"
+#include "type/pt_data.h"
+#include "utils/init.h"
+
+/*
+ * Micro-benchmarks of the street network and autocomplete hot kernels on a synthetic network
+ *
+ * Usage: georef_micro_benchmark --lines 40 --stops 30 --street_grid_step 50 --filter dijkstra
+ */
+
+namespace po = boost::program_options;
+namespace mb = navitia::micro_benchmark;
+namespace nt = navitia::type;
+using namespace navitia;
+using namespace navitia::georef;
+
+namespace {
+
+ed::SyntheticNetworkParams params;
+
+const nt::Data& get_data() {
+    static const auto b = ed::make_synthetic_network(params);
+    return *b->data;
+}
+
+// the coordinates of the stop points, used as query points
+std::vector<nt::GeographicalCoord> get_coords() {
+    std::vector<nt::GeographicalCoord> coords;
+    for (const auto* sp : get_data().pt_data->stop_points) {
+        coords.push_back(sp->coord);
+    }
+    return coords;
+}
+
+// the arg is the radius of the dijkstra, in seconds
+void bm_start_distance_dijkstra(mb::State& state) {
+    const auto& data = get_data();
+    const auto coords = get_coords();
+    DijkstraPathFinder path_finder(*data.geo_ref);
+    size_t i = 0;
+    while (state.keep_running()) {
+        state.pause_timing();
+        path_finder.init(coords[i++ % coords.size()], nt::Mode_e::Walking, 1.f);
+        state.resume_timing();
+        path_finder.start_distance_dijkstra(navitia::seconds(state.arg()));
+        mb::do_not_optimize(path_finder.distances);
+    }
+}
+NAVITIA_BENCHMARK(bm_start_distance_dijkstra).arg(300).arg(1200);
+
+// the arg is the radius, in meters
+void bm_proximity_list_find_within(mb::State& state) {
+    const auto& data = get_data();
+    const auto coords = get_coords();
+    size_t i = 0;
+    while (state.keep_running()) {
+        mb::do_not_optimize(data.pt_data->stop_point_proximity_list.find_within<proximitylist::IndexCoordDistance>(
+            coords[i++ % coords.size()], double(state.arg())));
+    }
+}
+NAVITIA_BENCHMARK(bm_proximity_list_find_within).arg(200).arg(1000);
+
+void bm_street_proximity_list_find_within(mb::State& state) {
+    const auto& data = get_data();
+    const auto coords = get_coords();
+    size_t i = 0;
+    while (state.keep_running()) {
+        mb::do_not_optimize(data.geo_ref->pl_walking.find_within<proximitylist::IndexOnly>(coords[i++ % coords.size()],
+                                                                                          double(state.arg())));
+    }
+}
+NAVITIA_BENCHMARK(bm_street_proximity_list_find_within).arg(200).arg(1000);
+
+// the arg selects the query: a short prefix matching a lot of stop areas, or a precise one
+void bm_autocomplete_find_complete(mb::State& state) {
+    const auto& data = get_data();
+    const std::string query = state.arg() == 0 ? "stop ar" : "stop area h0 1";
+    const auto keep_all = [](nt::idx_t) { return true; };
+    while (state.keep_running()) {
+        mb::do_not_optimize(
+            data.pt_data->stop_area_autocomplete.find_complete(query, 10, keep_all, data.geo_ref->ghostwords));
+    }
+}
+NAVITIA_BENCHMARK(bm_autocomplete_find_complete).arg(0).arg(1);
+
+void bm_way_autocomplete_find_complete(mb::State& state) {
+    const auto& data = get_data();
+    const auto keep_all = [](nt::idx_t) { return true; };
+    while (state.keep_running()) {
+        mb::do_not_optimize(data.geo_ref->fl_way.find_complete("rue 1", 10, keep_all, data.geo_ref->ghostwords));
+    }
+}
+NAVITIA_BENCHMARK(bm_way_autocomplete_find_complete);
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    navitia::init_app();
+    params.nb_lines = 40;
+    params.nb_stops_by_line = 30;
+    po::options_description options("Synthetic network");
+    // clang-format off
+    options.add_options()
+        ("lines", po::value<size_t>(&params.nb_lines)->default_value(params.nb_lines), "Number of lines")
+        ("stops", po::value<size_t>(&params.nb_stops_by_line)->default_value(params.nb_stops_by_line),
+            "Number of stops by line")
+        ("street_grid_step", po::value<uint32_t>(&params.street_grid_step)->default_value(params.street_grid_step),
+            "Distance between two intersections of the street grid, in meters");
+    // clang-format on
+    return mb::run_benchmarks(argc, argv, options);
+}
@@ -42,6 +42,10 @@ www.navitia.io
 #include "builder.h"
 #include "ed/build_helper.h"
 #include "georef/street_network.h"
+#include "georef/hilbert_curve.h"
+#include "georef/radix_heap.h"
+#include "georef/sparse_vertex_map.h"
+#include <boost/geometry.hpp>
 #include <boost/graph/detail/adjacency_list.hpp>
 
 struct logger_initialized {
@@ -225,6 +229,28 @@ BOOST_AUTO_TEST_CASE(real_nearest_edge) {
     BOOST_CHECK(b.geo_ref.nearest_edge(s) == b.get("a", "b"));
 }
 
+BOOST_AUTO_TEST_CASE(nearest_edge_far_from_its_vertices) {
+    GraphBuilder b;
+
+    /*              d
+                    |
+                    c
+               x
+       a-------------------------b
+    */
+    b("a", 0, 0)("b", 2000, 0)("c", 1000, 80)("d", 1000, 600);
+    b("a", "b")("c", "d");
+    b.init();
+
+    // the vertices of a-b are 1km away, but the edge is the nearest one
+    navitia::type::GeographicalCoord x(1000, 10, false);
+    BOOST_CHECK(b.geo_ref.nearest_edge(x) == b.get("a", "b"));
+    x.set_xy(1000, 70);
+    BOOST_CHECK(b.geo_ref.nearest_edge(x) == b.get("c", "d"));
+    x.set_xy(5000, 5000);
+    BOOST_CHECK_THROW(b.geo_ref.nearest_edge(x), navitia::proximitylist::NotFound);
+}
+
 /*
  * We have this graph
  *
@@ -597,6 +623,172 @@ BOOST_AUTO_TEST_CASE(parallel_and_same_vertex_edges) {
                                   p.path_items[2].coordinates.end());
 }
 
+/*
+ * The direct paths computed with a contraction hierarchy are the same as the ones of the astar
+ *
+ * 5x5 grid of streets, with 100m between the crossings and some slower streets
+ */
+BOOST_AUTO_TEST_CASE(direct_path_with_contraction_hierarchy) {
+    GraphBuilder b;
+    auto name = [](int x, int y) { return std::to_string(x) + ":" + std::to_string(y); };
+    for (int x = 0; x < 5; ++x) {
+        for (int y = 0; y < 5; ++y) {
+            b(name(x, y), x * 100, y * 100);
+        }
+    }
+    for (int x = 0; x < 5; ++x) {
+        for (int y = 0; y < 5; ++y) {
+            if (x < 4) {
+                b(name(x, y), name(x + 1, y), navitia::seconds(100 + 40 * ((x * 7 + y * 3) % 5)), true);
+            }
+            if (y < 4) {
+                b(name(x, y), name(x, y + 1), navitia::seconds(100 + 40 * ((x * 3 + y * 5) % 4)), true);
+            }
+        }
+    }
+    b.init();
+
+    const std::vector<std::pair<nt::GeographicalCoord, nt::GeographicalCoord>> journeys = {
+        {{10, 20, false}, {390, 380, false}},   {{0, 0, false}, {400, 400, false}},
+        {{250, 110, false}, {30, 330, false}},  {{120, 0, false}, {180, 0, false}},
+        {{310, 290, false}, {290, 310, false}}, {{400, 130, false}, {0, 270, false}},
+    };
+    auto compute_paths = [&](float speed_factor, navitia::time_duration max_duration = 3600_s) {
+        StreetNetwork worker(b.geo_ref);
+        std::vector<Path> paths;
+        for (const auto& journey : journeys) {
+            auto origin = nt::EntryPoint();
+            auto destination = nt::EntryPoint();
+            origin.coordinates = journey.first;
+            destination.coordinates = journey.second;
+            origin.streetnetwork_params.max_duration = max_duration;
+            origin.streetnetwork_params.speed_factor = speed_factor;
+            destination.streetnetwork_params.max_duration = max_duration;
+            worker.init(origin, destination);
+            paths.push_back(worker.get_direct_path(origin, destination));
+        }
+        return paths;
+    };
+
+    const auto astar_paths = compute_paths(1);
+    const auto fast_astar_paths = compute_paths(2);
+    const auto bounded_astar_paths = compute_paths(1, 200_s);
+    b.geo_ref.build_contraction_hierarchies({nt::Mode_e::Walking});
+    BOOST_REQUIRE(b.geo_ref.contraction_hierarchies[nt::Mode_e::Walking]);
+    const auto ch_paths = compute_paths(1);
+    const auto fast_ch_paths = compute_paths(2);
+    // the searches of the hierarchy stop at the max duration, like the astar
+    const auto bounded_ch_paths = compute_paths(1, 200_s);
+    size_t nb_bounded_paths = 0;
+    for (size_t i = 0; i < journeys.size(); ++i) {
+        BOOST_CHECK_EQUAL(bounded_ch_paths[i].path_items.empty(), bounded_astar_paths[i].path_items.empty());
+        BOOST_CHECK_EQUAL(bounded_ch_paths[i].duration, bounded_astar_paths[i].duration);
+        nb_bounded_paths += bounded_ch_paths[i].path_items.empty() ? 0 : 1;
+    }
+    BOOST_CHECK(nb_bounded_paths > 0);
+    BOOST_CHECK(nb_bounded_paths < journeys.size());
+
+    for (size_t i = 0; i < journeys.size(); ++i) {
+        BOOST_REQUIRE(!astar_paths[i].path_items.empty());
+        BOOST_CHECK_EQUAL(ch_paths[i].duration, astar_paths[i].duration);
+        BOOST_CHECK_EQUAL(fast_ch_paths[i].duration, fast_astar_paths[i].duration);
+        // the paths may differ when several have the same duration, but not their extremities
+        const auto astar_coords = get_coords_from_path(astar_paths[i]);
+        const auto ch_coords = get_coords_from_path(ch_paths[i]);
+        BOOST_REQUIRE(!ch_coords.empty());
+        BOOST_CHECK_EQUAL(ch_coords.front(), astar_coords.front());
+        BOOST_CHECK_EQUAL(ch_coords.back(), astar_coords.back());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(contraction_hierarchy_built_for_the_same_edges) {
+    auto make_graph = [](navitia::time_duration last_duration) {
+        auto b = std::make_unique<GraphBuilder>();
+        (*b)("a", 0, 0)("b", 100, 0)("c", 200, 0)("d", 200, 100);
+        (*b)("a", "b", 100_s, true)("b", "c", 100_s, true)("c", "d", last_duration, true);
+        b->init();
+        return b;
+    };
+    auto b = make_graph(100_s);
+    b->geo_ref.build_contraction_hierarchies({nt::Mode_e::Walking});
+    const auto& ch = b->geo_ref.contraction_hierarchies[nt::Mode_e::Walking];
+    BOOST_REQUIRE(ch);
+    BOOST_CHECK(b->geo_ref.csr_graph.is_built_for(b->geo_ref.graph));
+    BOOST_CHECK(ch->is_built_for(b->geo_ref.csr_graph));
+
+    // the same street network loaded again, as after a reload
+    const auto same = make_graph(100_s);
+    BOOST_CHECK(!b->geo_ref.csr_graph.is_built_for(same->geo_ref.graph));
+    BOOST_CHECK(ch->is_built_for(same->geo_ref.csr_graph));
+    same->geo_ref.warmup(b->geo_ref);
+    BOOST_CHECK(same->geo_ref.contraction_hierarchies[nt::Mode_e::Walking] == ch);
+    // the compact graph of a clone of the data is copied, bound to the graph of the clone
+    same->geo_ref.build_proximity_list(&b->geo_ref);
+    BOOST_CHECK(same->geo_ref.csr_graph.is_built_for(same->geo_ref.graph));
+    BOOST_CHECK(ch->is_built_for(same->geo_ref.csr_graph));
+    BOOST_CHECK_EQUAL(same->geo_ref.edge_rtree.size(), b->geo_ref.edge_rtree.size());
+
+    // the same vertices, but an edge has changed
+    const auto changed = make_graph(150_s);
+    BOOST_CHECK_EQUAL(boost::num_vertices(changed->geo_ref.graph), boost::num_vertices(b->geo_ref.graph));
+    BOOST_CHECK(!ch->is_built_for(changed->geo_ref.csr_graph));
+    changed->geo_ref.warmup(b->geo_ref);
+    BOOST_CHECK(!changed->geo_ref.contraction_hierarchies[nt::Mode_e::Walking]);
+}
+
+BOOST_AUTO_TEST_CASE(routing_matrix_with_contraction_hierarchy) {
+    GraphBuilder b;
+    auto name = [](int x, int y) { return std::to_string(x) + ":" + std::to_string(y); };
+    for (int x = 0; x < 5; ++x) {
+        for (int y = 0; y < 5; ++y) {
+            b(name(x, y), x * 100, y * 100);
+        }
+    }
+    for (int x = 0; x < 5; ++x) {
+        for (int y = 0; y < 5; ++y) {
+            if (x < 4) {
+                b(name(x, y), name(x + 1, y), navitia::seconds(100 + 40 * ((x * 7 + y * 3) % 5)), true);
+            }
+            if (y < 4) {
+                b(name(x, y), name(x, y + 1), navitia::seconds(100 + 40 * ((x * 3 + y * 5) % 4)), true);
+            }
+        }
+    }
+    b.init();
+    b.geo_ref.build_contraction_hierarchies({nt::Mode_e::Walking});
+    const auto& ch = b.geo_ref.contraction_hierarchies[nt::Mode_e::Walking];
+    BOOST_REQUIRE(ch);
+
+    const std::vector<nt::GeographicalCoord> origins = {
+        {10, 20, false}, {0, 0, false}, {250, 110, false}, {310, 290, false}, {400, 130, false}};
+    const std::vector<nt::GeographicalCoord> destinations = {
+        {390, 380, false}, {400, 400, false}, {30, 330, false}, {180, 0, false}, {290, 310, false}, {0, 270, false}};
+
+    ManyToManyPathFinder matrix_path_finder(b.geo_ref);
+    DijkstraPathFinder dijkstra_path_finder(b.geo_ref);
+    for (const auto radius : {3600_s, 600_s}) {
+        const auto matrix =
+            matrix_path_finder.compute_matrix(*ch, origins, destinations, nt::Mode_e::Walking, 1, radius);
+        BOOST_REQUIRE_EQUAL(matrix.size(), origins.size());
+        for (size_t i = 0; i < origins.size(); ++i) {
+            BOOST_REQUIRE_EQUAL(matrix[i].size(), destinations.size());
+            dijkstra_path_finder.init(origins[i], nt::Mode_e::Walking, 1);
+            const auto durations = dijkstra_path_finder.get_duration_with_dijkstra(radius, destinations);
+            for (size_t j = 0; j < destinations.size(); ++j) {
+                const auto& expected = durations.at(destinations[j].uri());
+                if (expected.routing_status == RoutingStatus_e::reached) {
+                    BOOST_CHECK(matrix[i][j].routing_status == RoutingStatus_e::reached);
+                    BOOST_CHECK_EQUAL(matrix[i][j].time_duration, expected.time_duration);
+                } else if (matrix[i][j].routing_status == RoutingStatus_e::reached) {
+                    // the dijkstra gives up on a destination when the source of its edge is out of the radius
+                    BOOST_CHECK(expected.routing_status == RoutingStatus_e::unreached);
+                    BOOST_CHECK(matrix[i][j].time_duration <= radius);
+                }
+            }
+        }
+    }
+}
+
 // not used for the moment so it is not possible anymore (but it would not be difficult to do again)
 // Est-ce que le calcul de plusieurs nœuds vers plusieurs nœuds fonctionne
 // BOOST_AUTO_TEST_CASE(compute_route_n_n){
@@ -875,6 +1067,115 @@ BOOST_AUTO_TEST_CASE(compute_nearest) {
     BOOST_CHECK_EQUAL_COLLECTIONS(res.cbegin(), res.cend(), tested_map.cbegin(), tested_map.cend());
 }
 
+BOOST_AUTO_TEST_CASE(compute_nearest_with_stop_point_walking_table) {
+    using namespace navitia::type;
+
+    GraphBuilder b;
+
+    /*       1                    2
+     *       +                    +
+     *    o------o------o------o------o
+     *    a      b      c      d      e
+     */
+
+    b("a", 0, 0)("b", 100, 0)("c", 200, 0)("d", 300, 0)("e", 400, 0);
+    b("a", "b", 100_s)("b", "a", 100_s)("b", "c", 100_s)("c", "b", 100_s)("c", "d", 100_s)("d", "c", 100_s)(
+        "d", "e", 100_s)("e", "d", 100_s);
+
+    GeographicalCoord c1(50, 10, false);
+    GeographicalCoord c2(350, 20, false);
+    navitia::proximitylist::ProximityList<idx_t> pl;
+    pl.add(c1, 0);
+    pl.add(c2, 1);
+    pl.build();
+    b.init();
+
+    auto* sp1 = new StopPoint();
+    sp1->idx = 0;
+    sp1->coord = c1;
+    auto* sp2 = new StopPoint();
+    sp2->idx = 1;
+    sp2->coord = c2;
+    std::vector<StopPoint*> stop_points{sp1, sp2};
+    b.geo_ref.project_stop_points_and_access_points(stop_points);
+
+    StreetNetwork w(b.geo_ref);
+    EntryPoint starting_point;
+    starting_point.coordinates = c1;
+    starting_point.streetnetwork_params.mode = Mode_e::Walking;
+    starting_point.streetnetwork_params.speed_factor = 1;
+    w.init(starting_point);
+    const auto expected = w.find_nearest_stop_points(500_s, pl, false);
+    const auto expected_path = w.get_path(sp2->idx);
+    BOOST_REQUIRE_EQUAL(expected.size(), 2);
+
+    // from an address between the vertices c and d
+    EntryPoint address;
+    address.coordinates = GeographicalCoord(260, 30, false);
+    address.streetnetwork_params.mode = Mode_e::Walking;
+    address.streetnetwork_params.speed_factor = 1;
+    w.init(address);
+    const auto expected_from_address = w.find_nearest_stop_points(500_s, pl, false);
+    BOOST_REQUIRE_EQUAL(expected_from_address.size(), 2);
+
+    b.geo_ref.build_stop_point_walking_table(600_s);
+    auto table = b.geo_ref.stop_point_walking_table;
+    BOOST_CHECK(table->is_built_for(b.geo_ref));
+    // each stop point is reached from the 5 vertices
+    BOOST_CHECK_EQUAL(table->num_entries(), 10);
+    BOOST_CHECK_EQUAL(table->nb_computed_rows(), 2);
+
+    // the start is the stop point: the durations are read in the table, the path is searched afterwards
+    w.init(starting_point);
+    auto res = w.find_nearest_stop_points(500_s, pl, false);
+    BOOST_CHECK(!w.departure_launched());
+    BOOST_CHECK_EQUAL_COLLECTIONS(res.cbegin(), res.cend(), expected.cbegin(), expected.cend());
+    const auto path = w.get_path(sp2->idx);
+    BOOST_CHECK_EQUAL(path.duration, expected_path.duration);
+    BOOST_CHECK_EQUAL(path.path_items.size(), expected_path.path_items.size());
+
+    // any start projected on the graph is answered by the table
+    w.init(address);
+    res = w.find_nearest_stop_points(500_s, pl, false);
+    BOOST_CHECK(!w.departure_launched());
+    BOOST_CHECK_EQUAL_COLLECTIONS(res.cbegin(), res.cend(), expected_from_address.cbegin(),
+                                  expected_from_address.cend());
+
+    // only the stop points reached within the duration are given
+    w.init(starting_point);
+    res = w.find_nearest_stop_points(100_s, pl, false);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res.begin()->first, navitia::routing::SpIdx(*sp1));
+
+    // another speed is not in the table
+    starting_point.streetnetwork_params.speed_factor = 2;
+    w.init(starting_point);
+    res = w.find_nearest_stop_points(500_s, pl, false);
+    BOOST_CHECK(w.departure_launched());
+    BOOST_CHECK_EQUAL(res.size(), 2);
+
+    // the table is kept when the stop points are projected again at the same place, not when one has moved
+    b.geo_ref.project_stop_points_and_access_points(stop_points);
+    BOOST_CHECK(table->is_built_for(b.geo_ref));
+    sp2->coord = GeographicalCoord(250, 20, false);
+    b.geo_ref.project_stop_points_and_access_points(stop_points);
+    BOOST_CHECK(!table->is_built_for(b.geo_ref));
+
+    // only the row of the moved stop point is computed again
+    b.geo_ref.stop_point_walking_table.reset();
+    b.geo_ref.build_stop_point_walking_table(600_s, table.get());
+    BOOST_CHECK(b.geo_ref.stop_point_walking_table->is_built_for(b.geo_ref));
+    BOOST_CHECK_EQUAL(b.geo_ref.stop_point_walking_table->nb_computed_rows(), 1);
+    w.init(address);
+    res = w.find_nearest_stop_points(500_s, pl, false);
+    BOOST_CHECK(!w.departure_launched());
+    b.geo_ref.stop_point_walking_table.reset();
+    w.init(address);
+    const auto moved_expected = w.find_nearest_stop_points(500_s, pl, false);
+    BOOST_CHECK(w.departure_launched());
+    BOOST_CHECK_EQUAL_COLLECTIONS(res.cbegin(), res.cend(), moved_expected.cbegin(), moved_expected.cend());
+}
+
 // Récupérer les cordonnées d'un numéro impair :
 BOOST_AUTO_TEST_CASE(numero_impair) {
     navitia::georef::Way way;
@@ -1324,6 +1625,53 @@ BOOST_AUTO_TEST_CASE(SpeedDistanceCombiner_test2) {
     BOOST_CHECK_EQUAL(comb(dur, dur2), 130_s);
 }
 
+BOOST_AUTO_TEST_CASE(radix_heap_pops_in_order) {
+    RadixHeap<int> heap;
+    for (int round = 0; round < 2; ++round) {
+        heap.clear();
+        heap.push(10, 0);
+        heap.push(3, 1);
+        heap.push(1000000, 2);
+        BOOST_CHECK_EQUAL(heap.pop().first, 3u);
+        // the pushed keys only have to be greater than the last popped one
+        heap.push(3, 3);
+        heap.push(7, 4);
+        BOOST_CHECK_EQUAL(heap.pop().second, 3);
+        BOOST_CHECK_EQUAL(heap.pop().first, 7u);
+        BOOST_CHECK_EQUAL(heap.pop().first, 10u);
+        heap.push(10, 5);
+        BOOST_CHECK_EQUAL(heap.pop().second, 5);
+        BOOST_CHECK_EQUAL(heap.pop().first, 1000000u);
+        BOOST_CHECK(heap.empty());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sparse_vertex_map_only_allocates_the_written_pages) {
+    const size_t page_size = SparseVertexMap<int>::page_size;
+    SparseVertexMap<int> values;
+    values.reset(10 * page_size, -1);
+    const auto& const_values = values;
+    BOOST_CHECK_EQUAL(const_values[3 * page_size], -1);
+    BOOST_CHECK_EQUAL(values.nb_used_pages(), 0u);
+
+    values[3 * page_size] = 42;
+    values[3 * page_size + 1] = 43;
+    values[7 * page_size] = 44;
+    BOOST_CHECK_EQUAL(values.nb_used_pages(), 2u);
+    BOOST_CHECK_EQUAL(const_values[3 * page_size], 42);
+    BOOST_CHECK_EQUAL(const_values[3 * page_size + 2], -1);
+    BOOST_CHECK_EQUAL(values.at(7 * page_size), 44);
+    BOOST_CHECK_THROW(values.at(10 * page_size), std::out_of_range);
+
+    // the pages are reused with the new default value
+    values.reset(10 * page_size, 0);
+    BOOST_CHECK_EQUAL(values.nb_used_pages(), 0u);
+    BOOST_CHECK_EQUAL(const_values[3 * page_size], 0);
+    values[5 * page_size] = 1;
+    BOOST_CHECK_EQUAL(const_values[5 * page_size + 1], 0);
+    BOOST_CHECK_EQUAL(values.nb_used_pages(), 1u);
+}
+
 // test allowed mode creation
 BOOST_AUTO_TEST_CASE(transportation_mode_creation) {
     const auto allowed_transportation_mode = create_from_allowedlist({{{{nt::Mode_e::Walking},
@@ -1524,6 +1872,136 @@ BOOST_AUTO_TEST_CASE(find_nearest_on_same_edge) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(parallel_projection_reusing_previous_projections) {
+    using namespace navitia::type;
+
+    // a 10x10 grid of streets, 100m wide
+    GraphBuilder b;
+    for (int x = 0; x < 10; ++x) {
+        for (int y = 0; y < 10; ++y) {
+            const auto name = std::to_string(x) + "_" + std::to_string(y);
+            b(name, x * 100, y * 100);
+            if (x > 0) {
+                const auto west = std::to_string(x - 1) + "_" + std::to_string(y);
+                b(name, west)(west, name);
+            }
+            if (y > 0) {
+                const auto south = std::to_string(x) + "_" + std::to_string(y - 1);
+                b(name, south)(south, name);
+            }
+        }
+    }
+    b.init();
+
+    // enough stop points for several chunks
+    std::vector<StopPoint*> stop_points;
+    for (idx_t i = 0; i < 1000; ++i) {
+        auto* sp = new StopPoint();
+        sp->idx = i;
+        sp->coord.set_xy((i * 37) % 950 + 3, (i * 53) % 950 + 7);
+        stop_points.push_back(sp);
+    }
+    b.geo_ref.project_stop_points_and_access_points(stop_points);
+
+    auto check_projections = [&]() {
+        BOOST_REQUIRE_EQUAL(b.geo_ref.projected_stop_points.size(), stop_points.size());
+        for (const auto* sp : stop_points) {
+            const auto expected = b.geo_ref.project_coord(sp->coord).first;
+            // the edges are only in the walking graph
+            const auto& projection = b.geo_ref.projected_stop_points[sp->idx][Mode_e::Walking];
+            BOOST_CHECK(projection.found);
+            BOOST_CHECK_EQUAL(projection[source_e], expected[Mode_e::Walking][source_e]);
+            BOOST_CHECK_EQUAL(projection[target_e], expected[Mode_e::Walking][target_e]);
+            BOOST_CHECK_EQUAL(projection.projected, expected[Mode_e::Walking].projected);
+            BOOST_CHECK_EQUAL(projection.real_coord, sp->coord);
+            BOOST_CHECK(!b.geo_ref.projected_stop_points[sp->idx][Mode_e::Bike].found);
+        }
+    };
+    check_projections();
+
+    // only the moved stop point is projected again
+    stop_points[42]->coord.set_xy(512, 488);
+    b.geo_ref.project_stop_points_and_access_points(stop_points, &b.geo_ref);
+    check_projections();
+    BOOST_CHECK_EQUAL(b.geo_ref.projected_coords.count(stop_points[42]->coord), 1);
+}
+
+BOOST_AUTO_TEST_CASE(batch_projection) {
+    using namespace navitia::type;
+
+    // a 10x10 grid of streets, 100m wide
+    GraphBuilder b;
+    for (int x = 0; x < 10; ++x) {
+        for (int y = 0; y < 10; ++y) {
+            const auto name = std::to_string(x) + "_" + std::to_string(y);
+            b(name, x * 100, y * 100);
+            if (x > 0) {
+                const auto west = std::to_string(x - 1) + "_" + std::to_string(y);
+                b(name, west)(west, name);
+            }
+        }
+    }
+    b.init();
+
+    std::vector<GeographicalCoord> coords;
+    for (int i = 0; i < 700; ++i) {
+        GeographicalCoord coord;
+        coord.set_xy((i * 37) % 950 + 3, (i * 53) % 950 + 7);
+        coords.push_back(coord);
+    }
+    std::vector<bool> to_project(coords.size(), true);
+    to_project[3] = false;
+
+    const auto projections = b.geo_ref.project_coords(coords, to_project);
+    BOOST_REQUIRE_EQUAL(projections.size(), coords.size());
+    for (size_t i = 0; i < coords.size(); ++i) {
+        const auto& projection = projections[i].first[Mode_e::Walking];
+        if (!to_project[i]) {
+            BOOST_CHECK(!projections[i].second);
+            BOOST_CHECK(!projection.found);
+            continue;
+        }
+        const auto expected = b.geo_ref.project_coord(coords[i]);
+        BOOST_CHECK_EQUAL(projections[i].second, expected.second);
+        BOOST_CHECK_EQUAL(projection.found, expected.first[Mode_e::Walking].found);
+        BOOST_CHECK_EQUAL(projection[source_e], expected.first[Mode_e::Walking][source_e]);
+        BOOST_CHECK_EQUAL(projection[target_e], expected.first[Mode_e::Walking][target_e]);
+        BOOST_CHECK_EQUAL(projection.projected, expected.first[Mode_e::Walking].projected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hilbert_curve) {
+    BOOST_CHECK_EQUAL(hilbert_index(0, 0, 1), 0);
+    BOOST_CHECK_EQUAL(hilbert_index(0, 1, 1), 1);
+    BOOST_CHECK_EQUAL(hilbert_index(1, 1, 1), 2);
+    BOOST_CHECK_EQUAL(hilbert_index(1, 0, 1), 3);
+
+    // the curve goes through each cell once, from a cell to a neighbouring one
+    std::vector<std::pair<uint32_t, uint32_t>> cells(16 * 16, {16, 16});
+    for (uint32_t x = 0; x < 16; ++x) {
+        for (uint32_t y = 0; y < 16; ++y) {
+            const auto index = hilbert_index(x, y, 4);
+            BOOST_REQUIRE_LT(index, cells.size());
+            BOOST_CHECK_EQUAL(cells[index].first, 16);
+            cells[index] = {x, y};
+        }
+    }
+    for (size_t i = 1; i < cells.size(); ++i) {
+        const auto dx = std::abs(int(cells[i].first) - int(cells[i - 1].first));
+        const auto dy = std::abs(int(cells[i].second) - int(cells[i - 1].second));
+        BOOST_CHECK_EQUAL(dx + dy, 1);
+    }
+
+    // the close coordinates are kept together
+    const std::vector<navitia::type::GeographicalCoord> coords = {
+        {2.35, 48.85}, {2.29, 48.86}, {2.351, 48.851}, {2.291, 48.859}, {2.352, 48.849}, {2.29, 48.861}};
+    const auto order = hilbert_order(coords);
+    BOOST_REQUIRE_EQUAL(order.size(), coords.size());
+    std::set<size_t> first_half(order.begin(), order.begin() + 3);
+    BOOST_CHECK(first_half == std::set<size_t>({0, 2, 4}) || first_half == std::set<size_t>({1, 3, 5}));
+    BOOST_CHECK(hilbert_order({}).empty());
+}
+
 BOOST_AUTO_TEST_CASE(projection_data_not_found) {
     ProjectionData proj;
 
@@ -1531,19 +2009,80 @@ BOOST_AUTO_TEST_CASE(projection_data_not_found) {
     BOOST_CHECK_THROW(proj[target_e], navitia::proximitylist::NotFound);
 }
 
-BOOST_AUTO_TEST_CASE(build_admin_tree_from_admin_with_no_boundary) {
-    std::vector<Admin*> admins;
+BOOST_AUTO_TEST_CASE(admin_index_from_admin_with_no_boundary) {
     Admin no_boundary;
-    admins.push_back(&no_boundary);
-
-    auto admin_tree = build_admins_tree(admins);
-
-    AdminRtree::Iterator it;
-    admin_tree.GetFirst(it);
+    std::vector<Admin*> admins = {&no_boundary};
+
+    AdminIndex admin_index;
+    admin_index.build(admins);
+    BOOST_CHECK_EQUAL(admin_index.size(), 0);
+    admin_index.insert(&no_boundary);
+    BOOST_CHECK_EQUAL(admin_index.size(), 0);
+
+    BOOST_CHECK(admin_index.find({0, 0}).empty());
+    const auto results = admin_index.find(std::vector<navitia::type::GeographicalCoord>{{0, 0}, {1, 1}});
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    BOOST_CHECK(results[0].empty());
+    BOOST_CHECK(results[1].empty());
+}
 
-    double x, y;
-    it.GetBounds(&x, &y);
+BOOST_AUTO_TEST_CASE(admin_index_find) {
+    // a square with a hole, a square overlapping it, and a polygon of 400 vertices for a grid of several cells
+    Admin with_hole, overlapping, circle, no_boundary;
+    boost::geometry::read_wkt("MULTIPOLYGON(((0 0,0 10,10 10,10 0,0 0),(4 4,6 4,6 6,4 6,4 4)))", with_hole.boundary);
+    boost::geometry::read_wkt("MULTIPOLYGON(((8 8,8 12,12 12,12 8,8 8)))", overlapping.boundary);
+    polygon_type polygon;
+    for (int i = 0; i < 400; ++i) {
+        const double angle = -2 * M_PI * i / 400;
+        const double radius = i % 2 ? 4 : 5;
+        polygon.outer().emplace_back(20 + radius * std::cos(angle), 5 + radius * std::sin(angle));
+    }
+    polygon.outer().push_back(polygon.outer().front());
+    circle.boundary.push_back(polygon);
+    std::vector<Admin*> admins = {&with_hole, &no_boundary, &overlapping, &circle};
+
+    AdminIndex admin_index;
+    admin_index.build(admins);
+    BOOST_CHECK_EQUAL(admin_index.size(), 3);
+
+    using coords = std::vector<navitia::type::GeographicalCoord>;
+    BOOST_CHECK(admin_index.find({1, 1}) == std::vector<Admin*>({&with_hole}));
+    BOOST_CHECK(admin_index.find({5, 5}).empty());
+    BOOST_CHECK(admin_index.find({9, 9}) == std::vector<Admin*>({&with_hole, &overlapping}));
+    BOOST_CHECK(admin_index.find({11, 11}) == std::vector<Admin*>({&overlapping}));
+    BOOST_CHECK(admin_index.find({20, 5}) == std::vector<Admin*>({&circle}));
+    BOOST_CHECK(admin_index.find({30, 30}).empty());
+    // on the boundary
+    BOOST_CHECK(admin_index.find({0, 5}).empty());
+    BOOST_CHECK(admin_index.find({4, 4}).empty());
+
+    // the same admins as within, one coordinate at a time or in bulk
+    coords points;
+    for (int lon = -10; lon <= 260; ++lon) {
+        for (int lat = -10; lat <= 130; lat += 3) {
+            points.emplace_back(lon / 10., lat / 10.);
+        }
+    }
+    const auto results = admin_index.find(points);
+    BOOST_REQUIRE_EQUAL(results.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        std::vector<Admin*> expected;
+        for (auto* admin : admins) {
+            if (boost::geometry::within(points[i], admin->boundary)) {
+                expected.push_back(admin);
+            }
+        }
+        BOOST_CHECK(admin_index.find(points[i]) == expected);
+        BOOST_CHECK(results[i] == expected);
+    }
 
-    BOOST_CHECK_EQUAL(x, 0.);
-    BOOST_CHECK_EQUAL(y, 0.);
+    // the admins inserted one by one give the same results
+    AdminIndex inserted;
+    for (auto* admin : admins) {
+        inserted.insert(admin);
+    }
+    BOOST_CHECK_EQUAL(inserted.size(), 3);
+    for (size_t i = 0; i < points.size(); ++i) {
+        BOOST_CHECK(inserted.find(points[i]) == results[i]);
+    }
 }
@@ -54,8 +54,12 @@ struct computation_results {
     std::vector<navitia::time_duration> durations_matrix;  // duration matrix
     std::vector<vertex_t> predecessor;
 
-    computation_results(navitia::time_duration d, const PathFinder& worker)
-        : duration(std::move(d)), durations_matrix(worker.distances), predecessor(worker.predecessors) {}
+    computation_results(navitia::time_duration d, const PathFinder& worker) : duration(std::move(d)) {
+        for (vertex_t v = 0; v < worker.distances.size(); ++v) {
+            durations_matrix.push_back(worker.distances[v]);
+            predecessor.push_back(worker.predecessors[v]);
+        }
+    }
 
     bool operator==(const computation_results& other) {
         BOOST_CHECK_EQUAL(other.duration, duration);
@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 
 #include "georef.h"
+#include "sparse_vertex_map.h"
 #include "type/time_duration.h"
 
 #include <boost/graph/dijkstra_shortest_paths.hpp>
@@ -45,12 +46,13 @@ struct DestinationFound {};
 struct DestinationNotFound {};
 
 // Visitor who stops (throw a DestinationFound exception) when a certain distance is reached
-template <class Base>
+// Durations is the container of the distances by vertex, a std::vector or a SparseVertexMap
+template <class Base, class Durations>
 struct distance_visitor : virtual public Base {
     navitia::time_duration max_duration;
-    const std::vector<navitia::time_duration>& durations;
+    const Durations& durations;
 
-    distance_visitor(time_duration max_dur, const std::vector<time_duration>& dur)
+    distance_visitor(time_duration max_dur, const Durations& dur)
         : max_duration(std::move(max_dur)), durations(dur) {}
     distance_visitor(const distance_visitor& other) = default;
 
@@ -101,12 +103,13 @@ struct target_unique_visitor : public Base {
 };
 
 // Visitor who stops when a target has been visited or a certain distance is reached
-template <class Base>
-struct distance_or_target_visitor : virtual public distance_visitor<Base>, virtual public target_all_visitor<Base> {
+template <class Base, class Durations>
+struct distance_or_target_visitor : virtual public distance_visitor<Base, Durations>,
+                                    virtual public target_all_visitor<Base> {
     distance_or_target_visitor(const time_duration& max_dur,
-                               const std::vector<time_duration>& dur,
+                               const Durations& dur,
                                const std::vector<vertex_t>& destinations)
-        : distance_visitor<Base>(max_dur, dur), target_all_visitor<Base>(destinations) {}
+        : distance_visitor<Base, Durations>(max_dur, dur), target_all_visitor<Base>(destinations) {}
     distance_or_target_visitor(const distance_or_target_visitor& other) = default;
     template <typename graph_type>
     void finish_vertex(vertex_t u, const graph_type& g) {
@@ -115,14 +118,16 @@ struct distance_or_target_visitor : virtual public distance_visitor<Base>, virtu
 
     template <typename G>
     void examine_vertex(typename boost::graph_traits<G>::vertex_descriptor u, const G& g) {
-        distance_visitor<Base>::examine_vertex(u, g);
+        distance_visitor<Base, Durations>::examine_vertex(u, g);
     }
 };
 
-using dijkstra_distance_visitor = distance_visitor<boost::dijkstra_visitor<>>;
+// the visitors of the path finders, on their sparse distances
+using dijkstra_distance_visitor = distance_visitor<boost::dijkstra_visitor<>, SparseVertexMap<time_duration>>;
 using dijkstra_target_all_visitor = target_all_visitor<boost::dijkstra_visitor<>>;
 
-using astar_distance_or_target_visitor = distance_or_target_visitor<boost::astar_visitor<>>;
+using astar_distance_or_target_visitor =
+    distance_or_target_visitor<boost::astar_visitor<>, SparseVertexMap<time_duration>>;
 
 }  // namespace georef
 }  // namespace navitia
@@ -31,6 +31,7 @@ www.navitia.io
 #include "configuration.h"
 
 #include "utils/exception.h"
+#include "type/static_data.h"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -73,11 +74,23 @@ po::options_description get_options_description(const boost::optional<std::strin
                                   "timeout in ms before retrying to load realtime data")
         ("GENERAL.slow_request_duration", po::value<int>()->default_value(1000),
                                   "request running a least this number of milliseconds are logged")
+        ("GENERAL.slow_request_capture_file", po::value<std::string>(),
+                                  "if set, the slow requests are written in this file to be replayed later")
+        ("GENERAL.slow_request_capture_max_size", po::value<int>()->default_value(100),
+                                  "size in MB of the slow requests capture file before its rotation")
+        ("GENERAL.slow_request_capture_nb_files", po::value<int>()->default_value(5),
+                                  "number of slow requests capture files kept by the rotation")
 
         ("GENERAL.display_contributors", display_contributors ?
              po::value<bool>()->default_value(*display_contributors) : po::value<bool>()->default_value(false),
          "display all contributors in feed publishers")
         ("GENERAL.raptor_cache_size", po::value<int>()->default_value(10), "maximum number of stored raptor caches")
+        ("GENERAL.isochrone_cache_size", po::value<int>()->default_value(10),
+         "maximum number of graphical isochrones kept by each worker for the identical requests, 0 to disable")
+        ("GENERAL.contraction_hierarchy_modes", po::value<std::vector<std::string>>(),
+         "street network modes (walking, bike, car...) for which a contraction hierarchy is built at load to speed up the direct paths and the routing matrices")
+        ("GENERAL.stop_point_walking_table_radius", po::value<int>()->default_value(0),
+         "duration in seconds of the walking durations from the street vertices to the stop points precomputed at load for the fallbacks, 0 to disable")
         ("GENERAL.log_level", po::value<std::string>(), "log level of kraken")
         ("GENERAL.log_format", po::value<std::string>()->default_value("[%D{%y-%m-%d %H:%M:%S,%q}] [%p] [%x] - %m %b:%L  %n"), "log format")
 
@@ -243,6 +256,32 @@ std::vector<std::string> Configuration::rt_topics() const {
     return this->vm["BROKER.rt_topics"].as<std::vector<std::string>>();
 }
 
+std::vector<type::Mode_e> Configuration::contraction_hierarchy_modes() const {
+    std::vector<type::Mode_e> modes;
+    if (!this->vm.count("GENERAL.contraction_hierarchy_modes")) {
+        return modes;
+    }
+    for (const auto& mode : this->vm["GENERAL.contraction_hierarchy_modes"].as<std::vector<std::string>>()) {
+        try {
+            modes.push_back(type::static_data::modeByCaption(mode));
+        } catch (const navitia::recoverable_exception&) {
+            throw std::invalid_argument("contraction_hierarchy_modes: unknown mode " + mode);
+        }
+    }
+    return modes;
+}
+
+navitia::time_duration Configuration::stop_point_walking_table_radius() const {
+    if (!this->vm.count("GENERAL.stop_point_walking_table_radius")) {
+        return navitia::seconds(0);
+    }
+    const int radius = this->vm["GENERAL.stop_point_walking_table_radius"].as<int>();
+    if (radius < 0) {
+        throw std::invalid_argument("stop_point_walking_table_radius must be positive");
+    }
+    return navitia::seconds(radius);
+}
+
 int Configuration::kirin_retry_timeout() const {
     return vm["GENERAL.kirin_retry_timeout"].as<int>();
 }
@@ -258,6 +297,30 @@ int Configuration::slow_request_duration() const {
     return vm["GENERAL.slow_request_duration"].as<int>();
 }
 
+boost::optional<std::string> Configuration::slow_request_capture_file() const {
+    boost::optional<std::string> result;
+    if (this->vm.count("GENERAL.slow_request_capture_file") > 0) {
+        result = this->vm["GENERAL.slow_request_capture_file"].as<std::string>();
+    }
+    return result;
+}
+
+size_t Configuration::slow_request_capture_max_size() const {
+    int max_size = vm["GENERAL.slow_request_capture_max_size"].as<int>();
+    if (max_size < 1) {
+        throw std::invalid_argument("slow_request_capture_max_size must be strictly positive");
+    }
+    return size_t(max_size) * 1024 * 1024;
+}
+
+size_t Configuration::slow_request_capture_nb_files() const {
+    int nb_files = vm["GENERAL.slow_request_capture_nb_files"].as<int>();
+    if (nb_files < 1) {
+        throw std::invalid_argument("slow_request_capture_nb_files must be strictly positive");
+    }
+    return size_t(nb_files);
+}
+
 bool Configuration::enable_request_deadline() const {
     return vm["GENERAL.enable_request_deadline"].as<bool>();
 }
@@ -273,6 +336,17 @@ size_t Configuration::raptor_cache_size() const {
     return size_t(raptor_cache_size);
 }
 
+size_t Configuration::isochrone_cache_size() const {
+    if (!vm.count("GENERAL.isochrone_cache_size")) {
+        return 10;
+    }
+    int isochrone_cache_size = vm["GENERAL.isochrone_cache_size"].as<int>();
+    if (isochrone_cache_size < 0) {
+        throw std::invalid_argument("isochrone_cache_size must be positive");
+    }
+    return size_t(isochrone_cache_size);
+}
+
 boost::optional<std::string> Configuration::log_level() const {
     boost::optional<std::string> result;
     if (this->vm.count("GENERAL.log_level") > 0) {
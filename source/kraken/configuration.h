@@ -29,6 +29,9 @@ www.navitia.io
 */
 
 #pragma once
+#include "type/type_interfaces.h"
+#include "type/time_duration.h"
+
 #include <boost/program_options.hpp>
 #include <boost/optional.hpp>
 
@@ -68,8 +71,14 @@ public:
     int kirin_retry_timeout() const;
     bool display_contributors() const;
     size_t raptor_cache_size() const;
+    size_t isochrone_cache_size() const;
+    std::vector<type::Mode_e> contraction_hierarchy_modes() const;
+    navitia::time_duration stop_point_walking_table_radius() const;
     int core_file_size_limit() const;
     int slow_request_duration() const;
+    boost::optional<std::string> slow_request_capture_file() const;
+    size_t slow_request_capture_max_size() const;
+    size_t slow_request_capture_nb_files() const;
     boost::optional<std::string> log_level() const;
     boost::optional<std::string> log_format() const;
     boost::optional<std::string> metrics_binding() const;
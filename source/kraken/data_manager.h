@@ -33,6 +33,7 @@ www.navitia.io
 #include "utils/logger.h"
 #include "utils/timer.h"
 #include "type/data_exceptions.h"
+#include "type/type_interfaces.h"
 #ifndef NO_FORCE_MEMORY_RELEASE
 // by default we force the release of the memory after the reload of the data
 #include "gperftools/malloc_extension.h"
@@ -108,7 +109,9 @@ public:
               const boost::optional<std::string>& chaos_database = boost::none,
               const std::vector<std::string>& contributors = {},
               const size_t raptor_cache_size = 10,
-              const size_t chaos_batch_size = 1000000) {
+              const size_t chaos_batch_size = 1000000,
+              const std::vector<navitia::type::Mode_e>& contraction_hierarchy_modes = {},
+              const navitia::time_duration& stop_point_walking_table_radius = navitia::seconds(0)) {
         // Add logger
         log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
 
@@ -151,6 +154,10 @@ public:
         data->build_raptor(raptor_cache_size);
         // Build proximity list NN index
         data->build_proximity_list();
+        // Build the optional contraction hierarchies for the direct paths
+        data->build_contraction_hierarchies(contraction_hierarchy_modes);
+        // Build the optional walking durations between the stop points for the fallbacks
+        data->build_stop_point_walking_table(stop_point_walking_table_radius);
         data->loading = false;
 
         // Set data
@@ -142,11 +142,17 @@ int main(int argn, char** argv) {
     int nb_threads = conf.nb_threads();
     const std::string hostname = navitia::get_hostname();
 
+    std::unique_ptr<navitia::RequestCaptureWriter> request_capture;
+    if (auto capture_file = conf.slow_request_capture_file()) {
+        request_capture = std::make_unique<navitia::RequestCaptureWriter>(
+            *capture_file, conf.slow_request_capture_max_size(), conf.slow_request_capture_nb_files());
+    }
+
     // Launch pool of worker threads
     LOG4CPLUS_INFO(logger, "starting workers threads");
     for (int thread_nbr = 0; thread_nbr < nb_threads; ++thread_nbr) {
-        threads.create_thread([&context, &data_manager, conf, &metrics, &hostname, thread_nbr] {
-            return doWork(context, data_manager, conf, metrics, hostname, thread_nbr);
+        threads.create_thread([&context, &data_manager, conf, &metrics, &hostname, thread_nbr, &request_capture] {
+            return doWork(context, data_manager, conf, metrics, hostname, thread_nbr, request_capture.get());
         });
     }
 
@@ -37,6 +37,7 @@ www.navitia.io
 #include "kraken/configuration.h"
 #include "type/meta_data.h"
 #include "metrics.h"
+#include "request_capture.h"
 #include "utils/deadline.h"
 #include "type/datetime.h"
 
@@ -79,7 +80,8 @@ inline void doWork(zmq::context_t& context,
                    navitia::kraken::Configuration conf,
                    const navitia::Metrics& metrics,
                    const std::string& hostname,
-                   int worker_id) {
+                   int worker_id,
+                   navitia::RequestCaptureWriter* request_capture = nullptr) {
     auto logger = log4cplus::Logger::getInstance("worker");
 
     zmq::socket_t socket(context, ZMQ_REQ);
@@ -198,6 +200,11 @@ inline void doWork(zmq::context_t& context,
         auto end = pt::microsec_clock::universal_time();
         auto duration = end - start;
         metrics.observe_api(api, duration.total_milliseconds() / 1000.0);
+        const auto& phase_profile = w.get_phase_profile();
+        // the other apis running raptor, like the isochrones or the heat maps, are not journeys
+        if (api == pbnavitia::PLANNER || api == pbnavitia::pt_planner || api == pbnavitia::NMPLANNER) {
+            metrics.observe_journeys_phases(phase_profile);
+        }
         auto cache_miss = w.get_raptor_next_st_cache_miss();
         if (cache_miss) {
             metrics.set_raptor_cache_miss(*cache_miss);
@@ -205,6 +212,20 @@ inline void doWork(zmq::context_t& context,
         if (duration >= slow_request_duration) {
             LOG4CPLUS_WARN(logger, "slow request! duration: " << duration.total_milliseconds()
                                                               << "ms request: " << pb_req.DebugString());
+            if (!phase_profile.empty()) {
+                LOG4CPLUS_WARN(logger, "slow request phases: " << phase_profile.summary());
+            }
+            if (request_capture != nullptr) {
+                navitia::CapturedRequest captured;
+                captured.timestamp = (start - navitia::posix_epoch).total_milliseconds();
+                captured.data_identifier = data->data_identifier;
+                captured.duration = duration.total_milliseconds();
+                if (data->loaded) {
+                    captured.publication_date = pt::to_iso_string(data->meta->publication_date);
+                }
+                captured.payload = std::move(payload);
+                request_capture->write(captured);
+            }
         } else if (api != pbnavitia::METADATAS) {
             LOG4CPLUS_DEBUG(logger, "processing time : " << duration.total_milliseconds());
         }
@@ -31,6 +31,7 @@ www.navitia.io
 #include "maintenance_worker.h"
 
 #include "apply_disruption.h"
+#include "georef/georef.h"
 #include "make_disruption_from_chaos.h"
 #include "metrics.h"
 #include "realtime.h"
@@ -63,7 +64,8 @@ void MaintenanceWorker::load_data() {
     auto contributors = conf.rt_topics();
     LOG4CPLUS_INFO(logger, "Loading database from file: " + database);
     auto start = pt::microsec_clock::universal_time();
-    if (this->data_manager.load(database, chaos_database, contributors, conf.raptor_cache_size(), chaos_batch_size)) {
+    if (this->data_manager.load(database, chaos_database, contributors, conf.raptor_cache_size(), chaos_batch_size,
+                                conf.contraction_hierarchy_modes(), conf.stop_point_walking_table_radius())) {
         auto data = data_manager.get_data();
         data->is_realtime_loaded = false;
         data->meta->instance_name = conf.instance_name();
@@ -229,8 +231,13 @@ void MaintenanceWorker::handle_rt_in_batch(const std::vector<AmqpClient::Envelop
         data->pt_data->clean_weak_impacts();
         LOG4CPLUS_INFO(logger, "rebuilding data raptor");
         data->build_raptor(conf.raptor_cache_size());
-        data->build_proximity_list();
+        // the street network is not changed by the realtime, only the moved stop points are projected again
+        data->build_proximity_list(data_manager.get_data().get());
         data->warmup(*data_manager.get_data());
+        if (!data->geo_ref->stop_point_walking_table) {
+            // a stop point has been added or moved, only its durations are computed again
+            data->build_stop_point_walking_table(conf.stop_point_walking_table_radius(), data_manager.get_data().get());
+        }
         data->set_last_rt_data_loaded(pt::microsec_clock::universal_time());
         data_manager.set_data(std::move(data));
 
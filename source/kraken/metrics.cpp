@@ -101,6 +101,19 @@ Metrics::Metrics(const boost::optional<std::string>& endpoint, const std::string
         auto& histo = histogram_family.Add({{"api", value->name()}}, create_fixed_duration_buckets());
         this->request_histogram[static_cast<pbnavitia::API>(value->number())] = &histo;
     }
+
+    auto& phase_histogram_family = prometheus::BuildHistogram()
+                                       .Name("kraken_journeys_phase_duration_seconds")
+                                       .Help("duration of each phase of a journeys request in seconds")
+                                       .Labels({{"coverage", coverage}})
+                                       .Register(*registry);
+    // For the phases, with bucket boundaries = {0.001, 0.002, 0.004, ..., 8.192} in seconds
+    for (size_t i = 0; i < routing::PhaseProfile::nb_phases; ++i) {
+        const auto phase = static_cast<routing::Phase>(i);
+        this->journeys_phase_histogram[i] = &phase_histogram_family.Add({{"phase", routing::phase_name(phase)}},
+                                                                        create_exponential_buckets(0.001, 2, 14));
+    }
+
     auto& in_flight_family = prometheus::BuildGauge()
                                  .Name("kraken_request_in_flight")
                                  .Help("Number of requests currently beeing processed")
@@ -173,6 +186,18 @@ void Metrics::observe_api(pbnavitia::API api, double duration) const {
     }
 }
 
+void Metrics::observe_journeys_phases(const routing::PhaseProfile& profile) const {
+    if (!registry || profile.empty()) {
+        return;
+    }
+    for (size_t i = 0; i < routing::PhaseProfile::nb_phases; ++i) {
+        const auto phase = static_cast<routing::Phase>(i);
+        if (profile.has(phase)) {
+            this->journeys_phase_histogram[i]->Observe(profile.seconds(phase));
+        }
+    }
+}
+
 void Metrics::observe_data_loading(double duration) const {
     if (!registry) {
         return;
@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 
 #include "type/type.pb.h"
+#include "routing/phase_profile.h"
 
 #include <boost/optional.hpp>
 #include <boost/utility.hpp>
@@ -38,6 +39,7 @@ www.navitia.io
 #include <prometheus/counter.h>
 #include <prometheus/gauge.h>
 
+#include <array>
 #include <memory>
 #include <map>
 
@@ -68,6 +70,7 @@ protected:
     std::unique_ptr<prometheus::Exposer> exposer;
     std::shared_ptr<prometheus::Registry> registry;
     std::map<pbnavitia::API, prometheus::Histogram*> request_histogram;
+    std::array<prometheus::Histogram*, routing::PhaseProfile::nb_phases> journeys_phase_histogram{};
     prometheus::Gauge* in_flight;
     prometheus::Histogram* data_loading_histogram;
     prometheus::Histogram* data_cloning_histogram;
@@ -79,6 +82,7 @@ protected:
 public:
     Metrics(const boost::optional<std::string>& endpoint, const std::string& coverage);
     void observe_api(pbnavitia::API api, double duration) const;
+    void observe_journeys_phases(const routing::PhaseProfile& profile) const;
     InFlightGuard start_in_flight() const;
 
     void observe_data_loading(double duration) const;
@@ -0,0 +1,144 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "request_capture.h"
+
+#include "utils/exception.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace navitia {
+
+// every capture file starts with this header, the version is to be bumped if the format changes
+static const std::string capture_magic = "NAVCAPT1";
+
+template <typename T>
+static void write_pod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void write_string(std::ostream& out, const std::string& value) {
+    write_pod(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), value.size());
+}
+
+template <typename T>
+static bool read_pod(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+static bool read_string(std::istream& in, std::string& value) {
+    uint32_t size = 0;
+    if (!read_pod(in, size)) {
+        return false;
+    }
+    value.resize(size);
+    return static_cast<bool>(in.read(&value[0], size));
+}
+
+RequestCaptureWriter::RequestCaptureWriter(std::string path, size_t max_size, size_t nb_files)
+    : path(std::move(path)),
+      max_size(max_size),
+      nb_files(std::max<size_t>(nb_files, 1)),
+      logger(log4cplus::Logger::getInstance("request_capture")) {
+    LOG4CPLUS_INFO(logger, "slow requests will be captured in " << this->path);
+    open();
+}
+
+void RequestCaptureWriter::open() {
+    out.open(path, std::ios::binary | std::ios::app);
+    if (!out) {
+        LOG4CPLUS_ERROR(logger, "impossible to open " << path << ", slow requests won't be captured");
+        return;
+    }
+    out.seekp(0, std::ios::end);
+    current_size = static_cast<size_t>(out.tellp());
+    if (current_size == 0) {
+        out.write(capture_magic.data(), capture_magic.size());
+        current_size = capture_magic.size();
+    }
+}
+
+void RequestCaptureWriter::rotate() {
+    out.close();
+    const auto name = [&](size_t i) { return i == 0 ? path : path + "." + std::to_string(i); };
+    std::remove(name(nb_files - 1).c_str());
+    for (size_t i = nb_files - 1; i > 0; --i) {
+        std::rename(name(i - 1).c_str(), name(i).c_str());
+    }
+    open();
+}
+
+void RequestCaptureWriter::write(const CapturedRequest& request) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!out) {
+        return;
+    }
+    write_pod(out, request.timestamp);
+    write_pod(out, request.data_identifier);
+    write_pod(out, request.duration);
+    write_string(out, request.publication_date);
+    write_string(out, request.payload);
+    out.flush();
+
+    current_size += sizeof(request.timestamp) + sizeof(request.data_identifier) + sizeof(request.duration)
+                    + 2 * sizeof(uint32_t) + request.publication_date.size() + request.payload.size();
+    if (current_size >= max_size) {
+        rotate();
+    }
+}
+
+std::vector<CapturedRequest> read_captured_requests(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw navitia::exception("impossible to open capture file " + path);
+    }
+    std::string magic(capture_magic.size(), '\0');
+    if (!in.read(&magic[0], magic.size()) || magic != capture_magic) {
+        throw navitia::exception(path + " is not a request capture file");
+    }
+
+    std::vector<CapturedRequest> requests;
+    CapturedRequest request;
+    while (read_pod(in, request.timestamp)) {
+        if (!read_pod(in, request.data_identifier) || !read_pod(in, request.duration)
+            || !read_string(in, request.publication_date) || !read_string(in, request.payload)) {
+            // the last record can be truncated if kraken has been killed while writing it
+            auto logger = log4cplus::Logger::getInstance("request_capture");
+            LOG4CPLUS_WARN(logger, "truncated record at the end of " << path << ", it is ignored");
+            break;
+        }
+        requests.push_back(request);
+    }
+    return requests;
+}
+
+}  // namespace navitia
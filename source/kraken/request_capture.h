@@ -0,0 +1,87 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "utils/logger.h"
+
+#include <boost/utility.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace navitia {
+
+/*
+ * A request captured by kraken, with enough context to replay it.
+ *
+ * payload is the raw serialized pbnavitia::Request as received on the zmq socket.
+ */
+struct CapturedRequest {
+    uint64_t timestamp = 0;  // start of the request, in ms since epoch
+    uint64_t data_identifier = 0;
+    uint32_t duration = 0;  // in ms
+    std::string publication_date;
+    std::string payload;
+};
+
+/*
+ * Append the captured requests to a file, the file is rotated once it reaches max_size:
+ * file -> file.1 -> file.2 ... -> file.<nb_files - 1>, the oldest one being deleted.
+ *
+ * The writer is shared by all the workers threads.
+ */
+class RequestCaptureWriter : boost::noncopyable {
+    const std::string path;
+    const size_t max_size;
+    const size_t nb_files;
+    std::mutex mutex;
+    std::ofstream out;
+    size_t current_size = 0;
+    log4cplus::Logger logger;
+
+    void open();
+    void rotate();
+
+public:
+    RequestCaptureWriter(std::string path, size_t max_size, size_t nb_files);
+    void write(const CapturedRequest& request);
+};
+
+/*
+ * Read all the requests of a capture file
+ * throw a navitia::exception if the file isn't a valid capture file
+ */
+std::vector<CapturedRequest> read_captured_requests(const std::string& path);
+
+}  // namespace navitia
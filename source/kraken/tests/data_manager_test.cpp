@@ -46,6 +46,8 @@ public:
     void build_raptor(size_t) {}
     void build_relations() {}
     void build_proximity_list() {}
+    void build_contraction_hierarchies(const std::vector<navitia::type::Mode_e>&) {}
+    void build_stop_point_walking_table(const navitia::time_duration&) {}
     void build_autocomplete_partial() {}
     mutable std::atomic<bool> loading;
     mutable std::atomic<bool> is_connected_to_rabbitmq;
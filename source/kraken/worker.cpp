@@ -40,6 +40,7 @@ www.navitia.io
 #include "proximity_list/proximitylist_api.h"
 #include "ptreferential/ptreferential.h"
 #include "ptreferential/ptreferential_api.h"
+#include "routing/isochrone.h"
 #include "routing/raptor.h"
 #include "routing/raptor_api.h"
 #include "time_tables/departure_boards.h"
@@ -240,7 +241,9 @@ std::vector<std::string> vector_of_admins(const T& admin) {
 }
 
 Worker::Worker(kraken::Configuration conf)
-    : conf(std::move(conf)), logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"))) {}
+    : conf(std::move(conf)),
+      logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"))),
+      isochrone_cache(std::make_unique<routing::IsochroneCache>(this->conf.isochrone_cache_size())) {}
 
 Worker::~Worker() = default;
 
@@ -400,6 +403,7 @@ void Worker::init_worker_data(const navitia::type::Data* data,
     if (data->data_identifier != this->last_data_identifier || !planner) {
         planner = std::make_unique<routing::RAPTOR>(*data);
         street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref);
+        isochrone_cache->clear();
         this->last_data_identifier = data->data_identifier;
         LOG4CPLUS_INFO(logger, "Instanciate planner");
     }
@@ -774,7 +778,11 @@ void Worker::journeys(const pbnavitia::JourneysRequest& request,
                       pbnavitia::API api,
                       const boost::posix_time::ptime& current_datetime) {
     try {
-        navitia::JourneysArg arg = fill_journeys(request);
+        navitia::JourneysArg arg;
+        {
+            routing::PhaseSpan span(routing::Phase::entry_points);
+            arg = fill_journeys(request);
+        }
 
         if (arg.origins.empty() && arg.destinations.empty()) {
             // should never happen, jormungandr filters that, but it never hurts to double check
@@ -907,7 +915,8 @@ void Worker::graphical_isochrone(const pbnavitia::GraphicalIsochroneRequest& req
     navitia::routing::make_graphical_isochrone(
         this->pb_creator, *planner, center_and_stop_points.first, request_journey.datetimes(0), boundary_duration,
         request_journey.max_transfers(), arg.accessibilite_params, arg.forbidden, arg.allowed,
-        request_journey.clockwise(), arg.rt_level, *street_network_worker, end_speed, center_and_stop_points.second);
+        request_journey.clockwise(), arg.rt_level, *street_network_worker, end_speed, center_and_stop_points.second,
+        isochrone_cache.get());
 }
 
 void Worker::heat_map(const pbnavitia::HeatMapRequest& request) {
@@ -1019,32 +1028,24 @@ void Worker::street_network_routing_matrix(const pbnavitia::StreetNetworkRouting
         }
     }
 
+    std::vector<type::EntryPoint> origins;
     for (const auto& origin : request.origins()) {
-        type::EntryPoint entry_point;
         try {
-            entry_point =
-                make_sn_entry_point(origin.place(), request.mode(), request.speed(), request.max_duration(), *data);
+            origins.push_back(
+                make_sn_entry_point(origin.place(), request.mode(), request.speed(), request.max_duration(), *data));
         } catch (const navitia::coord_conversion_exception& e) {
             this->pb_creator.fill_pb_error(pbnavitia::Error::bad_format, e.what());
             return;
         }
+    }
 
-        street_network_worker->departure_path_finder.init(entry_point.coordinates,
-                                                          entry_point.streetnetwork_params.mode,
-                                                          entry_point.streetnetwork_params.speed_factor);
-        auto nearest = street_network_worker->departure_path_finder.get_duration_with_dijkstra(
-            navitia::time_duration::from_boost_duration(boost::posix_time::seconds(request.max_duration())),
-            dest_coords);
-
+    const auto radius = navitia::time_duration::from_boost_duration(boost::posix_time::seconds(request.max_duration()));
+    auto fill_row = [&](const std::vector<georef::RoutingElement>& durations) {
         auto* row = this->pb_creator.mutable_sn_routing_matrix()->add_rows();
-        for (auto coord : dest_coords) {
+        for (const auto& duration : durations) {
             auto* k = row->add_routing_response();
-            auto it = nearest.find(coord.uri());
-            if (it == nearest.end()) {
-                throw navitia::recoverable_exception("Cannot find object: " + coord.uri());
-            }
-            k->set_duration(it->second.time_duration.total_seconds());
-            switch (it->second.routing_status) {
+            k->set_duration(duration.time_duration.total_seconds());
+            switch (duration.routing_status) {
                 case georef::RoutingStatus_e::reached:
                     k->set_routing_status(pbnavitia::RoutingStatus::reached);
                     break;
@@ -1055,6 +1056,41 @@ void Worker::street_network_routing_matrix(const pbnavitia::StreetNetworkRouting
                     k->set_routing_status(pbnavitia::RoutingStatus::unknown);
             }
         }
+    };
+
+    // with a contraction hierarchy, the whole matrix is computed with one upward search by origin and by destination
+    if (!origins.empty()) {
+        const auto& sn_params = origins.front().streetnetwork_params;
+        const auto& ch = data->geo_ref->contraction_hierarchies[sn_params.mode];
+        if (ch && ch->is_built_for(data->geo_ref->csr_graph)) {
+            std::vector<type::GeographicalCoord> origin_coords;
+            for (const auto& entry_point : origins) {
+                origin_coords.push_back(entry_point.coordinates);
+            }
+            const auto matrix = street_network_worker->matrix_path_finder.compute_matrix(
+                *ch, origin_coords, dest_coords, sn_params.mode, sn_params.speed_factor, radius);
+            for (const auto& row : matrix) {
+                fill_row(row);
+            }
+            return;
+        }
+    }
+
+    for (const auto& entry_point : origins) {
+        street_network_worker->departure_path_finder.init(entry_point.coordinates,
+                                                          entry_point.streetnetwork_params.mode,
+                                                          entry_point.streetnetwork_params.speed_factor);
+        auto nearest = street_network_worker->departure_path_finder.get_duration_with_dijkstra(radius, dest_coords);
+
+        std::vector<georef::RoutingElement> durations;
+        for (const auto& coord : dest_coords) {
+            auto it = nearest.find(coord.uri());
+            if (it == nearest.end()) {
+                throw navitia::recoverable_exception("Cannot find object: " + coord.uri());
+            }
+            durations.push_back(it->second);
+        }
+        fill_row(durations);
     }
 }
 
@@ -1081,6 +1117,8 @@ boost::optional<size_t> Worker::get_raptor_next_st_cache_miss() const {
 void Worker::dispatch(const pbnavitia::Request& request,
                       const nt::Data& data,
                       const boost::optional<const navitia::Deadline&>& deadline) {
+    phase_profile.reset();
+    routing::PhaseProfileGuard phase_profile_guard(phase_profile);
     bool disable_geojson = get_geojson_state(request);
     boost::posix_time::ptime current_datetime = bt::from_time_t(request._current_datetime());
     this->init_worker_data(&data, current_datetime, null_time_period, disable_geojson, request.disable_feedpublisher(),
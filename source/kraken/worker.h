@@ -34,6 +34,7 @@ www.navitia.io
 namespace navitia {
 namespace routing {
 struct RAPTOR;
+class IsochroneCache;
 }
 }  // namespace navitia
 
@@ -46,6 +47,7 @@ struct RAPTOR;
 #include "utils/logger.h"
 #include "kraken/configuration.h"
 #include "type/pb_converter.h"
+#include "routing/phase_profile.h"
 
 #include <memory>
 #include <limits>
@@ -84,6 +86,10 @@ private:
     size_t last_data_identifier =
         std::numeric_limits<size_t>::max();  // to check that data did not change, do not use directly
     boost::posix_time::ptime last_load_at;
+    // durations of the phases of the last journeys request
+    routing::PhaseProfile phase_profile;
+    // graphical isochrones of the last requests, cleared with the planner
+    std::unique_ptr<navitia::routing::IsochroneCache> isochrone_cache;
 
 public:
     navitia::PbCreator pb_creator;
@@ -97,6 +103,7 @@ public:
                   const nt::Data& data,
                   const boost::optional<const navitia::Deadline&>& deadline = boost::none);
     boost::optional<size_t> get_raptor_next_st_cache_miss() const;
+    const routing::PhaseProfile& get_phase_profile() const { return phase_profile; }
 
 private:
     void init_worker_data(const navitia::type::Data* data,
@@ -32,8 +32,7 @@ www.navitia.io
 
 #include "type/geographical_coord.h"
 
-#include <flann/flann.hpp>
-
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <exception>
@@ -69,142 +68,142 @@ static float search_radius_correction_factor(const double& radius) {
                      * asin(radius / (2. * GeographicalCoord::EARTH_RADIUS_IN_METERS)) / radius;
 }
 
+static int32_t band_of(const double lat) {
+    return int32_t(std::floor(lat / GRID_BAND_HEIGHT));
+}
+
+std::vector<uint32_t> sort_along_grid(const std::vector<GeographicalCoord>& coords) {
+    std::vector<uint32_t> order(coords.size());
+    for (size_t i = 0; i < coords.size(); ++i) {
+        order[i] = uint32_t(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&](const uint32_t a, const uint32_t b) {
+        const auto band_a = band_of(coords[a].lat());
+        const auto band_b = band_of(coords[b].lat());
+        return band_a != band_b ? band_a < band_b : coords[a].lon() < coords[b].lon();
+    });
+    return order;
+}
+
 template <class T>
 void ProximityList<T>::build() {
     log4cplus::Logger logger = log4cplus::Logger::getInstance("log");
-    LOG4CPLUS_INFO(logger, "Building Proximitylist's NN index with " << items.size() << " items");
+    LOG4CPLUS_INFO(logger, "Building Proximitylist's grid index with " << items.size() << " items");
 
-    // clean NN index
-    NN_data.clear();
-    NN_index.reset();
+    band_starts.clear();
+    xs.clear();
+    ys.clear();
+    zs.clear();
+    built = false;
 
     if (items.empty()) {
         LOG4CPLUS_WARN(logger, "No items for building the index");
         return;
     }
 
-    for (const auto& i : items) {
-        auto projected = project_coord(i.coord);
-        std::copy(projected.begin(), projected.end(), std::back_inserter(NN_data));
+    // the items loaded from a nav file are already sorted
+    auto grid_order = [](const Item& a, const Item& b) {
+        const auto band_a = band_of(a.coord.lat());
+        const auto band_b = band_of(b.coord.lat());
+        return band_a != band_b ? band_a < band_b : a.coord.lon() < b.coord.lon();
+    };
+    if (!std::is_sorted(items.begin(), items.end(), grid_order)) {
+        std::stable_sort(items.begin(), items.end(), grid_order);
     }
-    auto points = flann::Matrix<float>{&NN_data[0], NN_data.size() / 3, 3};
-    NN_index = std::make_shared<navitia::proximitylist::index_t>(points, flann::KDTreeSingleIndexParams(10));
-    NN_index->buildIndex();
-}
-
-template <typename T, typename Items, typename Indices, typename Distances, typename Out, typename F>
-static void make_result(const type::GeographicalCoord& coord,
-                        const Items& items,
-                        const Indices& indices,
-                        const Distances& distances,
-                        const int nb_found,
-                        Out& out,
-                        F op) {
-    log4cplus::Logger logger = log4cplus::Logger::getInstance("log");
 
-    if (!nb_found) {
-        LOG4CPLUS_TRACE(log4cplus::Logger::getInstance("log"),
-                        "0 point found for the coord: " << coord.lon() << " " << coord.lat());
-        return;
+    first_band = band_of(items.front().coord.lat());
+    const auto nb_bands = size_t(band_of(items.back().coord.lat()) - first_band) + 1;
+    band_starts.assign(nb_bands + 1, 0);
+    for (const auto& item : items) {
+        ++band_starts[size_t(band_of(item.coord.lat()) - first_band) + 1];
     }
-    for (int i = 0; i < nb_found; ++i) {
-        int res_ind = indices.at(i);
-        if (res_ind < 0 || res_ind >= static_cast<int>(items.size())) {
-            continue;
-        }
-        LOG4CPLUS_TRACE(
-            log4cplus::Logger::getInstance("log"),
-            "Distance(squared) from the coord: " << coord.lon() << " " << coord.lat() << " is " << distances.at(i));
-        const auto& item = items[res_ind];
-        out.push_back(op(item, distances.at(i)));
+    for (size_t band = 1; band <= nb_bands; ++band) {
+        band_starts[band] += band_starts[band - 1];
     }
-}
-
-template <typename IndexType, typename DistanceType>
-static int radius_search(const std::shared_ptr<index_t>& NN_index,
-                         const GeographicalCoord& coord,
-                         double radius,
-                         int size,
-                         IndexType& indices,
-                         DistanceType& distances) {
-    log4cplus::Logger logger = log4cplus::Logger::getInstance("log");
-
-    auto query = project_coord(coord);
-
-    auto search_param = flann::SearchParams{};
-    search_param.max_neighbors = size;  // -1 -> unlimited
-
-    radius = std::min(radius, 2 * GeographicalCoord::EARTH_RADIUS_IN_METERS);
 
-    float factor = search_radius_correction_factor(radius);
-    int nb_found = NN_index->radiusSearch(flann::Matrix<float>{&query[0], 1, 3}, indices, distances,
-                                          pow(radius * static_cast<double>(factor), 2), search_param);
-
-    LOG4CPLUS_TRACE(log4cplus::Logger::getInstance("log"),
-                    "" << nb_found << " point found for the coord: " << coord.lon() << " " << coord.lat());
-
-    return nb_found;
+    xs.reserve(items.size());
+    ys.reserve(items.size());
+    zs.reserve(items.size());
+    for (const auto& item : items) {
+        const auto projected = project_coord(item.coord);
+        xs.push_back(projected[0]);
+        ys.push_back(projected[1]);
+        zs.push_back(projected[2]);
+    }
+    built = true;
 }
 
 template <class T>
-auto ProximityList<T>::find_within_impl(const GeographicalCoord& coord,
-                                        const double radius,
-                                        const int size,
-                                        IndexCoord /*unused*/) const
-    -> std::vector<typename ReturnTypeTrait<T, IndexCoord>::ValueType> {
-    // Containers are auto-sized by NN_index, Flann will return all objects inside of the given radius
-    std::vector<std::vector<int>> indices;
-    std::vector<std::vector<index_t::DistanceType>> distances;
-    int nb_found = radius_search(NN_index, coord, radius, size, indices, distances);
-    assert(indices.size() == 1);
-    assert(distances.size() == 1);
-
-    std::vector<typename ReturnTypeTrait<T, IndexCoord>::ValueType> res;
-    auto op = [](const Item& item, float /*unused*/) { return std::make_pair(item.element, item.coord); };
-    make_result<T>(coord, items, indices[0], distances[0], nb_found, res, op);
+const std::vector<std::pair<float, uint32_t>>& ProximityList<T>::search(const GeographicalCoord& coord,
+                                                                        double radius,
+                                                                        int size) const {
+    thread_local std::vector<std::pair<float, uint32_t>> found;
+    found.clear();
 
-    return res;
-}
-
-template <typename T>
-auto ProximityList<T>::find_within_impl(const GeographicalCoord& coord,
-                                        const double radius,
-                                        const int size,
-                                        IndexCoordDistance /*unused*/) const
-    -> std::vector<typename ReturnTypeTrait<T, IndexCoordDistance>::ValueType> {
-    // Containers are auto-sized by NN_index, Flann will return all objects inside of the given radius
-    std::vector<std::vector<int>> indices;
-    std::vector<std::vector<index_t::DistanceType>> distances;
-    int nb_found = radius_search(NN_index, coord, radius, size, indices, distances);
-    assert(indices.size() == 1);
-    assert(distances.size() == 1);
-
-    std::vector<typename ReturnTypeTrait<T, IndexCoordDistance>::ValueType> res;
-    auto op = [](const Item& item, float distance) { return std::make_tuple(item.element, item.coord, distance); };
-    make_result<T>(coord, items, indices[0], distances[0], nb_found, res, op);
+    radius = std::min(radius, 2 * GeographicalCoord::EARTH_RADIUS_IN_METERS);
+    const float factor = search_radius_correction_factor(radius);
+    const auto max_distance = float(pow(radius * static_cast<double>(factor), 2));
+
+    // the angle of the circle seen from the center of the earth, in degrees
+    const double chord = std::min(1., radius * factor / (2 * GeographicalCoord::EARTH_RADIUS_IN_METERS));
+    const double angle = 2 * asin(chord);
+    const double angle_deg = angle / GeographicalCoord::N_DEG_TO_RAD;
+
+    // the longitude range of the circle, split at the antimeridian
+    const double lat_rad = coord.lat() * GeographicalCoord::N_DEG_TO_RAD;
+    std::vector<std::pair<double, double>> lon_ranges;
+    if (std::abs(coord.lat()) + angle_deg >= 90 || sin(angle) >= cos(lat_rad)) {
+        lon_ranges.emplace_back(-180, 180);
+    } else {
+        // with a small margin for the rounding of the projected coords
+        const double delta = asin(sin(angle) / cos(lat_rad)) / GeographicalCoord::N_DEG_TO_RAD + 1e-6;
+        const double min_lon = coord.lon() - delta;
+        const double max_lon = coord.lon() + delta;
+        if (min_lon < -180 || max_lon > 180) {
+            lon_ranges.emplace_back(-180, max_lon > 180 ? max_lon - 360 : max_lon);
+            lon_ranges.emplace_back(min_lon < -180 ? min_lon + 360 : min_lon, 180);
+        } else {
+            lon_ranges.emplace_back(min_lon, max_lon);
+        }
+    }
 
-    return res;
-}
+    const auto query = project_coord(coord);
+    const int64_t last_band = first_band + int64_t(band_starts.size()) - 2;
+    const int64_t begin_band = std::max<int64_t>(first_band, band_of(coord.lat() - angle_deg - 1e-6));
+    const int64_t end_band = std::min<int64_t>(last_band, band_of(coord.lat() + angle_deg + 1e-6));
+    for (int64_t band = begin_band; band <= end_band; ++band) {
+        const auto band_begin = items.begin() + band_starts[size_t(band - first_band)];
+        const auto band_end = items.begin() + band_starts[size_t(band - first_band) + 1];
+        for (const auto& lon_range : lon_ranges) {
+            const auto begin = std::lower_bound(
+                band_begin, band_end, lon_range.first,
+                [](const Item& item, const double lon) { return item.coord.lon() < lon; });
+            const auto end = std::upper_bound(
+                begin, band_end, lon_range.second,
+                [](const double lon, const Item& item) { return lon < item.coord.lon(); });
+            // the distances are computed on the contiguous projected coords
+            for (auto i = uint32_t(begin - items.begin()), e = uint32_t(end - items.begin()); i < e; ++i) {
+                const float dx = xs[i] - query[0];
+                const float dy = ys[i] - query[1];
+                const float dz = zs[i] - query[2];
+                const float distance = dx * dx + dy * dy + dz * dz;
+                if (distance <= max_distance) {
+                    found.emplace_back(distance, i);
+                }
+            }
+        }
+    }
 
-template <class T>
-auto ProximityList<T>::find_within_impl(const GeographicalCoord& coord,
-                                        const double radius,
-                                        const int size,
-                                        IndexOnly /*unused*/) const
-    -> std::vector<typename ReturnTypeTrait<T, IndexOnly>::ValueType> {
-    // Using small sized std::array will avoid heap allocation and limit the research
-    const static std::size_t max_size = 100;
-    std::array<int, max_size> indices_data{};
-    flann::Matrix<int> indices(&indices_data[0], 1, size == -1 ? max_size : size);
-    std::array<index_t::DistanceType, max_size> distances_data{};
-    flann::Matrix<index_t::DistanceType> distances(&distances_data[0], 1, size == -1 ? max_size : size);
-    int nb_found = radius_search(NN_index, coord, radius, size, indices, distances);
-
-    std::vector<typename ReturnTypeTrait<T, IndexOnly>::ValueType> res;
-    auto op = [](const Item& item, float /*unused*/) { return item.element; };
-    make_result<T>(coord, items, indices_data, distances_data, nb_found, res, op);
+    if (size > 0 && found.size() > size_t(size)) {
+        std::partial_sort(found.begin(), found.begin() + size, found.end());
+        found.resize(size_t(size));
+    } else {
+        std::sort(found.begin(), found.end());
+    }
 
-    return res;
+    LOG4CPLUS_TRACE(log4cplus::Logger::getInstance("log"),
+                    "" << found.size() << " point found for the coord: " << coord.lon() << " " << coord.lat());
+    return found;
 }
 
 NotFound::~NotFound() noexcept = default;
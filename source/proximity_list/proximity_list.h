@@ -34,23 +34,19 @@ www.navitia.io
 #include "utils/exception.h"
 #include "utils/logger.h"
 
-#include <memory>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-// Forward declaration
-namespace flann {
-template <typename T>
-class Index;
-
-template <typename T>
-class L2;
-}  // namespace flann
-
 namespace navitia {
 namespace proximitylist {
 
 using type::GeographicalCoord;
-using index_t = flann::Index<flann::L2<float>>;
+
+// Height in degrees of the latitude bands of the grid index
+constexpr static double GRID_BAND_HEIGHT = 0.002;
 
 struct NotFound : public recoverable_exception {
     NotFound() = default;
@@ -59,6 +55,10 @@ struct NotFound : public recoverable_exception {
     ~NotFound() noexcept override;
 };
 
+// The positions of the coords sorted along the grid of the proximity lists, so that the
+// successive coords are close to each other
+std::vector<uint32_t> sort_along_grid(const std::vector<GeographicalCoord>& coords);
+
 // find_within Dispatch Tag
 struct IndexOnly {};
 struct IndexCoord {};
@@ -86,9 +86,13 @@ struct ReturnTypeTrait<T, IndexCoordDistance> {
  * The Item contains T(in practice, the Idx of the wanted object) and the coord of the object.
  *
  * This structure is used to do projection and find features(POI, stop_points, etc) nearby a wanted place.
- * An internal structure, KD-tree from flann is used to have a good perfomance.
  *
- * The coord is projected into 3D space so that we can performan a euclidean distance which can be highly optimized.
+ * The items are indexed in a static grid: they are sorted by latitude bands of GRID_BAND_HEIGHT,
+ * then by longitude inside a band. A search scans, in each band crossed by the circle, the items
+ * in the longitude range of the circle.
+ *
+ * The coord is projected into 3D space so that we can performan a euclidean distance which can be highly optimized:
+ * the projected coords are kept in contiguous arrays, in the order of the items.
  *
  * */
 template <class T>
@@ -106,36 +110,97 @@ struct ProximityList {
 
     /// Contient toutes les coordonnées de manière à trouver rapidement
     std::vector<Item> items;
-    std::vector<float> NN_data;
-    std::shared_ptr<index_t> NN_index = nullptr;
 
     /// Rajoute un nouvel élément. Attention, il faut appeler build avant de pouvoir utiliser la structure
-    void add(GeographicalCoord coord, T element) { items.push_back(Item(coord, element)); }
+    void add(GeographicalCoord coord, T element) {
+        items.push_back(Item(coord, element));
+        built = false;
+    }
     void clear() {
         items.clear();
-        NN_data.clear();
+        band_starts.clear();
+        xs.clear();
+        ys.clear();
+        zs.clear();
+        built = false;
     }
 
-    // build the Nearest Neighbours data from items, then the index
+    // sort the items along the grid, then build the bands and the projected coords
     void build();
 
     /*
-     * This method can return three types of result
+     * This method can return three types of result, sorted by distance
      *
      * When Tag is IndexCorrd, the method returns a vector of Index and Coord, which is useful for searching
      * features nearby a wanted place.
 
-     * When Tag is IndexCorrdDistance, the method returns a vector of Index, Coord and the Distance.
+     * When Tag is IndexCorrdDistance, the method returns a vector of Index, Coord and the squared Distance.
      *
      * If Tag is IndexOnly, the method returns a vector of Index, which is useful for coord projections.
+     * At most 100 elements are then returned when the size is not given.
      *
      * */
     template <typename Tag = IndexCoord>
     auto find_within(const GeographicalCoord& coord, double radius = 500, int size = -1) const
         -> std::vector<typename ReturnTypeTrait<T, Tag>::ValueType> {
-        if (!NN_index || !size || !radius)
-            return {};
-        return find_within_impl(coord, radius, size, Tag{});
+        std::vector<typename ReturnTypeTrait<T, Tag>::ValueType> res;
+        find_within<Tag>(coord, res, radius, size);
+        return res;
+    }
+
+    // Same as above, the results being written in out, so that its memory can be reused between the searches
+    template <typename Tag = IndexCoord>
+    void find_within(const GeographicalCoord& coord,
+                     std::vector<typename ReturnTypeTrait<T, Tag>::ValueType>& out,
+                     double radius = 500,
+                     int size = -1) const {
+        out.clear();
+        if (!built || !size || !radius) {
+            return;
+        }
+        if (std::is_same<Tag, IndexOnly>::value && size == -1) {
+            size = max_index_only_size;
+        }
+        for (const auto& found : search(coord, radius, size)) {
+            out.push_back(make_value(items[found.second], found.first, Tag{}));
+        }
+    }
+
+    /*
+     * find_within for each coord, the results being written in flat arrays: the results of
+     * coords[i] are out[offsets[i]] to out[offsets[i + 1]] (excluded)
+     *
+     * The searches follow the grid, so that the successive searches scan the same items.
+     * */
+    template <typename Tag = IndexCoord>
+    void find_within_batch(const std::vector<GeographicalCoord>& coords,
+                           std::vector<typename ReturnTypeTrait<T, Tag>::ValueType>& out,
+                           std::vector<uint32_t>& offsets,
+                           double radius = 500,
+                           int size = -1) const {
+        out.clear();
+        offsets.assign(coords.size() + 1, 0);
+        if (!built || !size || !radius) {
+            return;
+        }
+        if (std::is_same<Tag, IndexOnly>::value && size == -1) {
+            size = max_index_only_size;
+        }
+        // the results in the order of the searches, then put back in the order of the coords
+        std::vector<std::pair<float, uint32_t>> found;
+        std::vector<std::pair<uint32_t, uint32_t>> ranges(coords.size());
+        for (const auto i : sort_along_grid(coords)) {
+            const auto& res = search(coords[i], radius, size);
+            ranges[i] = {uint32_t(found.size()), uint32_t(found.size() + res.size())};
+            found.insert(found.end(), res.begin(), res.end());
+        }
+        out.reserve(found.size());
+        for (size_t i = 0; i < coords.size(); ++i) {
+            for (auto f = ranges[i].first; f < ranges[i].second; ++f) {
+                out.push_back(make_value(items[found[f].second], found[f].first, Tag{}));
+            }
+            offsets[i + 1] = uint32_t(out.size());
+        }
     }
 
     /// Fonction de confort pour retrouver l'élément le plus proche dans l'indexe
@@ -153,6 +218,9 @@ struct ProximityList {
     /** Fonction qui permet de sérialiser (aka binariser la structure de données
      *
      * Elle est appelée par boost et pas directement
+     *
+     * The items are serialized in the order of the grid once built, so that build only has to
+     * check their order when they are loaded.
      */
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -160,29 +228,36 @@ struct ProximityList {
     }
 
 private:
-    /*
-     * This implementation is used for /places_nearby
-     *
-     * Auto-sized container is used, NN_index will return ALL elements meet the criteira
-     *
-     * Note that this implementation returns the indices AND the coords of all the nearest elements
-     * */
-    auto find_within_impl(const GeographicalCoord& coord, const double radius, const int size, IndexCoord) const
-        -> std::vector<typename ReturnTypeTrait<T, IndexCoord>::ValueType>;
+    constexpr static int max_index_only_size = 100;
 
-    auto find_within_impl(const GeographicalCoord& coord, const double radius, const int size, IndexCoordDistance) const
-        -> std::vector<typename ReturnTypeTrait<T, IndexCoordDistance>::ValueType>;
+    bool built = false;
+    // band of the first item, and the first item of each band, followed by the end of the last band
+    int32_t first_band = 0;
+    std::vector<uint32_t> band_starts;
+    // the coords of the items projected in 3D
+    std::vector<float> xs;
+    std::vector<float> ys;
+    std::vector<float> zs;
 
     /*
-     * This implementation is used for edge projection
+     * The squared distances and the positions in items of the elements within the radius, sorted
+     * by distance and limited to size elements if size is not -1.
      *
-     * A small size-fixed std::array container is used to boost the performance, the NN_index will stop when
-     * the small size-fixed container is full.
-     * .
-     * Note that this implementation returns ONLY indices of nearest elements
+     * The returned buffer belongs to the calling thread and is reused by its next search.
      * */
-    auto find_within_impl(const GeographicalCoord& coord, const double radius, const int size, IndexOnly) const
-        -> std::vector<typename ReturnTypeTrait<T, IndexOnly>::ValueType>;
+    const std::vector<std::pair<float, uint32_t>>& search(const GeographicalCoord& coord,
+                                                          double radius,
+                                                          int size) const;
+
+    static T make_value(const Item& item, float /*unused*/, IndexOnly /*unused*/) { return item.element; }
+    static std::pair<T, GeographicalCoord> make_value(const Item& item, float /*unused*/, IndexCoord /*unused*/) {
+        return {item.element, item.coord};
+    }
+    static std::tuple<T, GeographicalCoord, float> make_value(const Item& item,
+                                                              float distance,
+                                                              IndexCoordDistance /*unused*/) {
+        return std::make_tuple(item.element, item.coord, distance);
+    }
 };
 
 }  // namespace proximitylist
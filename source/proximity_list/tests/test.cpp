@@ -199,6 +199,69 @@ BOOST_AUTO_TEST_CASE(find_nearest) {
     BOOST_CHECK_EQUAL_COLLECTIONS(tmp.begin(), tmp.end(), expected.begin(), expected.end());
 }
 
+BOOST_AUTO_TEST_CASE(find_within_grid) {
+    constexpr double M_TO_DEG = 1.0 / 111320.0;
+    ProximityList<unsigned int> pl;
+    // around the antimeridian, and in several bands of the grid
+    pl.add(GeographicalCoord(179.9999, 0), 1);
+    pl.add(GeographicalCoord(-179.9999, 0), 2);
+    pl.add(GeographicalCoord(-179.9999, 400 * M_TO_DEG), 3);
+    pl.add(GeographicalCoord(-179.9999, 2000 * M_TO_DEG), 4);
+    pl.add(GeographicalCoord(2.35, 48.85), 5);
+
+    // not built yet
+    BOOST_CHECK(pl.find_within(GeographicalCoord(180, 0)).empty());
+    pl.build();
+
+    auto res = pl.find_within<IndexCoordDistance>(GeographicalCoord(-179.99995, 0), 500);
+    std::vector<unsigned int> found;
+    for (const auto& r : res) {
+        found.push_back(std::get<0>(r));
+    }
+    // sorted by distance
+    std::vector<unsigned int> expected = {2, 1, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(found.begin(), found.end(), expected.begin(), expected.end());
+    BOOST_CHECK_CLOSE(std::sqrt(std::get<2>(res[0])), 5.57, 1);
+
+    BOOST_CHECK_EQUAL(pl.find_nearest(GeographicalCoord(179.99995, 2000 * M_TO_DEG), 100), 4);
+    BOOST_CHECK_THROW(pl.find_nearest(GeographicalCoord(0, 0)), NotFound);
+
+    // the buffer is reused
+    std::vector<unsigned int> buffer = {42};
+    pl.find_within<IndexOnly>(GeographicalCoord(-179.99995, 0), buffer, 500, 2);
+    expected = {2, 1};
+    BOOST_CHECK_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(), expected.begin(), expected.end());
+    pl.find_within<IndexOnly>(GeographicalCoord(2.35, 48.85), buffer);
+    expected = {5};
+    BOOST_CHECK_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(find_within_batch) {
+    ProximityList<unsigned int> pl;
+    for (unsigned int i = 0; i < 500; ++i) {
+        pl.add(GeographicalCoord(2.3 + (i * 37 % 100) * 0.001, 48.8 + (i * 53 % 100) * 0.001), i);
+    }
+    pl.build();
+
+    std::vector<GeographicalCoord> coords;
+    for (int i = 0; i < 50; ++i) {
+        coords.emplace_back(2.3 + (i * 7 % 100) * 0.001, 48.8 + (i * 13 % 100) * 0.001);
+    }
+    // far from everything
+    coords.emplace_back(0, 0);
+
+    std::vector<unsigned int> out;
+    std::vector<uint32_t> offsets;
+    pl.find_within_batch<IndexOnly>(coords, out, offsets, 300, 5);
+    BOOST_REQUIRE_EQUAL(offsets.size(), coords.size() + 1);
+    for (size_t i = 0; i < coords.size(); ++i) {
+        const auto expected = pl.find_within<IndexOnly>(coords[i], 300, 5);
+        BOOST_CHECK_EQUAL_COLLECTIONS(out.begin() + offsets[i], out.begin() + offsets[i + 1], expected.begin(),
+                                      expected.end());
+    }
+    BOOST_CHECK_EQUAL(offsets[coords.size() - 1], offsets[coords.size()]);
+}
+
 BOOST_AUTO_TEST_CASE(test_api) {
     navitia::type::Data data;
     // Everything in the range
@@ -30,6 +30,8 @@ www.navitia.io
 
 #include "raptor_api.h"
 #include "georef/street_network.h"
+#include "kraken/data_manager.h"
+#include "kraken/worker.h"
 #include "raptor.h"
 #include "type/data.h"
 #include "type/pb_converter.h"
@@ -45,9 +47,17 @@ www.navitia.io
 #endif
 #include <boost/program_options.hpp>
 #include <boost/progress.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <iomanip>
 #include <random>
+#include <thread>
 
 using namespace navitia;
 using namespace routing;
@@ -117,6 +127,130 @@ static type::GeographicalCoord coord_of_entry_point(const type::EntryPoint& entr
     return {};
 }
 
+struct ThroughputResult {
+    int nb_threads;
+    double requests_per_second;
+    double p50, p90, p99, max;  // latency in ms
+    double get_data_wait;       // mean time waiting for DataManager::get_data, in us
+    double next_st_cache_load;  // mean time spent in CachedNextStopTimeManager::load by request, in us
+    size_t nb_next_st_cache_miss;
+};
+
+// The time spent in the next stop time cache is only measured when built with this flag
+#ifdef __BENCH_WITH_NEXT_ST_CACHE_TIMING__
+static constexpr bool with_next_st_cache_timing = true;
+#else
+static constexpr bool with_next_st_cache_timing = false;
+#endif
+
+/*
+ * The configuration of the workers of the benchmark: the defaults of kraken, without the cache of the
+ * graphical isochrones, so that a repeated isochrone is computed again and not looked up
+ */
+static kraken::Configuration worker_configuration() {
+    kraken::Configuration conf;
+    const char* argv[] = {"benchmark", "--GENERAL.isochrone_cache_size=0"};
+    conf.load_from_command_line(kraken::get_options_description(std::string("benchmark"), std::string("")), 2, argv);
+    return conf;
+}
+
+static double percentile(const std::vector<double>& sorted_values, double p) {
+    if (sorted_values.empty()) {
+        return 0.;
+    }
+    auto rank = static_cast<size_t>(std::ceil(p * sorted_values.size()));
+    return sorted_values[std::max<size_t>(rank, 1) - 1];
+}
+
+static pbnavitia::Request make_journeys_request(const Request& request, int nb_second_pass) {
+    pbnavitia::Request pb_req;
+    pb_req.set_requested_api(pbnavitia::PLANNER);
+    pbnavitia::JourneysRequest* j = pb_req.mutable_journeys();
+    j->set_clockwise(true);
+    j->set_realtime_level(pbnavitia::BASE_SCHEDULE);
+    j->set_max_duration(DateTimeUtils::SECONDS_PER_DAY);
+    j->set_max_transfers(10);
+    j->set_max_extra_second_pass(nb_second_pass);
+    j->set_arrival_transfer_penalty(120);
+    j->set_walking_transfer_penalty(120);
+    j->add_datetimes(navitia::to_posix_timestamp(request.departure_posix_time));
+    auto* sn_params = j->mutable_streetnetwork_params();
+    sn_params->set_origin_mode("walking");
+    sn_params->set_destination_mode("walking");
+    sn_params->set_walking_speed(georef::default_speed[type::Mode_e::Walking]);
+    sn_params->set_max_walking_duration_to_pt(30 * 60);
+    auto* from = j->add_origin();
+    from->set_place(request.start);
+    from->set_access_duration(0);
+    auto* to = j->add_destination();
+    to->set_place(request.target);
+    to->set_access_duration(0);
+    return pb_req;
+}
+
+/*
+ * Run all the requests through Worker::dispatch with nb_threads threads sharing the same data,
+ * each thread having its own worker, as kraken does.
+ */
+static ThroughputResult run_throughput(const std::vector<pbnavitia::Request>& requests,
+                                       const DataManager<type::Data>& data_manager,
+                                       int nb_threads) {
+    using clock = std::chrono::steady_clock;
+    const auto& cache_manager = *data_manager.get_data()->dataRaptor->cached_next_st_manager;
+    const auto cache_miss_before = cache_manager.get_nb_cache_miss();
+#ifdef __BENCH_WITH_NEXT_ST_CACHE_TIMING__
+    const auto cache_load_before = cache_manager.get_load_duration();
+#endif
+
+    std::vector<double> latencies(requests.size());
+    std::atomic<uint64_t> get_data_wait_ns{0};
+    std::atomic_size_t next_request{0};
+
+    const auto start = clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nb_threads; ++i) {
+        threads.emplace_back([&]() {
+            navitia::Worker w(worker_configuration());
+            for (size_t idx = next_request++; idx < requests.size(); idx = next_request++) {
+                const auto request_start = clock::now();
+                const auto data = data_manager.get_data();
+                const auto data_acquired = clock::now();
+                try {
+                    w.dispatch(requests[idx], *data);
+                } catch (const navitia::recoverable_exception&) {
+                }
+                const auto request_end = clock::now();
+                get_data_wait_ns +=
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(data_acquired - request_start).count();
+                latencies[idx] = std::chrono::duration<double, std::milli>(request_end - request_start).count();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double total_seconds = std::chrono::duration<double>(clock::now() - start).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    const double nb_requests = std::max<size_t>(requests.size(), 1);
+
+    ThroughputResult result;
+    result.nb_threads = nb_threads;
+    result.requests_per_second = requests.size() / total_seconds;
+    result.p50 = percentile(latencies, 0.5);
+    result.p90 = percentile(latencies, 0.9);
+    result.p99 = percentile(latencies, 0.99);
+    result.max = latencies.empty() ? 0. : latencies.back();
+    result.get_data_wait = get_data_wait_ns.load() / 1000. / nb_requests;
+    result.next_st_cache_load = 0.;
+#ifdef __BENCH_WITH_NEXT_ST_CACHE_TIMING__
+    const auto cache_load = cache_manager.get_load_duration() - cache_load_before;
+    result.next_st_cache_load = std::chrono::duration<double, std::micro>(cache_load).count() / nb_requests;
+#endif
+    result.nb_next_st_cache_miss = cache_manager.get_nb_cache_miss() - cache_miss_before;
+    return result;
+}
+
 static type::EntryPoint make_entry_point(const std::string& entry_id, const type::Data& data) {
     type::EntryPoint entry;
     try {
@@ -136,7 +270,7 @@ static type::EntryPoint make_entry_point(const std::string& entry_id, const type
 int main(int argc, char** argv) {
     navitia::init_app();
     po::options_description desc("Benchmark tool options");
-    std::string data_file, benchmark_output_file, requests_input_file, requests_output_file;
+    std::string data_file, benchmark_output_file, requests_input_file, requests_output_file, threads_list;
     int iterations, nb_second_pass;
 
     // clang-format off
@@ -160,6 +294,13 @@ int main(int argc, char** argv) {
                                 "Write a csv file with the list of requests to be used, before starting the benchmark.\n"
                                 "Each line contains : start uri, target uri, departure posix time."
                                 )
+            ("threads,t", po::value<std::string>(&threads_list),
+                     "Throughput mode: comma-separated list of numbers of threads, for example 1,2,4,8.\n"
+                     "For each of them, all the requests are run through Worker::dispatch by this many threads "
+                     "sharing the same data, like kraken does, and the throughput, the latency percentiles, "
+                     "the wait on the data and the misses of the next stop time cache are reported. The time "
+                     "spent in the next stop time cache, its lock included, is reported too when built with "
+                     "-D__BENCH_WITH_NEXT_ST_CACHE_TIMING__.")
             ("output,o", po::value<std::string>(&benchmark_output_file),
                      "Write a csv file with the list of requests used, the computing time (in ms) needed to answer each request, "
                      "and the number of journey found.\n"
@@ -178,7 +319,11 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    type::Data data;
+    // the data is owned by a DataManager so that the throughput mode can share it between the workers like kraken
+    DataManager<type::Data> data_manager;
+    auto* data_ptr = new type::Data();
+    data_manager.set_data(data_ptr);
+    type::Data& data = *data_ptr;
     {
         Timer t("Loading data from : " + data_file);
         data.load_nav(data_file);
@@ -249,18 +394,69 @@ int main(int argc, char** argv) {
         out_file.close();
     }
 
-    // Journeys computation
-    std::vector<Result> results;
-    data.build_raptor();
-    RAPTOR raptor(data);
-    auto georef_worker = georef::StreetNetwork(*data.geo_ref);
-
     // disabling logging, to not pollute std::cout
     auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     logger.setLogLevel(log4cplus::WARN_LOG_LEVEL);
     auto logger_raptor = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("raptor"));
     logger_raptor.setLogLevel(log4cplus::WARN_LOG_LEVEL);
 
+    if (vm.count("threads")) {
+        std::vector<std::string> threads_str;
+        boost::algorithm::split(threads_str, threads_list, boost::algorithm::is_any_of(","));
+        std::vector<pbnavitia::Request> pb_requests;
+        for (const auto& request : requests) {
+            pb_requests.push_back(make_journeys_request(request, nb_second_pass));
+        }
+
+        std::cout << "Launching throughput benchmark with " << pb_requests.size() << " requests" << std::endl;
+        std::vector<ThroughputResult> throughput_results;
+        for (const auto& nb_threads : threads_str) {
+            throughput_results.push_back(
+                run_throughput(pb_requests, data_manager, boost::lexical_cast<int>(boost::trim_copy(nb_threads))));
+        }
+
+        std::cout << std::setw(8) << "threads" << std::setw(12) << "req/s" << std::setw(12) << "p50 (ms)"
+                  << std::setw(12) << "p90 (ms)" << std::setw(12) << "p99 (ms)" << std::setw(12) << "max (ms)"
+                  << std::setw(18) << "get_data (us)";
+        if (with_next_st_cache_timing) {
+            std::cout << std::setw(18) << "st cache (us)";
+        }
+        std::cout << std::setw(14) << "cache miss" << std::endl;
+        for (const auto& r : throughput_results) {
+            std::cout << std::setw(8) << r.nb_threads << std::setw(12) << r.requests_per_second << std::setw(12)
+                      << r.p50 << std::setw(12) << r.p90 << std::setw(12) << r.p99 << std::setw(12) << r.max
+                      << std::setw(18) << r.get_data_wait;
+            if (with_next_st_cache_timing) {
+                std::cout << std::setw(18) << r.next_st_cache_load;
+            }
+            std::cout << std::setw(14) << r.nb_next_st_cache_miss << std::endl;
+        }
+
+        if (vm.count("output")) {
+            std::fstream out_file(benchmark_output_file, std::ios::out);
+            out_file << "Nb threads, Requests per second, p50 (ms), p90 (ms), p99 (ms), max (ms), get_data wait (us), ";
+            if (with_next_st_cache_timing) {
+                out_file << "next stop time cache load (us), ";
+            }
+            out_file << "next stop time cache miss\n";
+            for (const auto& r : throughput_results) {
+                out_file << r.nb_threads << ", " << r.requests_per_second << ", " << r.p50 << ", " << r.p90 << ", "
+                         << r.p99 << ", " << r.max << ", " << r.get_data_wait << ", ";
+                if (with_next_st_cache_timing) {
+                    out_file << r.next_st_cache_load << ", ";
+                }
+                out_file << r.nb_next_st_cache_miss << "\n";
+            }
+            out_file.close();
+        }
+        return 0;
+    }
+
+    // Journeys computation
+    std::vector<Result> results;
+    RAPTOR raptor(data);
+    auto georef_worker = georef::StreetNetwork(*data.geo_ref);
+
     std::cout << "Launching benchmark " << std::endl;
     boost::progress_display show_progress(requests.size());
     int nb_reponses = 0, nb_journeys = 0;
@@ -0,0 +1,307 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+/*
+ * Replay the requests captured by kraken (see GENERAL.slow_request_capture_file)
+ * against a data.nav.lz4, with the same code path as kraken (Worker::dispatch).
+ *
+ * Reports the throughput and the latency percentiles per api, and can compare
+ * them with the csv output of a previous run to detect regressions.
+ */
+
+#include "kraken/request_capture.h"
+#include "kraken/worker.h"
+#include "type/data.h"
+#include "type/meta_data.h"
+#include "utils/csv.h"
+#include "utils/init.h"
+#include "utils/timer.h"
+
+#include <boost/program_options.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <thread>
+
+using namespace navitia;
+namespace po = boost::program_options;
+
+namespace {
+
+struct ReplayedRequest {
+    pbnavitia::Request request;
+    std::string api;
+    double duration = 0.;  // in ms
+    bool has_error = false;
+};
+
+struct ApiStats {
+    size_t count = 0;
+    size_t nb_errors = 0;
+    double p50 = 0.;
+    double p90 = 0.;
+    double p99 = 0.;
+    double max = 0.;
+};
+
+double percentile(const std::vector<double>& sorted_durations, double p) {
+    if (sorted_durations.empty()) {
+        return 0.;
+    }
+    auto rank = static_cast<size_t>(std::ceil(p * sorted_durations.size()));
+    return sorted_durations[std::max<size_t>(rank, 1) - 1];
+}
+
+std::map<std::string, ApiStats> compute_stats(const std::vector<ReplayedRequest>& requests) {
+    std::map<std::string, std::vector<double>> durations_by_api;
+    std::map<std::string, ApiStats> stats;
+    for (const auto& r : requests) {
+        for (const auto& api : {r.api, std::string("all")}) {
+            durations_by_api[api].push_back(r.duration);
+            if (r.has_error) {
+                ++stats[api].nb_errors;
+            }
+        }
+    }
+    for (auto& api_durations : durations_by_api) {
+        auto& durations = api_durations.second;
+        std::sort(durations.begin(), durations.end());
+        auto& s = stats[api_durations.first];
+        s.count = durations.size();
+        s.p50 = percentile(durations, 0.5);
+        s.p90 = percentile(durations, 0.9);
+        s.p99 = percentile(durations, 0.99);
+        s.max = durations.back();
+    }
+    return stats;
+}
+
+std::map<std::string, ApiStats> read_baseline(const std::string& file) {
+    std::map<std::string, ApiStats> baseline;
+    CsvReader csv(file, ',');
+    csv.next();  // header
+    for (auto it = csv.next(); !csv.eof(); it = csv.next()) {
+        if (it.size() < 7) {
+            continue;
+        }
+        ApiStats s;
+        s.count = boost::lexical_cast<size_t>(it[1]);
+        s.nb_errors = boost::lexical_cast<size_t>(it[2]);
+        s.p50 = boost::lexical_cast<double>(it[3]);
+        s.p90 = boost::lexical_cast<double>(it[4]);
+        s.p99 = boost::lexical_cast<double>(it[5]);
+        s.max = boost::lexical_cast<double>(it[6]);
+        baseline[it[0]] = s;
+    }
+    return baseline;
+}
+
+// return the number of regressions found
+size_t compare_with_baseline(const std::map<std::string, ApiStats>& stats,
+                             const std::map<std::string, ApiStats>& baseline,
+                             double tolerance) {
+    size_t nb_regressions = 0;
+    auto check = [&](const std::string& api, const std::string& name, double value, double reference) {
+        if (value > reference * (1. + tolerance / 100.)) {
+            std::cout << "REGRESSION " << api << " " << name << ": " << value << "ms (baseline " << reference
+                      << "ms)" << std::endl;
+            ++nb_regressions;
+        }
+    };
+    for (const auto& api_stats : stats) {
+        auto it = baseline.find(api_stats.first);
+        if (it == baseline.end()) {
+            std::cout << "no baseline for " << api_stats.first << std::endl;
+            continue;
+        }
+        check(api_stats.first, "p50", api_stats.second.p50, it->second.p50);
+        check(api_stats.first, "p90", api_stats.second.p90, it->second.p90);
+        check(api_stats.first, "p99", api_stats.second.p99, it->second.p99);
+    }
+    return nb_regressions;
+}
+
+/*
+ * The configuration of the workers of the benchmark: the defaults of kraken, without the cache of the
+ * graphical isochrones, so that a repeated isochrone is computed again and not looked up
+ */
+kraken::Configuration worker_configuration() {
+    kraken::Configuration conf;
+    const char* argv[] = {"benchmark", "--GENERAL.isochrone_cache_size=0"};
+    conf.load_from_command_line(kraken::get_options_description(std::string("benchmark"), std::string("")), 2, argv);
+    return conf;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    navitia::init_app();
+    po::options_description desc("Replay benchmark options");
+    std::string data_file, output_file, baseline_file;
+    std::vector<std::string> capture_files;
+    int nb_threads, iterations;
+    double tolerance;
+
+    // clang-format off
+    desc.add_options()
+            ("help", "Show this message.")
+            ("file,f", po::value<std::string>(&data_file)->default_value("data.nav.lz4"),
+                     "Path to data.nav.lz4")
+            ("captures,c", po::value<std::vector<std::string>>(&capture_files)->required(),
+                     "Capture files written by kraken (GENERAL.slow_request_capture_file), can be repeated.")
+            ("threads,t", po::value<int>(&nb_threads)->default_value(1),
+                     "Number of threads replaying the requests, each with its own worker, sharing the same data.")
+            ("iterations,i", po::value<int>(&iterations)->default_value(1),
+                     "Number of times each captured request is replayed.")
+            ("output,o", po::value<std::string>(&output_file),
+                     "Write a csv file with the statistics by api, it can be used as a baseline for a later run.\n"
+                     "Each line contains : api, count, nb errors, p50 (ms), p90 (ms), p99 (ms), max (ms).")
+            ("baseline,b", po::value<std::string>(&baseline_file),
+                     "csv file written by a previous run with --output, the percentiles are compared against it.")
+            ("tolerance", po::value<double>(&tolerance)->default_value(10),
+                     "Accepted slowdown in percent before a percentile is reported as a regression.")
+            ("verbose,v", "Verbose debugging output.");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    if (vm.count("help")) {
+        std::cout << "This is used to replay the requests captured by kraken" << std::endl;
+        std::cout << desc << std::endl;
+        return 1;
+    }
+    po::notify(vm);
+    bool verbose = vm.count("verbose");
+
+    type::Data data;
+    {
+        Timer t("Loading data from : " + data_file);
+        data.load_nav(data_file);
+        data.build_relations();
+        data.build_raptor();
+        data.build_proximity_list();
+    }
+    const auto publication_date = pt::to_iso_string(data.meta->publication_date);
+
+    std::vector<ReplayedRequest> requests;
+    size_t nb_other_data = 0;
+    for (const auto& capture_file : capture_files) {
+        for (const auto& captured : read_captured_requests(capture_file)) {
+            ReplayedRequest r;
+            if (!r.request.ParseFromString(captured.payload)) {
+                std::cout << "invalid protobuf in " << capture_file << ", request ignored" << std::endl;
+                continue;
+            }
+            r.api = pbnavitia::API_Name(r.request.requested_api());
+            if (captured.publication_date != publication_date) {
+                ++nb_other_data;
+            }
+            if (verbose) {
+                std::cout << r.api << ", captured duration: " << captured.duration << "ms" << std::endl;
+            }
+            for (int i = 0; i < iterations; ++i) {
+                requests.push_back(r);
+            }
+        }
+    }
+    if (nb_other_data > 0) {
+        std::cout << "Warning: " << nb_other_data << " requests have been captured on another data than "
+                  << publication_date << ", the results may differ" << std::endl;
+    }
+
+    // disabling logging, to not pollute std::cout
+    auto logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
+    logger.setLogLevel(log4cplus::WARN_LOG_LEVEL);
+    auto logger_raptor = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("raptor"));
+    logger_raptor.setLogLevel(log4cplus::WARN_LOG_LEVEL);
+
+    std::cout << "Replaying " << requests.size() << " requests with " << nb_threads << " thread(s)" << std::endl;
+    std::atomic_size_t next_request{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nb_threads; ++i) {
+        threads.emplace_back([&]() {
+            navitia::Worker w(worker_configuration());
+            for (size_t idx = next_request++; idx < requests.size(); idx = next_request++) {
+                auto& r = requests[idx];
+                auto request_start = std::chrono::steady_clock::now();
+                try {
+                    w.dispatch(r.request, data);
+                    r.has_error = w.pb_creator.get_response().has_error();
+                } catch (const navitia::recoverable_exception&) {
+                    r.has_error = true;
+                }
+                auto request_end = std::chrono::steady_clock::now();
+                r.duration = std::chrono::duration<double, std::milli>(request_end - request_start).count();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double total_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto stats = compute_stats(requests);
+    std::cout << "Total time: " << total_seconds << "s" << std::endl;
+    std::cout << "Throughput: " << requests.size() / total_seconds << " requests/s" << std::endl;
+    std::cout << std::setw(30) << std::left << "api" << std::right << std::setw(8) << "count" << std::setw(8)
+              << "errors" << std::setw(12) << "p50 (ms)" << std::setw(12) << "p90 (ms)" << std::setw(12)
+              << "p99 (ms)" << std::setw(12) << "max (ms)" << std::endl;
+    for (const auto& api_stats : stats) {
+        const auto& s = api_stats.second;
+        std::cout << std::setw(30) << std::left << api_stats.first << std::right << std::setw(8) << s.count
+                  << std::setw(8) << s.nb_errors << std::setw(12) << s.p50 << std::setw(12) << s.p90
+                  << std::setw(12) << s.p99 << std::setw(12) << s.max << std::endl;
+    }
+
+    if (vm.count("output")) {
+        std::fstream out_file(output_file, std::ios::out);
+        out_file << "api,count,nb_errors,p50_ms,p90_ms,p99_ms,max_ms\n";
+        for (const auto& api_stats : stats) {
+            const auto& s = api_stats.second;
+            out_file << api_stats.first << "," << s.count << "," << s.nb_errors << "," << s.p50 << "," << s.p90
+                     << "," << s.p99 << "," << s.max << "\n";
+        }
+        out_file.close();
+    }
+
+    if (vm.count("baseline")) {
+        const auto nb_regressions = compare_with_baseline(stats, read_baseline(baseline_file), tolerance);
+        std::cout << "Number of regressions: " << nb_regressions << std::endl;
+        return nb_regressions == 0 ? 0 : 2;
+    }
+    return 0;
+}
@@ -34,7 +34,9 @@ www.navitia.io
 #include "raptor.h"
 #include "raptor_api.h"
 #include "type/geographical_coord.h"
+#include "type/parallel.h"
 
+#include <cstring>
 #include <vector>
 
 namespace navitia {
@@ -43,6 +45,14 @@ namespace routing {
 const auto source_e = georef::ProjectionData::Direction::Source;
 const auto target_e = georef::ProjectionData::Direction::Target;
 
+constexpr uint32_t HeatMap::UNREACHED;
+
+// The lines of the grid are filled by chunks, taken in turn by the workers
+constexpr size_t LINES_BY_CHUNK = 8;
+// The request already runs on one of the nb_threads workers of kraken, the other ones
+// may be busy: a heat map only borrows a few more threads
+constexpr size_t MAX_HEAT_MAP_WORKERS = 4;
+
 static std::string print_single_coord(const SingleCoord& coord, const std::string& type) {
     std::stringstream ss;
     ss << R"(")"
@@ -60,15 +70,15 @@ static void print_lat(std::stringstream& ss, const SingleCoord lat) {
     ss << "}";
 }
 
-static void print_datetime(std::stringstream& ss, const navitia::time_duration& duration) {
-    if (duration.is_pos_infinity()) {
+static void print_datetime(std::stringstream& ss, const uint32_t duration) {
+    if (duration == HeatMap::UNREACHED) {
         ss << R"(null)";
     } else {
-        ss << duration.total_seconds();
+        ss << duration;
     }
 }
 
-static void print_body(std::stringstream& ss, std::pair<SingleCoord, std::vector<navitia::time_duration>> pair) {
+static void print_body(std::stringstream& ss, const std::pair<SingleCoord, std::vector<uint32_t>>& pair) {
     ss << "{";
     ss << print_single_coord(pair.first, "lon");
     ss << R"(,"duration":[)";
@@ -86,6 +96,39 @@ std::string print_grid(const HeatMap& heat_map) {
     return ss.str();
 }
 
+static void write_uint32(std::string& out, const uint32_t value) {
+    for (size_t byte = 0; byte < sizeof(value); ++byte) {
+        out.push_back(char((value >> (8 * byte)) & 0xFF));
+    }
+}
+
+static void write_double(std::string& out, const double value) {
+    static_assert(sizeof(double) == sizeof(uint64_t), "doubles are expected on 64 bits");
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (size_t byte = 0; byte < sizeof(bits); ++byte) {
+        out.push_back(char((bits >> (8 * byte)) & 0xFF));
+    }
+}
+
+std::string print_binary_grid(const HeatMap& heat_map) {
+    std::string out;
+    out.reserve(2 * sizeof(uint32_t) + 4 * sizeof(double)
+                + heat_map.body.size() * heat_map.header.size() * sizeof(uint32_t));
+    write_uint32(out, uint32_t(heat_map.body.size()));
+    write_uint32(out, uint32_t(heat_map.header.size()));
+    write_double(out, heat_map.body.empty() ? 0. : heat_map.body.front().first.min_coord);
+    write_double(out, heat_map.body.empty() ? 0. : heat_map.body.front().first.step);
+    write_double(out, heat_map.header.empty() ? 0. : heat_map.header.front().min_coord);
+    write_double(out, heat_map.header.empty() ? 0. : heat_map.header.front().step);
+    for (const auto& line : heat_map.body) {
+        for (const auto duration : line.second) {
+            write_uint32(out, duration);
+        }
+    }
+    return out;
+}
+
 static std::pair<int, int> find_rank(const BoundBox& box,
                                      const type::GeographicalCoord& coord,
                                      const double height_step,
@@ -132,14 +175,23 @@ static Boundary find_boundary(const std::pair<int, int>& rank_source,
     return {end_lon_box, end_lat_box, begin_lon_box, begin_lat_box};
 }
 
-static std::vector<std::vector<Projection>> find_projection(BoundBox box,
-                                                            const double height_step,
-                                                            const double width_step,
-                                                            const georef::GeoRef& worker,
-                                                            const double min_dist,
-                                                            const HeatMap& heat_map,
-                                                            const size_t step) {
-    std::vector<std::vector<Projection>> dist_pixel = {step, {step, Projection()}};
+// A street segment with the cells close enough to be projected on it
+struct Segment {
+    georef::vertex_t source;
+    georef::vertex_t target;
+    Boundary boundary;
+    Segment(georef::vertex_t source, georef::vertex_t target, const Boundary& boundary)
+        : source(source), target(target), boundary(boundary) {}
+};
+
+static std::vector<Segment> find_segments(const BoundBox& box,
+                                          const double height_step,
+                                          const double width_step,
+                                          const georef::GeoRef& worker,
+                                          const double min_dist,
+                                          const size_t step,
+                                          double& coslat) {
+    std::vector<Segment> segments;
     const size_t offset_lon = floor(min_dist / (width_step * N_DEG_TO_DISTANCE)) + 1;
     const size_t offset_lat = floor(min_dist / (height_step * N_DEG_TO_DISTANCE)) + 1;
 
@@ -150,10 +202,10 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
     auto objects_inside = worker.pl_walking.find_within(box_center, radius);
 
     if (objects_inside.empty()) {
-        return {};
+        return segments;
     }
 
-    const auto coslat = cos(objects_inside.front().second.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+    coslat = cos(objects_inside.front().second.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
     for (const auto& o : objects_inside) {
         const auto element = o.first;
         const auto& source = o.second;
@@ -164,27 +216,48 @@ static std::vector<std::vector<Projection>> find_projection(BoundBox box,
         const auto rank_source = find_rank(box, source, height_step, width_step);
         BOOST_FOREACH (const georef::edge_t& e, boost::out_edges(element, worker.graph)) {
             const auto v = target(e, worker.graph);
-            const auto& target = worker.graph[v].coord;
-            const auto rank_target = find_rank(box, target, height_step, width_step);
-            const auto boundary = find_boundary(rank_source, rank_target, offset_lon, offset_lat, step);
-            for (uint lon_rank = boundary.min_lon; lon_rank <= boundary.max_lon; lon_rank++) {
-                for (uint lat_rank = boundary.min_lat; lat_rank <= boundary.max_lat; lat_rank++) {
-                    auto center = type::GeographicalCoord(heat_map.body[lon_rank].first.min_coord + width_step / 2,
-                                                          heat_map.header[lat_rank].min_coord + height_step / 2);
-                    auto proj = center.approx_project(source, target, coslat);
-                    auto length = double(proj.second);
-                    if (length < min_dist
-                        && (!dist_pixel[lon_rank][lat_rank].distance
-                            || length < *dist_pixel[lon_rank][lat_rank].distance)) {
-                        dist_pixel[lon_rank][lat_rank].distance = length;
-                        dist_pixel[lon_rank][lat_rank].source = element;
-                        dist_pixel[lon_rank][lat_rank].target = v;
-                    }
+            const auto rank_target = find_rank(box, worker.graph[v].coord, height_step, width_step);
+            segments.emplace_back(element, v, find_boundary(rank_source, rank_target, offset_lon, offset_lat, step));
+        }
+    }
+    return segments;
+}
+
+// Project the centers of the cells of the lines [begin_lon, end_lon) on the nearest segment
+static void find_projection(const std::vector<Segment>& segments,
+                            const size_t begin_lon,
+                            const size_t end_lon,
+                            const double height_step,
+                            const double width_step,
+                            const georef::GeoRef& worker,
+                            const double min_dist,
+                            const double coslat,
+                            const HeatMap& heat_map,
+                            std::vector<std::vector<Projection>>& dist_pixel) {
+    for (const auto& segment : segments) {
+        const auto& boundary = segment.boundary;
+        if (boundary.max_lon < begin_lon || boundary.min_lon >= end_lon) {
+            continue;
+        }
+        const auto& source = worker.graph[segment.source].coord;
+        const auto& target = worker.graph[segment.target].coord;
+        const size_t min_lon = std::max(boundary.min_lon, begin_lon);
+        const size_t max_lon = std::min(boundary.max_lon, end_lon - 1);
+        for (size_t lon_rank = min_lon; lon_rank <= max_lon; lon_rank++) {
+            for (size_t lat_rank = boundary.min_lat; lat_rank <= boundary.max_lat; lat_rank++) {
+                auto center = type::GeographicalCoord(heat_map.body[lon_rank].first.min_coord + width_step / 2,
+                                                      heat_map.header[lat_rank].min_coord + height_step / 2);
+                auto proj = center.approx_project(source, target, coslat);
+                auto length = double(proj.second);
+                auto& pixel = dist_pixel[lon_rank][lat_rank];
+                if (length < min_dist && (!pixel.distance || length < *pixel.distance)) {
+                    pixel.distance = length;
+                    pixel.source = segment.source;
+                    pixel.target = segment.target;
                 }
             }
         }
     }
-    return dist_pixel;
 }
 
 HeatMap fill_heat_map(const BoundBox& box,
@@ -197,33 +270,42 @@ HeatMap fill_heat_map(const BoundBox& box,
                       const std::vector<navitia::time_duration>& distances,
                       const size_t step) {
     auto heat_map = HeatMap(step, box, height_step, width_step);
-    auto projection = find_projection(box, height_step, width_step, worker, min_dist, heat_map, step);
-    for (size_t i = 0; i < step; i++) {
-        for (size_t j = 0; j < step; j++) {
-            auto& duration = heat_map.body[i].second[j];
-            if (projection[i][j].distance) {
+    double coslat = 1;
+    const auto segments = find_segments(box, height_step, width_step, worker, min_dist, step, coslat);
+    if (segments.empty()) {
+        return heat_map;
+    }
+    std::vector<std::vector<Projection>> projection(step, std::vector<Projection>(step));
+
+    auto fill_lines = [&](const size_t begin_lon, const size_t end_lon) {
+        find_projection(segments, begin_lon, end_lon, height_step, width_step, worker, min_dist, coslat, heat_map,
+                        projection);
+        for (size_t i = begin_lon; i < end_lon; i++) {
+            for (size_t j = 0; j < step; j++) {
+                if (!projection[i][j].distance) {
+                    continue;
+                }
                 auto center = type::GeographicalCoord(heat_map.body[i].first.min_coord + width_step / 2,
                                                       heat_map.header[j].min_coord + height_step / 2);
                 const auto source = worker.graph[projection[i][j].source].coord;
                 const auto target = worker.graph[projection[i][j].target].coord;
-                const auto coslat = cos(center.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+                const auto center_coslat = cos(center.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
                 const auto duration_to_source =
                     distances[projection[i][j].source]
-                    + navitia::milliseconds(sqrt(center.approx_sqr_distance(source, coslat)) / speed * 1e3);
+                    + navitia::milliseconds(sqrt(center.approx_sqr_distance(source, center_coslat)) / speed * 1e3);
                 const auto duration_to_target =
                     distances[projection[i][j].target]
-                    + navitia::milliseconds(sqrt(center.approx_sqr_distance(target, coslat)) / speed * 1e3);
+                    + navitia::milliseconds(sqrt(center.approx_sqr_distance(target, center_coslat)) / speed * 1e3);
                 const auto& new_duration = std::min(duration_to_source, duration_to_target);
                 if (new_duration.total_seconds() < max_duration) {
-                    duration = new_duration;
-                } else {
-                    duration = bt::pos_infin;
+                    heat_map.body[i].second[j] = uint32_t(new_duration.total_seconds());
                 }
-            } else {
-                duration = bt::pos_infin;
             }
         }
-    }
+    };
+
+    // the workers fill distinct lines, they share the segments and the street network read only
+    parallel_for_chunks(step, LINES_BY_CHUNK, MAX_HEAT_MAP_WORKERS, fill_lines);
     return heat_map;
 }
 
@@ -363,7 +445,8 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
     auto start = init_points.begin();
     auto end = init_points.end();
     float speed_factor = float(speed) / georef::default_speed[mode];
-    auto visitor = georef::dijkstra_distance_visitor(navitia::seconds(duration), distances);
+    auto visitor = georef::distance_visitor<boost::dijkstra_visitor<>, std::vector<navitia::time_duration>>(
+        navitia::seconds(duration), distances);
     auto index_map = boost::identity_property_map();
     using filtered_graph = boost::filtered_graph<georef::Graph, boost::keep_all, georef::TransportationModeFilter>;
     try {
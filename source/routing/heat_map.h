@@ -30,6 +30,8 @@ www.navitia.io
 
 #pragma once
 
+#include <cstdint>
+#include <limits>
 #include <utility>
 
 #include "isochrone.h"
@@ -71,28 +73,28 @@ struct BoundBox {
         this->min = type::GeographicalCoord(lon_min, lat_min);
     }
 
-    bool contains(const type::GeographicalCoord& coord) {
+    bool contains(const type::GeographicalCoord& coord) const {
         return this->max.lon() >= coord.lon() && this->max.lat() >= coord.lat() && this->min.lon() <= coord.lon()
                && this->min.lat() <= coord.lat();
     }
 };
 
 struct HeatMap {
+    // The durations of the cells are in seconds, the cells out of reach are UNREACHED
+    constexpr static uint32_t UNREACHED = std::numeric_limits<uint32_t>::max();
+
     std::vector<SingleCoord> header;
-    std::vector<std::pair<SingleCoord, std::vector<navitia::time_duration>>> body;
-    HeatMap(std::vector<SingleCoord> header,
-            std::vector<std::pair<SingleCoord, std::vector<navitia::time_duration>>> body)
+    std::vector<std::pair<SingleCoord, std::vector<uint32_t>>> body;
+    HeatMap(std::vector<SingleCoord> header, std::vector<std::pair<SingleCoord, std::vector<uint32_t>>> body)
         : header(std::move(header)), body(std::move(body)) {}
 
     HeatMap(const uint step, const BoundBox& box, const double height_step, const double width_step) {
+        for (uint j = 0; j < step; j++) {
+            header.emplace_back((box.min.lat() + j * height_step), height_step);
+        }
         for (uint i = 0; i < step; i++) {
             auto lon = SingleCoord(box.min.lon() + i * width_step, width_step);
-            for (uint j = 0; j < step; j++) {
-                if (i == 0) {
-                    header.emplace_back((box.min.lat() + j * height_step), height_step);
-                }
-            }
-            body.push_back({lon, std::vector<navitia::time_duration>{step, bt::pos_infin}});
+            body.emplace_back(lon, std::vector<uint32_t>(step, UNREACHED));
         }
     }
 };
@@ -122,6 +124,14 @@ HeatMap fill_heat_map(const BoundBox& box,
 
 std::string print_grid(const HeatMap& heat_map);
 
+/*
+ * The grid in a compact binary form, all the numbers being little endian:
+ *  - the number of lines (longitudes) and of columns (latitudes), as uint32
+ *  - the min longitude, the longitude step, the min latitude and the latitude step, as IEEE 754 doubles
+ *  - the durations line by line, as uint32, UNREACHED for the cells out of reach
+ */
+std::string print_binary_grid(const HeatMap& heat_map);
+
 std::string build_raster_isochrone(const georef::GeoRef& worker,
                                    const double& speed,
                                    const type::Mode_e& mode,
@@ -41,10 +41,15 @@ www.navitia.io
 #include <boost/range/algorithm.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <set>
 #include <string>
+#include <tuple>
 #include <vector>
 
 namespace navitia {
@@ -52,6 +57,9 @@ namespace routing {
 
 IsochroneException::~IsochroneException() noexcept = default;
 
+constexpr static double N_DEG_TO_DISTANCE =
+    type::GeographicalCoord::N_DEG_TO_RAD * type::GeographicalCoord::EARTH_RADIUS_IN_METERS;
+
 type::GeographicalCoord project_in_direction(const type::GeographicalCoord& center,
                                              const double& direction,
                                              const double& radius) {
@@ -139,64 +147,30 @@ type::Polygon circle(const type::GeographicalCoord& center, const double& radius
     return points;
 }
 
-static type::MultiPolygon merge_poly(const type::MultiPolygon& multi_poly, const type::Polygon& poly) {
-    type::MultiPolygon poly_union;
-    try {
-        boost::geometry::union_(poly, multi_poly, poly_union);
-    } catch (const boost::geometry::exception& e) {
-        // We don't merge the polygons
-        log4cplus::Logger logger = log4cplus::Logger::getInstance("logger");
-        LOG4CPLUS_WARN(logger, "impossible to merge polygon: " << e.what());
-    }
-    return poly_union;
-}
-
-struct InfoCircle {
-    type::GeographicalCoord center;
-    int duration_left;
-    InfoCircle(const type::GeographicalCoord& center, const int& duration_left)
-        : center(center), duration_left(duration_left) {}
-};
-
-static bool within_info_circle(const InfoCircle& circle,
-                               const std::vector<InfoCircle>& multi_poly,
-                               const double speed) {
-    auto begin = multi_poly.begin();
-    const auto end = multi_poly.end();
-    double circle_radius = circle.duration_left * speed;
-    double coslat = cos(circle.center.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
-    return any_of(begin, end, [&](const InfoCircle& it) {
-        double it_radius = it.duration_left * speed;
-        return sqrt(circle.center.approx_sqr_distance(it.center, coslat)) + circle_radius < it_radius;
-    });
-}
-
-static std::vector<InfoCircle> delete_useless_circle(std::vector<InfoCircle> circles, const double speed) {
-    std::vector<InfoCircle> useful_circles;
-    boost::sort(circles, [](const InfoCircle& a, const InfoCircle& b) { return a.duration_left > b.duration_left; });
-    for (auto& circle : circles) {
-        if (!within_info_circle(circle, useful_circles, speed)) {
-            useful_circles.push_back(circle);
-        }
-    }
-    return useful_circles;
-}
-
 DateTime build_bound(const bool clockwise, const DateTime duration, const DateTime init_dt) {
     return clockwise ? init_dt + duration : init_dt - duration;
 }
 
-type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
-                                          const std::vector<type::StopPoint*>& stop_points,
-                                          const bool clockwise,
-                                          const type::GeographicalCoord& coord_origin,
-                                          const DateTime& bound,
-                                          const map_stop_point_duration& origin,
-                                          const double& speed,
-                                          const int& duration) {
-    std::vector<InfoCircle> circles_classed;
-    type::MultiPolygon circles;
-    circles_classed.emplace_back(coord_origin, duration);
+// a center from which we walk, reached after duration seconds
+struct IsochroneCenter {
+    type::GeographicalCoord coord;
+    double coslat;
+    double duration;
+    IsochroneCenter(const type::GeographicalCoord& coord, const double duration)
+        : coord(coord), coslat(cos(coord.lat() * type::GeographicalCoord::N_DEG_TO_RAD)), duration(duration) {}
+};
+
+// The origin and the stop points reached before the bound, with at least MIN_RADIUS to walk
+static std::vector<IsochroneCenter> find_centers(const RAPTOR& raptor,
+                                                 const std::vector<type::StopPoint*>& stop_points,
+                                                 const bool clockwise,
+                                                 const type::GeographicalCoord& coord_origin,
+                                                 const DateTime& bound,
+                                                 const map_stop_point_duration& origin,
+                                                 const double& speed,
+                                                 const int& duration) {
+    std::vector<IsochroneCenter> centers;
+    centers.emplace_back(coord_origin, 0);
     const auto& data_departure = raptor.data.pt_data->stop_points;
     for (const auto& it : origin) {
         if (it.second.total_seconds() < duration) {
@@ -204,8 +178,7 @@ type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
             if (duration_left * speed < MIN_RADIUS) {
                 continue;
             }
-            const auto& center = data_departure[it.first.val]->coord;
-            circles_classed.emplace_back(center, duration_left);
+            centers.emplace_back(data_departure[it.first.val]->coord, duration - duration_left);
         }
     }
     for (const type::StopPoint* sp : stop_points) {
@@ -216,17 +189,318 @@ type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
             if (duration_left * speed < MIN_RADIUS) {
                 continue;
             }
-            const auto& center = sp->coord;
-            circles_classed.emplace_back(center, duration_left);
+            centers.emplace_back(sp->coord, duration - int(duration_left));
+        }
+    }
+    return centers;
+}
+
+/*
+ * Walking duration from the nearest center on the nodes of a grid
+ *
+ * The grid is aligned on the origin, with square cells walked in RASTER_CELL_DURATION,
+ * so that the same points give the same contours whatever the max duration. Only when
+ * the centers spread over more than RASTER_MAX_NODES nodes are the cells doubled until
+ * the grid fits, and the contours are then coarser.
+ * The durations are propagated from the nodes around the centers, like a Dijkstra on
+ * the 8 neighbours, each node keeping the center it is reached from: the duration of a
+ * node is computed from the distance to its center, not summed along the grid.
+ */
+class IsochroneRaster {
+public:
+    IsochroneRaster(const type::GeographicalCoord& coord_origin,
+                    std::vector<IsochroneCenter> centers_,
+                    const double speed,
+                    const double max_duration)
+        : centers(std::move(centers_)), speed(speed), origin(coord_origin) {
+        double min_lon = origin.lon(), max_lon = origin.lon();
+        double min_lat = origin.lat(), max_lat = origin.lat();
+        for (const auto& center : centers) {
+            const double radius = (max_duration - center.duration) * speed / N_DEG_TO_DISTANCE;
+            min_lon = std::min(min_lon, center.coord.lon() - radius / center.coslat);
+            max_lon = std::max(max_lon, center.coord.lon() + radius / center.coslat);
+            min_lat = std::min(min_lat, center.coord.lat() - radius);
+            max_lat = std::max(max_lat, center.coord.lat() + radius);
+        }
+
+        const double origin_coslat = cos(origin.lat() * type::GeographicalCoord::N_DEG_TO_RAD);
+        double cell_size = speed * RASTER_CELL_DURATION;
+        do {
+            cell_lat = cell_size / N_DEG_TO_DISTANCE;
+            cell_lon = cell_lat / origin_coslat;
+            // one more node on each side, so that the border is out of the isochrone
+            first_lon = int64_t(floor((min_lon - origin.lon()) / cell_lon)) - 1;
+            first_lat = int64_t(floor((min_lat - origin.lat()) / cell_lat)) - 1;
+            nb_lon = size_t(int64_t(ceil((max_lon - origin.lon()) / cell_lon)) + 1 - first_lon + 1);
+            nb_lat = size_t(int64_t(ceil((max_lat - origin.lat()) / cell_lat)) + 1 - first_lat + 1);
+            cell_size *= 2;
+        } while (nb_lon * nb_lat > RASTER_MAX_NODES);
+
+        durations.assign(nb_lon * nb_lat, std::numeric_limits<double>::infinity());
+        owners.assign(nb_lon * nb_lat, no_owner);
+        propagate(max_duration);
+    }
+
+    // The contour of the nodes reached within the duration
+    type::MultiPolygon contour(const double duration) const;
+
+private:
+    using Node = std::pair<size_t, size_t>;
+
+    // owner of the nodes not reached, the centers being indexed from 0
+    static constexpr uint32_t no_owner = std::numeric_limits<uint32_t>::max();
+
+    size_t index(const Node& node) const { return node.second * nb_lon + node.first; }
+
+    type::GeographicalCoord coord(const Node& node) const {
+        return {origin.lon() + double(first_lon + int64_t(node.first)) * cell_lon,
+                origin.lat() + double(first_lat + int64_t(node.second)) * cell_lat};
+    }
+
+    double distance(const type::GeographicalCoord& coord, const IsochroneCenter& center) const {
+        const double dx = (coord.lon() - center.coord.lon()) * center.coslat;
+        const double dy = coord.lat() - center.coord.lat();
+        return sqrt(dx * dx + dy * dy) * N_DEG_TO_DISTANCE;
+    }
+
+    bool is_reached(const Node& node, const double duration) const { return durations[index(node)] <= duration; }
+
+    void propagate(const double max_duration);
+
+    // Point of the contour on the edge between the two nodes, one of them being reached
+    type::GeographicalCoord crossing(const Node& a, const Node& b, const double duration) const;
+
+    std::vector<IsochroneCenter> centers;
+    double speed;
+    type::GeographicalCoord origin;
+    double cell_lon = 0;
+    double cell_lat = 0;
+    int64_t first_lon = 0;
+    int64_t first_lat = 0;
+    size_t nb_lon = 0;
+    size_t nb_lat = 0;
+    std::vector<double> durations;
+    std::vector<uint32_t> owners;
+};
+
+constexpr uint32_t IsochroneRaster::no_owner;
+
+void IsochroneRaster::propagate(const double max_duration) {
+    // bucket queue on the durations in seconds, the propagation does not need a finer order
+    std::vector<std::vector<uint32_t>> buckets(size_t(max_duration) + 1);
+    size_t current = 0;
+
+    auto update = [&](const Node& node, const uint32_t owner) {
+        const auto& center = centers[owner];
+        const double duration = center.duration + distance(coord(node), center) / speed;
+        const size_t idx = index(node);
+        if (duration <= max_duration && duration < durations[idx]) {
+            durations[idx] = duration;
+            owners[idx] = owner;
+            buckets[std::max(current, size_t(duration))].push_back(uint32_t(idx));
+        }
+    };
+
+    // the nodes of the cell of each center
+    for (uint32_t owner = 0; owner < centers.size(); ++owner) {
+        const auto& center = centers[owner];
+        const auto lon = size_t(int64_t(floor((center.coord.lon() - origin.lon()) / cell_lon)) - first_lon);
+        const auto lat = size_t(int64_t(floor((center.coord.lat() - origin.lat()) / cell_lat)) - first_lat);
+        for (size_t dlon = 0; dlon <= 1; ++dlon) {
+            for (size_t dlat = 0; dlat <= 1; ++dlat) {
+                update({lon + dlon, lat + dlat}, owner);
+            }
+        }
+    }
+
+    for (current = 0; current < buckets.size(); ++current) {
+        while (!buckets[current].empty()) {
+            const size_t idx = buckets[current].back();
+            buckets[current].pop_back();
+            const size_t lon = idx % nb_lon;
+            const size_t lat = idx / nb_lon;
+            // the border nodes are never reached, the neighbours are in the grid
+            if (lon == 0 || lat == 0 || lon + 1 == nb_lon || lat + 1 == nb_lat) {
+                continue;
+            }
+            const uint32_t owner = owners[idx];
+            for (size_t neighbour_lon = lon - 1; neighbour_lon <= lon + 1; ++neighbour_lon) {
+                for (size_t neighbour_lat = lat - 1; neighbour_lat <= lat + 1; ++neighbour_lat) {
+                    if (owners[index({neighbour_lon, neighbour_lat})] != owner) {
+                        update({neighbour_lon, neighbour_lat}, owner);
+                    }
+                }
+            }
+        }
+    }
+}
+
+type::GeographicalCoord IsochroneRaster::crossing(const Node& a, const Node& b, const double duration) const {
+    const bool a_reached = is_reached(a, duration);
+    const auto from = coord(a_reached ? a : b);
+    const auto to = coord(a_reached ? b : a);
+
+    // the contour leaves the circle of the reached node, or the circle of a reached node
+    // around the edge overlapping it
+    std::vector<Node> around = {a_reached ? a : b};
+    const bool vertical = a.first == b.first;
+    for (const int side : {-1, 1}) {
+        if (vertical && (a.first > 0 || side > 0) && a.first + side < nb_lon) {
+            around.emplace_back(a.first + side, a.second);
+            around.emplace_back(b.first + side, b.second);
+        } else if (!vertical && (a.second > 0 || side > 0) && a.second + side < nb_lat) {
+            around.emplace_back(a.first, a.second + side);
+            around.emplace_back(b.first, b.second + side);
+        }
+    }
+    double ratio = 0;
+    for (bool extended = true; extended;) {
+        extended = false;
+        for (const auto& node : around) {
+            if (!is_reached(node, duration)) {
+                continue;
+            }
+            // intersection of the segment from -> to with the circle of the center of the node
+            const auto& center = centers[owners[index(node)]];
+            const double radius = (duration - center.duration) * speed / N_DEG_TO_DISTANCE;
+            const double px = (from.lon() - center.coord.lon()) * center.coslat;
+            const double py = from.lat() - center.coord.lat();
+            const double vx = (to.lon() - from.lon()) * center.coslat;
+            const double vy = to.lat() - from.lat();
+            const double qa = vx * vx + vy * vy;
+            const double qb = px * vx + py * vy;
+            const double qc = px * px + py * py - radius * radius;
+            const double discriminant = qb * qb - qa * qc;
+            if (discriminant < 0) {
+                continue;
+            }
+            const double enter = (-qb - sqrt(discriminant)) / qa;
+            const double leave = (-qb + sqrt(discriminant)) / qa;
+            if (enter <= ratio && leave > ratio) {
+                ratio = leave;
+                extended = true;
+            }
+        }
+    }
+    ratio = std::min(ratio, 1.);
+    return {from.lon() + ratio * (to.lon() - from.lon()), from.lat() + ratio * (to.lat() - from.lat())};
+}
+
+type::MultiPolygon IsochroneRaster::contour(const double duration) const {
+    // The contour goes clockwise around the reached nodes. In a cell, it enters through
+    // an edge going from an unreached to a reached corner, counterclockwise, and leaves
+    // through the next edge going from a reached to an unreached corner.
+    // The edges are identified by the position of their first node from the origin and their
+    // direction, so that the rings start at the same edge whatever the extent of the grid.
+    using EdgeId = std::tuple<int64_t, int64_t, bool>;
+    auto edge_id = [&](const Node& node, bool vertical) {
+        return EdgeId(first_lat + int64_t(node.second), first_lon + int64_t(node.first), vertical);
+    };
+    std::map<EdgeId, EdgeId> next_edge;
+    for (size_t lon = 0; lon + 1 < nb_lon; ++lon) {
+        for (size_t lat = 0; lat + 1 < nb_lat; ++lat) {
+            // corners and edges counterclockwise, edge k going from corner k to corner k + 1
+            const std::array<Node, 4> corners = {
+                {{lon, lat}, {lon + 1, lat}, {lon + 1, lat + 1}, {lon, lat + 1}}};
+            const std::array<EdgeId, 4> edges = {{edge_id(corners[0], false), edge_id(corners[1], true),
+                                                  edge_id(corners[3], false), edge_id(corners[0], true)}};
+            std::array<bool, 4> reached;
+            size_t nb_reached = 0;
+            for (size_t k = 0; k < 4; ++k) {
+                reached[k] = is_reached(corners[k], duration);
+                nb_reached += reached[k] ? 1 : 0;
+            }
+            if (nb_reached == 0 || nb_reached == 4) {
+                continue;
+            }
+            // on a saddle, the reached corners are linked if the middle of the cell is reached by one of them
+            bool linked = false;
+            if (nb_reached == 2 && reached[0] == reached[2]) {
+                const type::GeographicalCoord middle(coord(corners[0]).lon() + cell_lon / 2,
+                                                     coord(corners[0]).lat() + cell_lat / 2);
+                for (size_t k = 0; k < 4; ++k) {
+                    const auto& center = centers[owners[index(corners[k])]];
+                    linked = linked
+                             || (reached[k] && distance(middle, center) <= (duration - center.duration) * speed);
+                }
+            }
+            for (size_t k = 0; k < 4; ++k) {
+                if (reached[k] || !reached[(k + 1) % 4]) {
+                    continue;
+                }
+                size_t exit = (k + 1) % 4;
+                if (linked) {
+                    exit = (k + 3) % 4;
+                } else {
+                    while (!reached[exit] || reached[(exit + 1) % 4]) {
+                        exit = (exit + 1) % 4;
+                    }
+                }
+                next_edge[edges[k]] = edges[exit];
+            }
+        }
+    }
+
+    auto edge_point = [&](const EdgeId& edge) {
+        const Node a = {size_t(std::get<1>(edge) - first_lon), size_t(std::get<0>(edge) - first_lat)};
+        const Node b = std::get<2>(edge) ? Node{a.first, a.second + 1} : Node{a.first + 1, a.second};
+        return crossing(a, b, duration);
+    };
+
+    const double tolerance = RASTER_SIMPLIFY_TOLERANCE / N_DEG_TO_DISTANCE;
+    std::vector<type::Polygon> outers;
+    std::vector<type::Polygon::ring_type> holes;
+    while (!next_edge.empty()) {
+        type::Polygon::ring_type ring;
+        const EdgeId first = next_edge.begin()->first;
+        auto it = next_edge.begin();
+        while (it != next_edge.end()) {
+            ring.push_back(edge_point(it->first));
+            const EdgeId next = it->second;
+            next_edge.erase(it);
+            it = next_edge.find(next);
+        }
+        ring.push_back(edge_point(first));
+        type::Polygon::ring_type simplified;
+        boost::geometry::simplify(ring, simplified, tolerance);
+        if (simplified.size() < 4) {
+            continue;
+        }
+        if (boost::geometry::area(simplified) > 0) {
+            outers.emplace_back();
+            outers.back().outer() = std::move(simplified);
+        } else {
+            holes.push_back(std::move(simplified));
         }
     }
-    std::vector<InfoCircle> circles_check = delete_useless_circle(std::move(circles_classed), speed);
 
-    for (const auto& c : circles_check) {
-        type::Polygon circle_to_add = circle(c.center, c.duration_left * speed);
-        circles = merge_poly(circles, circle_to_add);
+    // a hole belongs to the smallest outer ring around it
+    boost::sort(outers, [](const type::Polygon& a, const type::Polygon& b) {
+        return boost::geometry::area(a) < boost::geometry::area(b);
+    });
+    for (auto& hole : holes) {
+        const auto outer = boost::find_if(
+            outers, [&](const type::Polygon& poly) { return boost::geometry::within(hole.front(), poly.outer()); });
+        if (outer != outers.end()) {
+            outer->inners().push_back(std::move(hole));
+        }
     }
-    return circles;
+    type::MultiPolygon result;
+    std::move(outers.begin(), outers.end(), std::back_inserter(result));
+    return result;
+}
+
+type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
+                                          const std::vector<type::StopPoint*>& stop_points,
+                                          const bool clockwise,
+                                          const type::GeographicalCoord& coord_origin,
+                                          const DateTime& bound,
+                                          const map_stop_point_duration& origin,
+                                          const double& speed,
+                                          const int& duration) {
+    auto centers = find_centers(raptor, stop_points, clockwise, coord_origin, bound, origin, speed, duration);
+    const IsochroneRaster raster(coord_origin, std::move(centers), speed, duration);
+    return raster.contour(duration);
 }
 
 std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
@@ -238,15 +512,15 @@ std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
                                         const DateTime init_dt) {
     std::vector<Isochrone> isochrone;
     if (!boundary_duration.empty()) {
-        type::MultiPolygon max_isochrone = build_single_isochrone(
-            raptor, raptor.data.pt_data->stop_points, clockwise, coord_origin,
-            build_bound(clockwise, boundary_duration[0], init_dt), origin, speed, boundary_duration[0]);
+        auto centers =
+            find_centers(raptor, raptor.data.pt_data->stop_points, clockwise, coord_origin,
+                         build_bound(clockwise, boundary_duration[0], init_dt), origin, speed, boundary_duration[0]);
+        const IsochroneRaster raster(coord_origin, std::move(centers), speed, boundary_duration[0]);
+        type::MultiPolygon max_isochrone = raster.contour(boundary_duration[0]);
         for (size_t i = 1; i < boundary_duration.size(); i++) {
             type::MultiPolygon output;
             if (boundary_duration[i] > 0) {
-                type::MultiPolygon min_isochrone = build_single_isochrone(
-                    raptor, raptor.data.pt_data->stop_points, clockwise, coord_origin,
-                    build_bound(clockwise, boundary_duration[i], init_dt), origin, speed, boundary_duration[i]);
+                type::MultiPolygon min_isochrone = raster.contour(boundary_duration[i]);
                 boost::geometry::difference(max_isochrone, min_isochrone, output);
                 max_isochrone = std::move(min_isochrone);
             } else {
@@ -259,5 +533,47 @@ std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
     return isochrone;
 }
 
+bool IsochroneCacheKey::operator<(const IsochroneCacheKey& other) const {
+    return std::tie(departures, coord_origin, init_dt, boundary_duration, max_transfers, accessibilite_params,
+                    forbidden, allowed, clockwise, rt_level, speed)
+           < std::tie(other.departures, other.coord_origin, other.init_dt, other.boundary_duration,
+                      other.max_transfers, other.accessibilite_params, other.forbidden, other.allowed,
+                      other.clockwise, other.rt_level, other.speed);
+}
+
+IsochroneCache::Isochrones IsochroneCache::find(const IsochroneCacheKey& key) {
+    ++nb_calls;
+    const auto it = index.find(key);
+    if (it == index.end()) {
+        ++nb_cache_miss;
+        return nullptr;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+void IsochroneCache::insert(const IsochroneCacheKey& key, Isochrones isochrones) {
+    if (max_size == 0) {
+        return;
+    }
+    const auto it = index.find(key);
+    if (it != index.end()) {
+        it->second->second = std::move(isochrones);
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    entries.emplace_front(key, std::move(isochrones));
+    index.emplace(key, entries.begin());
+    if (entries.size() > max_size) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+void IsochroneCache::clear() {
+    entries.clear();
+    index.clear();
+}
+
 }  // namespace routing
 }  // namespace navitia
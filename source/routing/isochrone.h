@@ -30,10 +30,15 @@ www.navitia.io
 
 #pragma once
 
+#include "type/accessibility_params.h"
 #include "type/geographical_coord.h"
+#include "type/rt_level.h"
 #include "utils/exception.h"
 #include "raptor.h"
 
+#include <list>
+#include <map>
+#include <memory>
 #include <set>
 
 namespace navitia {
@@ -52,6 +57,15 @@ constexpr static double N_RAD_TO_DEG = 57.295779513;
 // Delete the circles too small to avoid rounding error in meter
 constexpr static double MIN_RADIUS = 5;
 
+// The isochrones are drawn on a grid whose cells are walked in this duration (in seconds)
+constexpr static double RASTER_CELL_DURATION = 30;
+
+// Maximum number of nodes of the grid, the cells are enlarged beyond
+constexpr static size_t RASTER_MAX_NODES = 2048 * 2048;
+
+// Tolerance (in meters) of the simplification of the contours
+constexpr static double RASTER_SIMPLIFY_TOLERANCE = 0.5;
+
 type::GeographicalCoord project_in_direction(const type::GeographicalCoord& center,
                                              const double& direction,
                                              const double& radius);
@@ -66,7 +80,13 @@ bool in_bound(const T& begin, const T& end, bool clockwise) {
 
 DateTime build_bound(const bool clockwise, const DateTime duration, const DateTime init_dt);
 
-// Create a multi polygon with circles around all the stop points in the isochrone
+/*
+ * Create a multi polygon with circles around all the stop points in the isochrone
+ *
+ * The circles are not merged one by one: the walking duration to the nearest center is
+ * propagated on a grid, and the contour of the cells reached within the duration is
+ * extracted with marching squares.
+ */
 type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
                                           const std::vector<type::StopPoint*>& stop_points,
                                           const bool clockwise,
@@ -84,6 +104,7 @@ struct Isochrone {
         : shape(std::move(shape)), min_duration(min_duration), max_duration(max_duration) {}
 };
 
+// The isochrones between each boundary duration, drawn from the same grid
 std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
                                         const bool clockwise,
                                         const type::GeographicalCoord& coord_origin,
@@ -92,5 +113,54 @@ std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
                                         const std::vector<DateTime>& boundary_duration,
                                         const DateTime init_dt);
 
+// Everything a graphical isochrone depends on, the origin being projected on the stop points
+struct IsochroneCacheKey {
+    map_stop_point_duration departures;
+    type::GeographicalCoord coord_origin;
+    DateTime init_dt;
+    std::vector<DateTime> boundary_duration;
+    uint32_t max_transfers;
+    type::AccessibiliteParams accessibilite_params;
+    std::vector<std::string> forbidden;
+    std::vector<std::string> allowed;
+    bool clockwise;
+    type::RTLevel rt_level;
+    double speed;
+
+    bool operator<(const IsochroneCacheKey& other) const;
+};
+
+/*
+ * The graphical isochrones of the last requests of a worker
+ *
+ * The least recently used isochrones are dropped beyond max_size. The cache is not
+ * thread safe, and must be cleared when the data change.
+ */
+class IsochroneCache {
+public:
+    using Isochrones = std::shared_ptr<const std::vector<Isochrone>>;
+
+    explicit IsochroneCache(size_t max_size) : max_size(max_size) {}
+
+    // The isochrones of the key, null if they are not in the cache
+    Isochrones find(const IsochroneCacheKey& key);
+    void insert(const IsochroneCacheKey& key, Isochrones isochrones);
+    void clear();
+
+    size_t size() const { return entries.size(); }
+    size_t get_nb_cache_miss() const { return nb_cache_miss; }
+    size_t get_nb_calls() const { return nb_calls; }
+
+private:
+    using Entries = std::list<std::pair<IsochroneCacheKey, Isochrones>>;
+
+    size_t max_size;
+    size_t nb_cache_miss = 0;
+    size_t nb_calls = 0;
+    // the most recently used first
+    Entries entries;
+    std::map<IsochroneCacheKey, Entries::iterator> index;
+};
+
 }  // namespace routing
 }  // namespace navitia
@@ -505,7 +505,15 @@ std::shared_ptr<const CachedNextStopTime> CachedNextStopTimeManager::load(
     const type::RTLevel rt_level,
     const type::AccessibiliteParams& accessibilite_params) {
     CachedNextStopTimeKey key(DateTimeUtils::date(from), rt_level, accessibilite_params);
+#ifdef __BENCH_WITH_NEXT_ST_CACHE_TIMING__
+    const auto start = std::chrono::steady_clock::now();
+    auto result = lru(key);
+    load_duration_ns +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return result;
+#else
     return lru(key);
+#endif
 }
 
 inline static bool within(u_int32_t val, std::pair<u_int32_t, u_int32_t> bound) {
@@ -45,6 +45,11 @@ www.navitia.io
 #include <boost/optional.hpp>
 #include <boost/dynamic_bitset.hpp>
 
+#ifdef __BENCH_WITH_NEXT_ST_CACHE_TIMING__
+#include <atomic>
+#include <chrono>
+#endif
+
 namespace navitia {
 
 namespace type {
@@ -295,6 +300,11 @@ struct CachedNextStopTimeManager {
     size_t get_nb_cache_miss() const { return lru.get_nb_cache_miss(); }
     void warmup(const CachedNextStopTimeManager& other) { this->lru.warmup(other.lru); }
     size_t get_max_size() const { return lru.get_max_size(); }
+#ifdef __BENCH_WITH_NEXT_ST_CACHE_TIMING__
+    // Cumulated time spent in load(), waiting for the lock of the lru included. Only built for the
+    // benchmarks: it adds a shared atomic to every load()
+    std::chrono::nanoseconds get_load_duration() const { return std::chrono::nanoseconds(load_duration_ns.load()); }
+#endif
 
 private:
     struct CacheCreator {
@@ -306,6 +316,9 @@ private:
     };
 
     ConcurrentLru<CacheCreator> lru;
+#ifdef __BENCH_WITH_NEXT_ST_CACHE_TIMING__
+    std::atomic<uint64_t> load_duration_ns{0};
+#endif
 };
 
 DateTime get_next_stop_time(const StopEvent stop_event,
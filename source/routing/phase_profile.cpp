@@ -0,0 +1,124 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "phase_profile.h"
+
+#include <sstream>
+
+namespace navitia {
+namespace routing {
+
+// profile of the request currently handled by the thread, if any
+static thread_local PhaseProfile* current_profile = nullptr;
+
+const char* phase_name(Phase phase) {
+    switch (phase) {
+        case Phase::entry_points:
+            return "entry_points";
+        case Phase::street_network_init:
+            return "street_network_init";
+        case Phase::fallback:
+            return "fallback";
+        case Phase::direct_path:
+            return "direct_path";
+        case Phase::raptor_first_pass:
+            return "raptor_first_pass";
+        case Phase::raptor_second_pass:
+            return "raptor_second_pass";
+        case Phase::read_solutions:
+            return "read_solutions";
+        case Phase::filtering:
+            return "filtering";
+        case Phase::make_pathes:
+            return "make_pathes";
+        default:
+            return "unknown";
+    }
+}
+
+void PhaseProfile::reset() {
+    durations.fill(clock::duration::zero());
+    nb_spans.fill(0);
+    nb_spans_total = 0;
+}
+
+void PhaseProfile::add(Phase phase, clock::duration duration) {
+    const auto i = static_cast<size_t>(phase);
+    durations[i] += duration;
+    ++nb_spans[i];
+    ++nb_spans_total;
+}
+
+double PhaseProfile::seconds(Phase phase) const {
+    return std::chrono::duration<double>(durations[static_cast<size_t>(phase)]).count();
+}
+
+std::string PhaseProfile::summary() const {
+    std::stringstream ss;
+    bool first = true;
+    for (size_t i = 0; i < nb_phases; ++i) {
+        if (nb_spans[i] == 0) {
+            continue;
+        }
+        if (!first) {
+            ss << ", ";
+        }
+        first = false;
+        ss << phase_name(static_cast<Phase>(i)) << ": "
+           << std::chrono::duration_cast<std::chrono::microseconds>(durations[i]).count() / 1000.0 << "ms";
+        if (nb_spans[i] > 1) {
+            ss << " (x" << nb_spans[i] << ")";
+        }
+    }
+    return ss.str();
+}
+
+PhaseProfileGuard::PhaseProfileGuard(PhaseProfile& profile) : previous(current_profile) {
+    current_profile = &profile;
+}
+
+PhaseProfileGuard::~PhaseProfileGuard() {
+    current_profile = previous;
+}
+
+PhaseSpan::PhaseSpan(Phase phase) : profile(current_profile), phase(phase) {
+    if (profile != nullptr) {
+        start = PhaseProfile::clock::now();
+    }
+}
+
+PhaseSpan::~PhaseSpan() {
+    if (profile != nullptr) {
+        profile->add(phase, PhaseProfile::clock::now() - start);
+    }
+}
+
+}  // namespace routing
+}  // namespace navitia
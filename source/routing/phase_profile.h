@@ -0,0 +1,119 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/utility.hpp>
+
+#include <array>
+#include <chrono>
+#include <string>
+
+namespace navitia {
+namespace routing {
+
+/*
+ * Phases of a journeys request, in the order they are run.
+ *
+ * The spans are not nested: the time spent in read_solutions is not counted
+ * in raptor_second_pass.
+ */
+enum class Phase : size_t {
+    entry_points = 0,
+    street_network_init,
+    fallback,
+    direct_path,
+    raptor_first_pass,
+    raptor_second_pass,
+    read_solutions,
+    filtering,
+    make_pathes,
+    size
+};
+
+const char* phase_name(Phase phase);
+
+/*
+ * Wall time accumulated by each phase during one request.
+ *
+ * A phase can be run several times in a request (e.g. raptor is called in a
+ * loop when min_nb_journeys is given), the durations are summed.
+ */
+class PhaseProfile {
+public:
+    using clock = std::chrono::steady_clock;
+    static constexpr size_t nb_phases = static_cast<size_t>(Phase::size);
+
+    void reset();
+    void add(Phase phase, clock::duration duration);
+
+    bool empty() const { return nb_spans_total == 0; }
+    bool has(Phase phase) const { return nb_spans[static_cast<size_t>(phase)] != 0; }
+    double seconds(Phase phase) const;
+
+    // human readable breakdown, for the logs of the slow requests
+    std::string summary() const;
+
+private:
+    std::array<clock::duration, nb_phases> durations{};
+    std::array<size_t, nb_phases> nb_spans{};
+    size_t nb_spans_total = 0;
+};
+
+/*
+ * Install a profile for the current thread, the spans opened on this thread
+ * will report to it until the guard is destroyed.
+ */
+class PhaseProfileGuard : boost::noncopyable {
+    PhaseProfile* previous;
+
+public:
+    explicit PhaseProfileGuard(PhaseProfile& profile);
+    ~PhaseProfileGuard();
+};
+
+/*
+ * Scoped measure of a phase.
+ *
+ * Costs nearly nothing when no profile is installed on the thread (benchmarks,
+ * tests...), so it can be put in the routing code unconditionally.
+ */
+class PhaseSpan : boost::noncopyable {
+    PhaseProfile* profile;
+    Phase phase;
+    PhaseProfile::clock::time_point start;
+
+public:
+    explicit PhaseSpan(Phase phase);
+    ~PhaseSpan();
+};
+
+}  // namespace routing
+}  // namespace navitia
@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "raptor.h"
 
+#include "phase_profile.h"
 #include "raptor_visitors.h"
 #include "type/meta_data.h"
 
@@ -184,6 +185,10 @@ bool RAPTOR::foot_path(const Visitor& v) {
     return result;
 }
 
+// explicitly instantiated to be callable outside of raptor (for the micro-benchmarks)
+template bool RAPTOR::foot_path<raptor_visitor>(const raptor_visitor&);
+template bool RAPTOR::foot_path<raptor_reverse_visitor>(const raptor_reverse_visitor&);
+
 void RAPTOR::clear(const bool clockwise, const DateTime bound) {
     const int queue_value = clockwise ? std::numeric_limits<int>::max() : -1;
     Q.assign(data.dataRaptor->jp_container.get_jps_values(), queue_value);
@@ -479,8 +484,11 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
     const auto& calc_dep = clockwise ? departures : destinations;
     const auto& calc_dest = clockwise ? destinations : departures;
 
-    first_raptor_loop(calc_dep, departure_datetime, rt_level, bound, max_transfers, accessibilite_params, clockwise,
-                      current_datetime);
+    {
+        PhaseSpan span(Phase::raptor_first_pass);
+        first_raptor_loop(calc_dep, departure_datetime, rt_level, bound, max_transfers, accessibilite_params,
+                          clockwise, current_datetime);
+    }
 
     LOG4CPLUS_TRACE(raptor_logger, "labels after first pass : " << std::endl << print_all_labels());
 
@@ -545,16 +553,21 @@ RAPTOR::Journeys RAPTOR::compute_all_journeys(const map_stop_point_duration& dep
 
         const auto& working_labels = first_pass_labels[start.count];
 
-        clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
-        map_stop_point_duration init_map;
-        init_map[start.sp_idx] = 0_s;
-        best_labels = best_labels_for_snd_pass;
-        const Label& working_label = working_labels[start.sp_idx];
-        init(init_map, working_label.dt_pt, !clockwise, accessibilite_params.properties);
-        boucleRAPTOR(accessibilite_params, !clockwise, rt_level, max_transfers);
-
-        read_solutions(*this, solutions, !clockwise, departure_datetime, departures, destinations, rt_level,
-                       accessibilite_params, arrival_transfer_penalty, start);
+        {
+            PhaseSpan span(Phase::raptor_second_pass);
+            clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
+            map_stop_point_duration init_map;
+            init_map[start.sp_idx] = 0_s;
+            best_labels = best_labels_for_snd_pass;
+            const Label& working_label = working_labels[start.sp_idx];
+            init(init_map, working_label.dt_pt, !clockwise, accessibilite_params.properties);
+            boucleRAPTOR(accessibilite_params, !clockwise, rt_level, max_transfers);
+        }
+        {
+            PhaseSpan span(Phase::read_solutions);
+            read_solutions(*this, solutions, !clockwise, departure_datetime, departures, destinations, rt_level,
+                           accessibilite_params, arrival_transfer_penalty, start);
+        }
 
         LOG4CPLUS_DEBUG(raptor_logger, "end of raptor loop body, nb of solutions : " << solutions.size());
 
@@ -34,6 +34,7 @@ www.navitia.io
 #include "georef/street_network.h"
 #include "heat_map.h"
 #include "isochrone.h"
+#include "phase_profile.h"
 #include "type/datetime.h"
 #include "type/meta_data.h"
 #include "type/pb_converter.h"
@@ -179,15 +180,19 @@ static std::vector<Path> call_raptor(navitia::PbCreator& pb_creator,
 
             LOG4CPLUS_DEBUG(logger, "raptor found " << raptor_journeys.size() << " solutions");
 
-            // Remove direct path
-            filter_direct_path(raptor_journeys);
+            {
+                PhaseSpan span(Phase::filtering);
 
-            // filter joureys that are too late.....with the magic formula...
-            NightBusFilter::Params params{request_date_secs, clockwise, night_bus_filter_max_factor,
-                                          night_bus_filter_base_factor};
-            filter_late_journeys(raptor_journeys, params);
+                // Remove direct path
+                filter_direct_path(raptor_journeys);
 
-            modify_backtracking_journeys(raptor_journeys, departures, destinations, clockwise);
+                // filter joureys that are too late.....with the magic formula...
+                NightBusFilter::Params params{request_date_secs, clockwise, night_bus_filter_max_factor,
+                                              night_bus_filter_base_factor};
+                filter_late_journeys(raptor_journeys, params);
+
+                modify_backtracking_journeys(raptor_journeys, departures, destinations, clockwise);
+            }
 
             LOG4CPLUS_DEBUG(logger, "after filtering late journeys: " << raptor_journeys.size() << " solution(s) left");
 
@@ -215,7 +220,11 @@ static std::vector<Path> call_raptor(navitia::PbCreator& pb_creator,
             pb_creator.set_next_request_date_time(to_posix_timestamp(request_date_secs, raptor.data));
         }
 
-        auto tmp_pathes = raptor.from_journeys_to_path(journeys);
+        std::vector<Path> tmp_pathes;
+        {
+            PhaseSpan span(Phase::make_pathes);
+            tmp_pathes = raptor.from_journeys_to_path(journeys);
+        }
 
         LOG4CPLUS_DEBUG(logger, "raptor made " << tmp_pathes.size() << " Path(es)");
 
@@ -1299,7 +1308,10 @@ void make_pt_response(navitia::PbCreator& pb_creator,
                     night_bus_filter_max_factor, night_bus_filter_base_factor, timeframe_duration, current_datetime);
 
     // Create pb response
-    make_pt_pathes(pb_creator, pathes, depth);
+    {
+        PhaseSpan span(Phase::make_pathes);
+        make_pt_pathes(pb_creator, pathes, depth);
+    }
 
     // Add error field
     if (pb_creator.empty_journeys()) {
@@ -1513,11 +1525,18 @@ void make_response(navitia::PbCreator& pb_creator,
     }
 
     // Initialize street network
-    worker.init(origin, {destination});
+    {
+        PhaseSpan span(Phase::street_network_init);
+        worker.init(origin, {destination});
+    }
 
     // Get stop points for departure and destination
-    const auto departures = get_stop_points(origin, raptor.data, worker, free_radius_from);
-    const auto destinations = get_stop_points(destination, raptor.data, worker, free_radius_to, true);
+    boost::optional<map_stop_point_duration> departures, destinations;
+    {
+        PhaseSpan span(Phase::fallback);
+        departures = get_stop_points(origin, raptor.data, worker, free_radius_from);
+        destinations = get_stop_points(destination, raptor.data, worker, free_radius_to, true);
+    }
 
     // case 1 : departure no exist
     if (!departures) {
@@ -1557,7 +1576,11 @@ void make_response(navitia::PbCreator& pb_creator,
 
     // Compute direct path
     using OptTimeDur = boost::optional<navitia::time_duration>;
-    const auto direct_path = get_direct_path(worker, origin, destination);
+    georef::Path direct_path;
+    {
+        PhaseSpan span(Phase::direct_path);
+        direct_path = get_direct_path(worker, origin, destination);
+    }
     const OptTimeDur direct_path_dur =
         direct_path.path_items.empty() ? OptTimeDur()
                                        : OptTimeDur(direct_path.duration / origin.streetnetwork_params.speed_factor);
@@ -1571,8 +1594,11 @@ void make_response(navitia::PbCreator& pb_creator,
                     night_bus_filter_max_factor, night_bus_filter_base_factor, timeframe_duration, current_datetime);
 
     // Create pb response
-    make_pathes(pb_creator, pathes, worker, direct_path, origin, destination, datetimes, clockwise, free_radius_from,
-                free_radius_to, depth);
+    {
+        PhaseSpan span(Phase::make_pathes);
+        make_pathes(pb_creator, pathes, worker, direct_path, origin, destination, datetimes, clockwise,
+                    free_radius_from, free_radius_to, depth);
+    }
 
     // Add error field
     if (pb_creator.empty_journeys()) {
@@ -1606,17 +1632,13 @@ struct IsochroneCommon {
           datetime(datetime) {}
 };
 
-static const boost::optional<IsochroneCommon> make_isochrone_common(
+// The departures and the bound of an isochrone, before running raptor
+static const boost::optional<IsochroneCommon> prepare_isochrone_common(
     RAPTOR& raptor,
     const type::EntryPoint& center,
     const uint64_t departure_datetime,
     const double max_duration,
-    const uint32_t max_transfers,
-    const type::AccessibiliteParams& accessibilite_params,
-    const std::vector<std::string>& forbidden,
-    const std::vector<std::string>& allowed,
     bool clockwise,
-    const nt::RTLevel rt_level,
     georef::StreetNetwork& worker,
     PbCreator& pb_creator,
     const boost::optional<const type::EntryPoints&>& stop_points) {
@@ -1634,11 +1656,32 @@ static const boost::optional<IsochroneCommon> make_isochrone_common(
     const auto datetime = tmp_datetime.front();
     const auto init_dt = to_datetime(datetime, raptor.data);
     const auto bound = build_bound(clockwise, max_duration, init_dt);
-    raptor.isochrone(*departures, init_dt, bound, max_transfers, accessibilite_params, forbidden, allowed, clockwise,
-                     rt_level);
     return IsochroneCommon(clockwise, center.coordinates, *departures, init_dt, center, bound, datetime);
 }
 
+static const boost::optional<IsochroneCommon> make_isochrone_common(
+    RAPTOR& raptor,
+    const type::EntryPoint& center,
+    const uint64_t departure_datetime,
+    const double max_duration,
+    const uint32_t max_transfers,
+    const type::AccessibiliteParams& accessibilite_params,
+    const std::vector<std::string>& forbidden,
+    const std::vector<std::string>& allowed,
+    bool clockwise,
+    const nt::RTLevel rt_level,
+    georef::StreetNetwork& worker,
+    PbCreator& pb_creator,
+    const boost::optional<const type::EntryPoints&>& stop_points) {
+    auto isochrone_common = prepare_isochrone_common(raptor, center, departure_datetime, max_duration, clockwise,
+                                                     worker, pb_creator, stop_points);
+    if (isochrone_common) {
+        raptor.isochrone(isochrone_common->departures, isochrone_common->init_dt, isochrone_common->bound,
+                         max_transfers, accessibilite_params, forbidden, allowed, clockwise, rt_level);
+    }
+    return isochrone_common;
+}
+
 void make_isochrone(navitia::PbCreator& pb_creator,
                     RAPTOR& raptor,
                     const type::EntryPoint& center,
@@ -1751,19 +1794,38 @@ void make_graphical_isochrone(navitia::PbCreator& pb_creator,
                               const nt::RTLevel rt_level,
                               georef::StreetNetwork& worker,
                               const double& speed,
-                              const boost::optional<const type::EntryPoints&>& stop_points) {
-    const auto isochrone_common = make_isochrone_common(raptor, center, departure_datetime, boundary_duration[0],
-                                                        max_transfers, accessibilite_params, forbidden, allowed,
-                                                        clockwise, rt_level, worker, pb_creator, stop_points);
+                              const boost::optional<const type::EntryPoints&>& stop_points,
+                              IsochroneCache* cache) {
+    const auto isochrone_common = prepare_isochrone_common(raptor, center, departure_datetime, boundary_duration[0],
+                                                           clockwise, worker, pb_creator, stop_points);
 
     if (!isochrone_common) {
         return;
     }
 
-    std::vector<Isochrone> isochrone =
-        build_isochrones(raptor, isochrone_common->clockwise, isochrone_common->coord_origin,
-                         isochrone_common->departures, speed, boundary_duration, isochrone_common->init_dt);
-    for (const auto& iso : isochrone) {
+    const IsochroneCacheKey key{isochrone_common->departures,
+                                isochrone_common->coord_origin,
+                                isochrone_common->init_dt,
+                                boundary_duration,
+                                max_transfers,
+                                accessibilite_params,
+                                forbidden,
+                                allowed,
+                                clockwise,
+                                rt_level,
+                                speed};
+    IsochroneCache::Isochrones isochrone = cache ? cache->find(key) : nullptr;
+    if (!isochrone) {
+        raptor.isochrone(isochrone_common->departures, isochrone_common->init_dt, isochrone_common->bound,
+                         max_transfers, accessibilite_params, forbidden, allowed, clockwise, rt_level);
+        isochrone = std::make_shared<const std::vector<Isochrone>>(
+            build_isochrones(raptor, isochrone_common->clockwise, isochrone_common->coord_origin,
+                             isochrone_common->departures, speed, boundary_duration, isochrone_common->init_dt));
+        if (cache) {
+            cache->insert(key, isochrone);
+        }
+    }
+    for (const auto& iso : *isochrone) {
         auto min_date_time = make_isochrone_date(isochrone_common->init_dt, iso.min_duration, clockwise);
         auto max_date_time = make_isochrone_date(isochrone_common->init_dt, iso.max_duration, clockwise);
         add_graphical_isochrone(iso.shape, iso.min_duration, iso.max_duration, pb_creator, center, clockwise,
@@ -56,6 +56,7 @@ namespace navitia {
 namespace routing {
 
 struct RAPTOR;
+class IsochroneCache;
 
 struct NightBusFilter {
     static constexpr double default_max_factor = 3;
@@ -238,7 +239,8 @@ void make_graphical_isochrone(navitia::PbCreator& pb_creator,
                               const nt::RTLevel rt_level,
                               georef::StreetNetwork& worker,
                               const double& speed,
-                              const boost::optional<const type::EntryPoints&>& stop_points = boost::none);
+                              const boost::optional<const type::EntryPoints&>& stop_points = boost::none,
+                              IsochroneCache* cache = nullptr);
 
 void make_heat_map(navitia::PbCreator& pb_creator,
                    RAPTOR& raptor,
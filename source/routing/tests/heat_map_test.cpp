@@ -43,6 +43,7 @@ www.navitia.io
 #include "utils/logger.h"
 
 #include <boost/test/unit_test.hpp>
+#include <cstring>
 #include <iomanip>
 #include <vector>
 #include <boost/geometry.hpp>
@@ -66,20 +67,20 @@ BOOST_AUTO_TEST_CASE(print_map_test) {
      *
      */
     std::vector<SingleCoord> header;
-    std::vector<std::pair<SingleCoord, std::vector<navitia::time_duration>>> body;
+    std::vector<std::pair<SingleCoord, std::vector<uint32_t>>> body;
     int length = 3;
     for (int i = 0; i < length; i++) {
         header.push_back((SingleCoord(i + length + 1, 1)));
-        std::vector<navitia::time_duration> local_duration;
+        std::vector<uint32_t> local_duration;
         auto lon = SingleCoord(i, 1);
         for (int j = 0; j < length; j++) {
-            local_duration.push_back(navitia::minutes(j + i * length));
+            local_duration.push_back(60 * (j + i * length));
         }
         auto local_body = std::make_pair(lon, local_duration);
         body.push_back(std::move(local_body));
     }
     auto heat_map = HeatMap(header, body);
-    heat_map.body[2].second[2] = bt::pos_infin;
+    heat_map.body[2].second[2] = HeatMap::UNREACHED;
     const auto heat_map_string = R"({"line_headers":[{"cell_lat":{"min_lat":4,"center_lat":4.5,"max_lat":5}},)"
                                  R"({"cell_lat":{"min_lat":5,"center_lat":5.5,"max_lat":6}},)"
                                  R"({"cell_lat":{"min_lat":6,"center_lat":6.5,"max_lat":7}}],)"
@@ -92,6 +93,42 @@ BOOST_AUTO_TEST_CASE(print_map_test) {
     BOOST_CHECK(heat_map_string == print_grid(heat_map));
 }
 
+BOOST_AUTO_TEST_CASE(print_binary_map_test) {
+    std::vector<SingleCoord> header = {SingleCoord(4, 0.5), SingleCoord(4.5, 0.5)};
+    std::vector<std::pair<SingleCoord, std::vector<uint32_t>>> body;
+    body.emplace_back(SingleCoord(1, 2), std::vector<uint32_t>{0, 300});
+    body.emplace_back(SingleCoord(3, 2), std::vector<uint32_t>{258, HeatMap::UNREACHED});
+    const auto grid = print_binary_grid(HeatMap(header, body));
+
+    BOOST_REQUIRE_EQUAL(grid.size(), size_t(2 * 4 + 4 * 8 + 4 * 4));
+    auto read_uint32 = [&](size_t offset) {
+        uint32_t value = 0;
+        for (size_t byte = 0; byte < 4; ++byte) {
+            value |= uint32_t(uint8_t(grid[offset + byte])) << (8 * byte);
+        }
+        return value;
+    };
+    auto read_double = [&](size_t offset) {
+        uint64_t bits = 0;
+        for (size_t byte = 0; byte < 8; ++byte) {
+            bits |= uint64_t(uint8_t(grid[offset + byte])) << (8 * byte);
+        }
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    };
+    BOOST_CHECK_EQUAL(read_uint32(0), 2u);
+    BOOST_CHECK_EQUAL(read_uint32(4), 2u);
+    BOOST_CHECK_EQUAL(read_double(8), 1);
+    BOOST_CHECK_EQUAL(read_double(16), 2);
+    BOOST_CHECK_EQUAL(read_double(24), 4);
+    BOOST_CHECK_EQUAL(read_double(32), 0.5);
+    BOOST_CHECK_EQUAL(read_uint32(40), 0u);
+    BOOST_CHECK_EQUAL(read_uint32(44), 300u);
+    BOOST_CHECK_EQUAL(read_uint32(48), 258u);
+    BOOST_CHECK_EQUAL(read_uint32(52), HeatMap::UNREACHED);
+}
+
 BOOST_AUTO_TEST_CASE(heat_map_test) {
     /*
      *
@@ -198,16 +235,16 @@ BOOST_AUTO_TEST_CASE(heat_map_test) {
     auto distances = init_distance(*b.data->geo_ref, stop_points, init_dt, raptor, mode, E, true, bound, speed);
     auto heat_map =
         fill_heat_map(box, height_step, width_step, *b.data->geo_ref, min_dist, max_duration, speed, distances, step);
-    std::vector<navitia::time_duration> result;
+    std::vector<uint32_t> result;
     for (size_t i = 0; i < step; i++) {
         for (size_t j = 0; j < step; j++) {
             result.push_back(heat_map.body[i].second[j]);
         }
     }
-    BOOST_CHECK_EQUAL(result[0].total_seconds(), 244);
-    BOOST_CHECK_EQUAL(result[1].total_seconds(), 207);
-    BOOST_CHECK_EQUAL(result[2].total_seconds(), 178);
+    BOOST_CHECK_EQUAL(result[0], 244u);
+    BOOST_CHECK_EQUAL(result[1], 207u);
+    BOOST_CHECK_EQUAL(result[2], 178u);
     for (size_t i = 3; i < result.size(); i++) {
-        BOOST_CHECK(result[i].is_pos_infinity());
+        BOOST_CHECK_EQUAL(result[i], HeatMap::UNREACHED);
     }
 }
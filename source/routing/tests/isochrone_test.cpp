@@ -148,6 +148,38 @@ BOOST_AUTO_TEST_CASE(build_single_ischron_test) {
 #endif
 }
 
+// the origin is not on a stop point: its walking circle is the only one around it
+BOOST_AUTO_TEST_CASE(build_single_isochrone_without_stop_point_at_origin) {
+    using coord = navitia::type::GeographicalCoord;
+    coord coord_Paris = {2.3522219000000177, 48.856614};
+    coord coord_Notre_Dame = {2.35, 48.853};
+    coord coord_Batignolles = {2.31, 48.89};
+    ed::builder b("20120614", [&](ed::builder& b) {
+        b.vj("A")("stop1", "08:00"_t)("stop2", "08:05"_t);
+        b.connection("stop1", "stop1", 120);
+        b.connection("stop2", "stop2", 120);
+        b.sps["stop1"]->coord = coord_Paris;
+        b.sps["stop2"]->coord = coord_Notre_Dame;
+    });
+    RAPTOR raptor(*b.data);
+    navitia::routing::map_stop_point_duration d;
+    raptor.isochrone(d, navitia::DateTimeUtils::set(0, "08:00"_t), navitia::DateTimeUtils::set(0, "08:10"_t));
+    const double speed = 0.8;
+    const int duration = 600;
+    navitia::type::MultiPolygon isochrone =
+        build_single_isochrone(raptor, b.data->pt_data->stop_points, true, coord_Batignolles,
+                               navitia::DateTimeUtils::set(0, "08:10"_t), d, speed, duration);
+#if BOOST_VERSION >= 105600
+    BOOST_REQUIRE_EQUAL(isochrone.size(), 1);
+    BOOST_CHECK(boost::geometry::within(circle(coord_Batignolles, duration * speed - 1), isochrone));
+    for (const double direction : {0., 90., 180., 270.}) {
+        BOOST_CHECK(!boost::geometry::within(
+            project_in_direction(coord_Batignolles, direction, duration * speed + 10), isochrone));
+    }
+    BOOST_CHECK(!boost::geometry::within(coord_Paris, isochrone));
+#endif
+}
+
 BOOST_AUTO_TEST_CASE(build_ischrons_test) {
     using coord = navitia::type::GeographicalCoord;
     coord coord_Paris = {2.3522219000000177, 48.856614};
@@ -215,3 +247,51 @@ BOOST_AUTO_TEST_CASE(build_ischrons_test) {
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30[0].shape, isochrone_8h_8h30_9h[0].shape));
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30_9h[0].shape, isochrone_8h_8h30_9h[1].shape));
 }
+
+BOOST_AUTO_TEST_CASE(isochrone_cache_test) {
+    auto make_key = [](const navitia::DateTime init_dt) {
+        return IsochroneCacheKey{{{navitia::routing::SpIdx(0), navitia::seconds(0)}},
+                                 {2.35, 48.85},
+                                 init_dt,
+                                 {3600, 1800},
+                                 10,
+                                 {},
+                                 {},
+                                 {},
+                                 true,
+                                 navitia::type::RTLevel::Base,
+                                 1.12};
+    };
+    auto make_isochrones = [](const navitia::DateTime max_duration) {
+        return std::make_shared<const std::vector<Isochrone>>(
+            std::vector<Isochrone>{Isochrone({}, 0, max_duration)});
+    };
+
+    IsochroneCache cache(2);
+    BOOST_CHECK(!cache.find(make_key(100)));
+    cache.insert(make_key(100), make_isochrones(100));
+    cache.insert(make_key(200), make_isochrones(200));
+    BOOST_REQUIRE(cache.find(make_key(100)));
+    BOOST_CHECK_EQUAL(cache.find(make_key(100))->front().max_duration, 100u);
+
+    // 200 is the least recently used
+    cache.insert(make_key(300), make_isochrones(300));
+    BOOST_CHECK_EQUAL(cache.size(), 2u);
+    BOOST_CHECK(cache.find(make_key(100)));
+    BOOST_CHECK(!cache.find(make_key(200)));
+    BOOST_CHECK(cache.find(make_key(300)));
+
+    auto other_key = make_key(300);
+    other_key.rt_level = navitia::type::RTLevel::RealTime;
+    BOOST_CHECK(!cache.find(other_key));
+    BOOST_CHECK_EQUAL(cache.get_nb_calls(), 7u);
+    BOOST_CHECK_EQUAL(cache.get_nb_cache_miss(), 3u);
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(cache.size(), 0u);
+    BOOST_CHECK(!cache.find(make_key(100)));
+
+    IsochroneCache disabled(0);
+    disabled.insert(make_key(100), make_isochrones(100));
+    BOOST_CHECK(!disabled.find(make_key(100)));
+}
@@ -0,0 +1,89 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_phase_profile
+
+#include "routing/phase_profile.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace navitia::routing;
+
+BOOST_AUTO_TEST_CASE(span_without_profile_does_nothing) {
+    PhaseProfile profile;
+    { PhaseSpan span(Phase::fallback); }
+    BOOST_CHECK(profile.empty());
+}
+
+BOOST_AUTO_TEST_CASE(spans_are_accumulated_by_phase) {
+    PhaseProfile profile;
+    {
+        PhaseProfileGuard guard(profile);
+        { PhaseSpan span(Phase::raptor_first_pass); }
+        { PhaseSpan span(Phase::read_solutions); }
+        { PhaseSpan span(Phase::read_solutions); }
+    }
+    // the guard is destroyed, nothing is recorded anymore
+    { PhaseSpan span(Phase::make_pathes); }
+
+    BOOST_CHECK(!profile.empty());
+    BOOST_CHECK(profile.has(Phase::raptor_first_pass));
+    BOOST_CHECK(profile.has(Phase::read_solutions));
+    BOOST_CHECK(!profile.has(Phase::make_pathes));
+    BOOST_CHECK(!profile.has(Phase::fallback));
+    BOOST_CHECK_GE(profile.seconds(Phase::read_solutions), 0.);
+
+    const auto summary = profile.summary();
+    BOOST_CHECK(summary.find("raptor_first_pass") != std::string::npos);
+    BOOST_CHECK(summary.find("read_solutions") != std::string::npos);
+    BOOST_CHECK(summary.find("(x2)") != std::string::npos);
+    BOOST_CHECK(summary.find("make_pathes") == std::string::npos);
+
+    profile.reset();
+    BOOST_CHECK(profile.empty());
+    BOOST_CHECK(!profile.has(Phase::read_solutions));
+}
+
+BOOST_AUTO_TEST_CASE(guards_can_be_nested) {
+    PhaseProfile outer, inner;
+    {
+        PhaseProfileGuard outer_guard(outer);
+        {
+            PhaseProfileGuard inner_guard(inner);
+            PhaseSpan span(Phase::direct_path);
+        }
+        PhaseSpan span(Phase::fallback);
+    }
+    BOOST_CHECK(inner.has(Phase::direct_path));
+    BOOST_CHECK(!inner.has(Phase::fallback));
+    BOOST_CHECK(outer.has(Phase::fallback));
+    BOOST_CHECK(!outer.has(Phase::direct_path));
+}
@@ -0,0 +1,199 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "ed/synthetic_network.h"
+#include "routing/next_stop_time.h"
+#include "routing/raptor.h"
+#include "routing/raptor_solution_reader.h"
+#include "routing/raptor_visitors.h"
+#include "tests/micro_benchmark.h"
+#include "utils/exception.h"
+#include "utils/init.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+/*
+ * Micro-benchmarks of the routing hot kernels on a synthetic network
+ *
+ * Usage: routing_micro_benchmark --lines 40 --stops 30 --filter foot_path
+ */
+
+namespace po = boost::program_options;
+namespace mb = navitia::micro_benchmark;
+namespace nt = navitia::type;
+using namespace navitia;
+using namespace navitia::routing;
+
+namespace {
+
+ed::SyntheticNetworkParams params;
+
+const ed::builder& get_builder() {
+    static const auto b = ed::make_synthetic_network(params);
+    return *b;
+}
+
+const nt::Data& get_data() {
+    return *get_builder().data;
+}
+
+// second day of the production period, the arg of the benchmark is the hour
+DateTime get_datetime(int64_t hour) {
+    return DateTimeUtils::set(1, uint32_t(hour) * 3600);
+}
+
+// with 'now' in the production period, raptor uses the cached next stop times
+boost::posix_time::ptime get_now() {
+    return boost::posix_time::ptime(get_data().meta->production_date.begin());
+}
+
+SpIdx get_sp_idx(const std::string& stop_area_name) {
+    return SpIdx(*get_builder().sps.at("stop_point:" + stop_area_name));
+}
+
+void bm_earliest_stop_time(mb::State& state) {
+    const auto& data = get_data();
+    const NextStopTime next_st(data);
+    const nt::VehicleProperties vehicle_props;
+    const size_t nb_jpps = data.dataRaptor->jp_container.nb_jpps();
+    const DateTime dt = get_datetime(state.arg());
+    size_t i = 0;
+    while (state.keep_running()) {
+        mb::do_not_optimize(next_st.earliest_stop_time(StopEvent::pick_up, JppIdx(i++ % nb_jpps), dt,
+                                                       nt::RTLevel::Base, vehicle_props));
+    }
+}
+NAVITIA_BENCHMARK(bm_earliest_stop_time).arg(8).arg(23);
+
+void bm_cached_next_stop_time(mb::State& state) {
+    const auto& data = get_data();
+    const nt::VehicleProperties vehicle_props;
+    const size_t nb_jpps = data.dataRaptor->jp_container.nb_jpps();
+    const DateTime dt = get_datetime(state.arg());
+    const auto next_st =
+        data.dataRaptor->cached_next_st_manager->load(dt, nt::RTLevel::Base, nt::AccessibiliteParams());
+    size_t i = 0;
+    while (state.keep_running()) {
+        mb::do_not_optimize(next_st->next_stop_time(StopEvent::pick_up, JppIdx(i++ % nb_jpps), dt, true,
+                                                    nt::RTLevel::Base, vehicle_props, true, boost::none));
+    }
+}
+NAVITIA_BENCHMARK(bm_cached_next_stop_time).arg(8).arg(23);
+
+// the arg is the percentage of the stop points reached by public transport before the foot paths
+void bm_foot_path(mb::State& state) {
+    const auto& data = get_data();
+    const nt::AccessibiliteParams accessibilite_params;
+    const DateTime dt = get_datetime(8);
+    RAPTOR raptor(data);
+    raptor.set_valid_jp_and_jpp(DateTimeUtils::date(dt), accessibilite_params, {}, {}, nt::RTLevel::Base);
+    raptor.clear(true, DateTimeUtils::inf);
+    raptor.count = 0;
+    const size_t nb_sps = data.pt_data->stop_points.size();
+    for (size_t i = 0; i < nb_sps; ++i) {
+        if (i * size_t(state.arg()) % 100 < size_t(state.arg())) {
+            raptor.labels[0][SpIdx(i)].dt_pt = dt + DateTime(i % 600);
+        }
+    }
+    const auto reached_labels = raptor.labels[0];
+    const auto best_labels = raptor.best_labels;
+    const auto queue = raptor.Q;
+
+    while (state.keep_running()) {
+        state.pause_timing();
+        raptor.labels[0] = reached_labels;
+        raptor.best_labels = best_labels;
+        raptor.Q = queue;
+        state.resume_timing();
+        mb::do_not_optimize(raptor.foot_path(raptor_visitor()));
+    }
+}
+NAVITIA_BENCHMARK(bm_foot_path).arg(10).arg(100);
+
+// read the solutions of a second pass, between the opposite corners of the network
+void bm_read_solutions(mb::State& state) {
+    const auto& data = get_data();
+    const nt::AccessibiliteParams accessibilite_params;
+    const DateTime dt = get_datetime(8);
+    const uint32_t max_transfers = 10;
+    const auto last_stop = std::to_string(params.nb_stops_by_line - 1);
+    const map_stop_point_duration departures = {{get_sp_idx("stop_area:H0:0"), 0_s}};
+    const SpIdx destination = get_sp_idx(params.nb_lines > 1 ? "stop_area:V" + std::to_string(params.nb_lines / 2 - 1)
+                                                                   + ":" + last_stop
+                                                             : "stop_area:H0:" + last_stop);
+    const map_stop_point_duration destinations = {{destination, 0_s}};
+
+    RAPTOR raptor(data);
+    raptor.set_valid_jp_and_jpp(DateTimeUtils::date(dt), accessibilite_params, {}, {}, nt::RTLevel::Base);
+    raptor.first_raptor_loop(departures, dt, nt::RTLevel::Base, DateTimeUtils::inf, max_transfers,
+                             accessibilite_params, true, get_now());
+
+    // the best arrival at the destination is the starting point of the second pass
+    boost::optional<StartingPointSndPhase> end_point;
+    for (unsigned count = 1; count <= raptor.count; ++count) {
+        const DateTime arrival = raptor.labels[count][destination].dt_pt;
+        if (is_dt_initialized(arrival) && (!end_point || arrival < end_point->end_dt)) {
+            end_point = StartingPointSndPhase{destination, count, arrival, 0, true};
+        }
+    }
+    if (!end_point) {
+        throw navitia::exception("bm_read_solutions: the destination is not reachable");
+    }
+    raptor.clear(false, dt - 1);
+    raptor.init(destinations, end_point->end_dt, false, accessibilite_params.properties);
+    raptor.boucleRAPTOR(accessibilite_params, false, nt::RTLevel::Base, max_transfers);
+
+    const auto dominator = Dominates(true, 0_s, 0_s);
+    while (state.keep_running()) {
+        auto solutions = Solutions(dominator);
+        read_solutions(raptor, solutions, false, dt, departures, destinations, nt::RTLevel::Base,
+                       accessibilite_params, 0_s, *end_point);
+        mb::do_not_optimize(solutions.size());
+    }
+}
+NAVITIA_BENCHMARK(bm_read_solutions);
+
+}  // namespace
+
+int main(int argc, const char* argv[]) {
+    navitia::init_app();
+    params.nb_lines = 40;
+    params.nb_stops_by_line = 30;
+    po::options_description options("Synthetic network");
+    // clang-format off
+    options.add_options()
+        ("lines", po::value<size_t>(&params.nb_lines)->default_value(params.nb_lines), "Number of lines")
+        ("stops", po::value<size_t>(&params.nb_stops_by_line)->default_value(params.nb_stops_by_line),
+            "Number of stops by line")
+        ("headway", po::value<uint32_t>(&params.headway)->default_value(params.headway),
+            "Time between two vehicles of a line, in seconds");
+    // clang-format on
+    return mb::run_benchmarks(argc, argv, options);
+}
@@ -0,0 +1,259 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/preprocessor/cat.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <regex>
+#include <string>
+#include <vector>
+
+/** Minimal micro-benchmark harness, in the spirit of google-benchmark
+ *
+ * A benchmark is a function taking a State and looping on keep_running(),
+ * only the body of the loop is timed:
+ *
+ *  static void bm_something(navitia::micro_benchmark::State& state) {
+ *      auto input = make_input(state.arg());
+ *      while (state.keep_running()) {
+ *          navitia::micro_benchmark::do_not_optimize(something(input));
+ *      }
+ *  }
+ *  NAVITIA_BENCHMARK(bm_something).arg(10).arg(1000);
+ *
+ * The number of iterations is calibrated to last at least --min_time, then the
+ * measure is repeated --repetitions times and the median time by iteration is
+ * reported with the coefficient of variation, to be able to see small gains.
+ */
+namespace navitia {
+namespace micro_benchmark {
+
+class State {
+public:
+    using clock = std::chrono::steady_clock;
+
+    State(size_t max_iterations, int64_t arg) : max_iterations(max_iterations), argument(arg) {}
+
+    bool keep_running() {
+        if (nb_iterations == 0 && !running) {
+            resume_timing();
+        }
+        if (nb_iterations < max_iterations) {
+            ++nb_iterations;
+            return true;
+        }
+        pause_timing();
+        return false;
+    }
+
+    // exclude from the measure the preparation done inside the loop
+    void pause_timing() {
+        if (running) {
+            elapsed += clock::now() - start;
+            running = false;
+        }
+    }
+    void resume_timing() {
+        if (!running) {
+            start = clock::now();
+            running = true;
+        }
+    }
+
+    int64_t arg() const { return argument; }
+    size_t iterations() const { return nb_iterations; }
+    double elapsed_seconds() const { return std::chrono::duration<double>(elapsed).count(); }
+
+private:
+    size_t max_iterations;
+    int64_t argument;
+    size_t nb_iterations = 0;
+    bool running = false;
+    clock::time_point start;
+    clock::duration elapsed = clock::duration::zero();
+};
+
+// prevent the compiler from optimizing away a computed value
+template <typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Benchmark {
+    std::string name;
+    std::function<void(State&)> function;
+    std::vector<int64_t> args;
+
+    Benchmark& arg(int64_t a) {
+        args.push_back(a);
+        return *this;
+    }
+};
+
+// a list as the registered benchmarks are referenced
+inline std::list<Benchmark>& registry() {
+    static std::list<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+inline Benchmark& register_benchmark(const std::string& name, std::function<void(State&)> function) {
+    registry().push_back({name, std::move(function), {}});
+    return registry().back();
+}
+
+#define NAVITIA_BENCHMARK(function)                                                             \
+    static ::navitia::micro_benchmark::Benchmark& BOOST_PP_CAT(navitia_benchmark_, __LINE__) = \
+        ::navitia::micro_benchmark::register_benchmark(#function, function)
+
+struct Measure {
+    std::string name;
+    int64_t arg = 0;
+    size_t iterations = 0;
+    double median_ns = 0;
+    double min_ns = 0;
+    double cv = 0;  // coefficient of variation of the repetitions, in percent
+};
+
+inline double run_once(const Benchmark& benchmark, int64_t arg, size_t iterations) {
+    State state(iterations, arg);
+    benchmark.function(state);
+    return state.elapsed_seconds();
+}
+
+inline Measure measure(const Benchmark& benchmark, int64_t arg, double min_time, size_t repetitions) {
+    // like google-benchmark, grow the number of iterations until a run lasts long enough
+    size_t iterations = 1;
+    constexpr size_t max_iterations = 1000000000;
+    for (;;) {
+        const double elapsed = run_once(benchmark, arg, iterations);
+        if (elapsed >= min_time || iterations >= max_iterations) {
+            break;
+        }
+        const double factor = elapsed > 0 ? 1.4 * min_time / elapsed : 10.;
+        iterations = std::min(max_iterations, std::max(iterations + 1, size_t(iterations * std::min(factor, 10.))));
+    }
+
+    std::vector<double> ns_by_iteration;
+    for (size_t i = 0; i < std::max<size_t>(repetitions, 1); ++i) {
+        ns_by_iteration.push_back(run_once(benchmark, arg, iterations) * 1e9 / iterations);
+    }
+    std::sort(ns_by_iteration.begin(), ns_by_iteration.end());
+
+    Measure m;
+    m.name = benchmark.name;
+    m.arg = arg;
+    m.iterations = iterations;
+    m.median_ns = ns_by_iteration[ns_by_iteration.size() / 2];
+    m.min_ns = ns_by_iteration.front();
+    double mean = 0, variance = 0;
+    for (double ns : ns_by_iteration) {
+        mean += ns;
+    }
+    mean /= ns_by_iteration.size();
+    for (double ns : ns_by_iteration) {
+        variance += (ns - mean) * (ns - mean);
+    }
+    variance /= ns_by_iteration.size();
+    m.cv = mean > 0 ? 100. * std::sqrt(variance) / mean : 0.;
+    return m;
+}
+
+/**
+ * Run all the registered benchmarks matching --filter
+ *
+ * 'options' are the options specific to the benchmark executable (size of the
+ * generated data for example), they are notified before running anything.
+ */
+inline int run_benchmarks(int argc, const char* const argv[], boost::program_options::options_description options) {
+    namespace po = boost::program_options;
+    std::string filter, csv;
+    double min_time;
+    size_t repetitions;
+
+    // clang-format off
+    options.add_options()
+        ("help,h", "Show this message")
+        ("filter,f", po::value<std::string>(&filter)->default_value(".*"), "Regex on the benchmarks to run")
+        ("min_time", po::value<double>(&min_time)->default_value(0.5), "Minimal duration of a measure, in seconds")
+        ("repetitions,r", po::value<size_t>(&repetitions)->default_value(5), "Number of measures of each benchmark")
+        ("csv", po::value<std::string>(&csv), "Also write the results in this csv file");
+    // clang-format on
+
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, options), vm);
+    if (vm.count("help")) {
+        std::cout << options << std::endl;
+        return 1;
+    }
+    po::notify(vm);
+
+    const std::regex filter_regex(filter);
+    std::vector<Measure> measures;
+    std::cout << std::left << std::setw(50) << "benchmark" << std::right << std::setw(14) << "iterations"
+              << std::setw(14) << "median(ns)" << std::setw(14) << "min(ns)" << std::setw(10) << "cv(%)" << std::endl;
+    for (const auto& benchmark : registry()) {
+        if (!std::regex_search(benchmark.name, filter_regex)) {
+            continue;
+        }
+        const auto args = benchmark.args.empty() ? std::vector<int64_t>{0} : benchmark.args;
+        for (const auto arg : args) {
+            auto m = measure(benchmark, arg, min_time, repetitions);
+            const auto name = benchmark.args.empty() ? m.name : m.name + "/" + std::to_string(arg);
+            std::cout << std::left << std::setw(50) << name << std::right << std::setw(14) << m.iterations
+                      << std::setw(14) << std::fixed << std::setprecision(1) << m.median_ns << std::setw(14)
+                      << m.min_ns << std::setw(10) << std::setprecision(2) << m.cv << std::endl;
+            measures.push_back(std::move(m));
+        }
+    }
+
+    if (!csv.empty()) {
+        std::ofstream out(csv);
+        out << "benchmark,arg,iterations,median_ns,min_ns,cv_percent" << std::endl;
+        for (const auto& m : measures) {
+            out << m.name << "," << m.arg << "," << m.iterations << "," << m.median_ns << "," << m.min_ns << ","
+                << m.cv << std::endl;
+        }
+    }
+    return 0;
+}
+
+}  // namespace micro_benchmark
+}  // namespace navitia
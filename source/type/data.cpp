@@ -73,7 +73,7 @@ namespace pt = boost::posix_time;
 namespace navitia {
 namespace type {
 
-const unsigned int Data::data_version = 15;  //< *INCREMENT* every time serialized data are modified
+const unsigned int Data::data_version = 17;  //< *INCREMENT* every time serialized data are modified
 
 Data::Data(size_t data_identifier)
     : _last_rt_data_loaded(boost::posix_time::not_a_date_time),
@@ -84,8 +84,8 @@ Data::Data(size_t data_identifier)
       geo_ref(std::make_unique<navitia::georef::GeoRef>()),
       dataRaptor(std::make_unique<navitia::routing::dataRAPTOR>()),
       fare(std::make_unique<navitia::fare::Fare>()),
-      find_admins([&](const GeographicalCoord& c, georef::AdminRtree& admin_tree) {
-          return geo_ref->find_admins(c, admin_tree);
+      find_admins([&](const GeographicalCoord& c, georef::AdminIndex& admin_index) {
+          return geo_ref->find_admins(c, admin_index);
       }),
       last_load_succeeded(false) {
     loaded = false;
@@ -215,6 +215,7 @@ void Data::build_raptor(size_t cache_size) {
 
 void Data::warmup(const Data& other) {
     this->dataRaptor->warmup(*other.dataRaptor);
+    this->geo_ref->warmup(*other.geo_ref);
 }
 
 void Data::save(const std::string& filename) const {
@@ -273,15 +274,28 @@ void Data::build_uri() {
     geo_ref->build_admin_map();
 }
 
-void Data::build_proximity_list() {
+void Data::build_proximity_list(const Data* previous) {
     this->pt_data->build_proximity_list();
-    this->geo_ref->build_proximity_list();
-    this->geo_ref->project_stop_points_and_access_points(this->pt_data->stop_points);
+    this->geo_ref->build_proximity_list(previous ? previous->geo_ref.get() : nullptr);
+    this->geo_ref->project_stop_points_and_access_points(this->pt_data->stop_points,
+                                                         previous ? previous->geo_ref.get() : nullptr);
+}
+
+void Data::build_contraction_hierarchies(const std::vector<Mode_e>& modes) {
+    this->geo_ref->build_contraction_hierarchies(modes);
+}
+
+void Data::build_stop_point_walking_table(const navitia::time_duration& radius, const Data* previous) {
+    if (radius <= navitia::seconds(0)) {
+        return;
+    }
+    this->geo_ref->build_stop_point_walking_table(
+        radius, previous ? previous->geo_ref->stop_point_walking_table.get() : nullptr);
 }
 
 void Data::build_administrative_regions() {
     auto log = log4cplus::Logger::getInstance("ed::Data");
-    georef::AdminRtree admin_tree = georef::build_admins_tree(geo_ref->admins);
+    geo_ref->admin_index.build(geo_ref->admins);
 
     // set admins to stop points
     int cpt_no_projected = 0;
@@ -289,7 +303,7 @@ void Data::build_administrative_regions() {
         if (!stop_point->admin_list.empty()) {
             continue;
         }
-        const auto& admins = find_admins(stop_point->coord, admin_tree);
+        const auto& admins = find_admins(stop_point->coord, geo_ref->admin_index);
         boost::push_back(stop_point->admin_list, admins);
         if (admins.empty()) {
             ++cpt_no_projected;
@@ -310,7 +324,7 @@ void Data::build_administrative_regions() {
         if (!poi->admin_list.empty()) {
             continue;
         }
-        const auto& admins = find_admins(poi->coord, admin_tree);
+        const auto& admins = find_admins(poi->coord, geo_ref->admin_index);
         boost::push_back(poi->admin_list, admins);
         if (admins.empty()) {
             ++cpt_no_projected;
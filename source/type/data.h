@@ -35,6 +35,7 @@ www.navitia.io
 #include "utils/obj_factory.h"
 #include "utils/ptime.h"
 #include "type/fwd_type.h"
+#include "type/time_duration.h"
 
 #include <boost/serialization/split_member.hpp>
 #include <boost/utility.hpp>
@@ -139,7 +140,7 @@ public:
     std::unique_ptr<navitia::fare::Fare> fare;
 
     // functor to find admins
-    std::function<std::vector<georef::Admin*>(const GeographicalCoord&, georef::AdminRtree&)> find_admins;
+    std::function<std::vector<georef::Admin*>(const GeographicalCoord&, georef::AdminIndex&)> find_admins;
 
     /** Return the vector containing all the objects of type T*/
     template <typename T>
@@ -219,8 +220,19 @@ public:
     void build_autocomplete();
     void build_autocomplete_partial();
 
-    /** Build ProximityList index */
-    void build_proximity_list();
+    /** Build ProximityList index
+     *
+     * previous is the data this one has been cloned from, with the same street network: its compact street
+     * graph is copied and the stop points are projected again, reusing the projections that have not changed
+     */
+    void build_proximity_list(const Data* previous = nullptr);
+    /** Build the contraction hierarchies of the street network for the direct paths */
+    void build_contraction_hierarchies(const std::vector<Mode_e>& modes);
+    /**
+     * Build the walking durations to the stop points for the fallbacks, nothing is built for a null radius
+     * previous is the data this one has been cloned from: only the stop points added or moved are computed again
+     */
+    void build_stop_point_walking_table(const navitia::time_duration& radius, const Data* previous = nullptr);
     /** Set admins*/
     void build_administrative_regions();
 
@@ -31,8 +31,6 @@ www.navitia.io
 
 // forward declare
 //
-template <class DATATYPE, class ELEMTYPE, int NUMDIMS, class ELEMTYPEREAL, int TMAXNODES, int TMINNODES>
-class RTree;
 namespace navitia {
 template <typename T>
 struct Rank;
@@ -43,7 +41,7 @@ struct POI;
 struct POIType;
 struct Admin;
 struct Address;
-using AdminRtree = class RTree<Admin*, double, 2, double, 8, 4>;
+class AdminIndex;
 }  // namespace georef
 namespace fare {
 struct Fare;
@@ -0,0 +1,75 @@
+/* Copyright © 2001-2022, Hove and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Hove (www.hove.com).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+channel `#navitia` on riot https://riot.im/app/#/room/#navitia:matrix.org
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace navitia {
+
+/**
+ * Call f(begin, end) on the chunks of chunk_size items of [0, nb_items), on at most max_workers threads
+ *
+ * The calling thread works with the others, they all take the chunks in turn, so small chunks
+ * balance the uneven ones. The threads are capped by the hardware threads, and by max_workers
+ * when it is not 0: a caller already running among other workers should keep it small.
+ * The exception of a worker, if any, is rethrown once the chunks are done.
+ */
+template <typename F>
+void parallel_for_chunks(const size_t nb_items, const size_t chunk_size, const size_t max_workers, const F& f) {
+    const size_t nb_chunks = (nb_items + chunk_size - 1) / chunk_size;
+    size_t nb_workers = std::max(std::thread::hardware_concurrency(), 1u);
+    if (max_workers != 0) {
+        nb_workers = std::min(nb_workers, max_workers);
+    }
+    nb_workers = std::min(nb_workers, nb_chunks);
+
+    std::atomic<size_t> next_chunk{0};
+    auto run_chunks = [&]() {
+        for (size_t chunk = next_chunk++; chunk < nb_chunks; chunk = next_chunk++) {
+            f(chunk * chunk_size, std::min(nb_items, (chunk + 1) * chunk_size));
+        }
+    };
+    std::vector<std::future<void>> workers;
+    for (size_t w = 1; w < nb_workers; ++w) {
+        workers.push_back(std::async(std::launch::async, run_chunks));
+    }
+    run_chunks();
+    for (auto& worker : workers) {
+        // rethrows the exception of the worker, if any
+        worker.get();
+    }
+}
+
+}  // namespace navitia
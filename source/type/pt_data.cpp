@@ -44,10 +44,13 @@ www.navitia.io
 #include "type/multi_polygon_map.h"
 #include "type/commercial_mode.h"
 #include "type/physical_mode.h"
+#include "type/parallel.h"
 #include "utils/functions.h"
 
 #include <boost/range/algorithm/find_if.hpp>
 
+#include <functional>
+
 namespace nt = navitia::type;
 
 namespace navitia {
@@ -286,98 +289,125 @@ void PT_Data::sort_and_index() {
 }
 
 void PT_Data::build_autocomplete(const navitia::georef::GeoRef& georef) {
-    this->stop_area_autocomplete.clear();
-    for (const StopArea* sa : this->stop_areas) {
-        // Don't add it to the dictionnary if name is empty
-        if ((!sa->name.empty()) && (sa->visible)) {
-            std::string key;
-            for (navitia::georef::Admin* admin : sa->admin_list) {
-                if (admin->level == 8) {
-                    key += " " + admin->name;
+    // The indexes are built by the workers in turn: the strings of an index are listed, then only the new or
+    // changed ones are tokenized and merged into the index
+    using Strings = std::vector<std::pair<idx_t, std::string>>;
+    std::vector<std::function<void()>> builds;
+    auto update = [&](autocomplete::Autocomplete<idx_t>& index, std::function<Strings()> list_strings) {
+        builds.emplace_back([&index, list_strings, &georef]() {
+            index.update(list_strings(), georef.ghostwords, georef.synonyms);
+        });
+    };
+
+    update(this->stop_area_autocomplete, [this]() {
+        Strings strings;
+        for (const StopArea* sa : this->stop_areas) {
+            // Don't add it to the dictionnary if name is empty
+            if ((!sa->name.empty()) && (sa->visible)) {
+                std::string key;
+                for (navitia::georef::Admin* admin : sa->admin_list) {
+                    if (admin->level == 8) {
+                        key += " " + admin->name;
+                    }
                 }
+                strings.emplace_back(sa->idx, sa->name + key);
             }
-            this->stop_area_autocomplete.add_string(sa->name + key, sa->idx, georef.ghostwords, georef.synonyms);
         }
-    }
-    this->stop_area_autocomplete.build();
-
-    this->stop_point_autocomplete.clear();
-    for (const StopPoint* sp : this->stop_points) {
-        // Don't add it to the dictionnary if name is empty
-        if ((!sp->name.empty()) && ((sp->stop_area == nullptr) || (sp->stop_area->visible))) {
-            std::string key;
-            for (navitia::georef::Admin* admin : sp->admin_list) {
-                if (admin->level == 8) {
-                    key += key + " " + admin->name;
+        return strings;
+    });
+
+    update(this->stop_point_autocomplete, [this]() {
+        Strings strings;
+        for (const StopPoint* sp : this->stop_points) {
+            // Don't add it to the dictionnary if name is empty
+            if ((!sp->name.empty()) && ((sp->stop_area == nullptr) || (sp->stop_area->visible))) {
+                std::string key;
+                for (navitia::georef::Admin* admin : sp->admin_list) {
+                    if (admin->level == 8) {
+                        key += key + " " + admin->name;
+                    }
                 }
+                strings.emplace_back(sp->idx, sp->name + key);
             }
-            this->stop_point_autocomplete.add_string(sp->name + key, sp->idx, georef.ghostwords, georef.synonyms);
         }
-    }
-    this->stop_point_autocomplete.build();
-
-    this->line_autocomplete.clear();
-    for (const Line* line : this->lines) {
-        if (!line->name.empty()) {
-            std::string key;
-            key = line->code;
-            if (line->network) {
-                if (!key.empty()) {
-                    key += " ";
+        return strings;
+    });
+
+    update(this->line_autocomplete, [this]() {
+        Strings strings;
+        for (const Line* line : this->lines) {
+            if (!line->name.empty()) {
+                std::string key;
+                key = line->code;
+                if (line->network) {
+                    if (!key.empty()) {
+                        key += " ";
+                    }
+                    key += line->network->name;
                 }
-                key += line->network->name;
-            }
-            if (line->commercial_mode) {
-                if (!key.empty()) {
-                    key += " ";
+                if (line->commercial_mode) {
+                    if (!key.empty()) {
+                        key += " ";
+                    }
+                    key += line->commercial_mode->name;
                 }
-                key += line->commercial_mode->name;
+                strings.emplace_back(line->idx, key + " " + line->name);
             }
-            this->line_autocomplete.add_string(key + " " + line->name, line->idx, georef.ghostwords, georef.synonyms);
         }
-    }
-    this->line_autocomplete.build();
-
-    this->network_autocomplete.clear();
-    for (const Network* network : this->networks) {
-        if (!network->name.empty()) {
-            this->network_autocomplete.add_string(network->name, network->idx, georef.ghostwords, georef.synonyms);
+        return strings;
+    });
+
+    update(this->network_autocomplete, [this]() {
+        Strings strings;
+        for (const Network* network : this->networks) {
+            if (!network->name.empty()) {
+                strings.emplace_back(network->idx, network->name);
+            }
         }
-    }
-    this->network_autocomplete.build();
-
-    this->mode_autocomplete.clear();
-    for (const CommercialMode* mode : this->commercial_modes) {
-        if (!mode->name.empty()) {
-            this->mode_autocomplete.add_string(mode->name, mode->idx, georef.ghostwords, georef.synonyms);
+        return strings;
+    });
+
+    update(this->mode_autocomplete, [this]() {
+        Strings strings;
+        for (const CommercialMode* mode : this->commercial_modes) {
+            if (!mode->name.empty()) {
+                strings.emplace_back(mode->idx, mode->name);
+            }
         }
-    }
-    this->mode_autocomplete.build();
-
-    this->route_autocomplete.clear();
-    for (const Route* route : this->routes) {
-        if (!route->name.empty()) {
-            std::string key;
-            if (route->line) {
-                if (route->line->network) {
-                    key = route->line->network->name;
-                }
-                if (route->line->commercial_mode) {
+        return strings;
+    });
+
+    update(this->route_autocomplete, [this]() {
+        Strings strings;
+        for (const Route* route : this->routes) {
+            if (!route->name.empty()) {
+                std::string key;
+                if (route->line) {
+                    if (route->line->network) {
+                        key = route->line->network->name;
+                    }
+                    if (route->line->commercial_mode) {
+                        if (!key.empty()) {
+                            key += " ";
+                        }
+                        key += route->line->commercial_mode->name;
+                    }
                     if (!key.empty()) {
                         key += " ";
                     }
-                    key += route->line->commercial_mode->name;
-                }
-                if (!key.empty()) {
-                    key += " ";
+                    key += route->line->code;
                 }
-                key += route->line->code;
+                strings.emplace_back(route->idx, key + " " + route->name);
             }
-            this->route_autocomplete.add_string(key + " " + route->name, route->idx, georef.ghostwords,
-                                                georef.synonyms);
         }
-    }
-    this->route_autocomplete.build();
+        return strings;
+    });
+
+    parallel_for_chunks(builds.size(), 1, 0, [&](const size_t begin, const size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            builds[i]();
+        }
+    });
 }
 
 void PT_Data::compute_score_autocomplete(navitia::georef::GeoRef& georef) {